@@ -0,0 +1,91 @@
+// File:		Benchmark.h
+// Language:	C++17
+// Purpose:		Timing and reporting shared by the micro-benchmarks.
+// License:		At bottom of document.
+
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+// STL
+#include <algorithm>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+// Internal
+#include "Timer.h"
+
+
+// Runs f a number of times and returns the fastest run in nanoseconds. The
+// fastest run is the one least disturbed by the rest of the system.
+template <typename Function>
+int64_t fastest_run(Function&& f, int runs = 7) {
+	int64_t best = INT64_MAX;
+	for (int i = 0; i < runs; ++i) {
+		Timer t{};
+		t.start();
+		f();
+		t.stop();
+		best = std::min(best, t.duration());
+	}
+	return best;
+}
+
+
+// Prints the throughput of a run over bytes of input holding items.
+inline void print_result(const std::string& name, int64_t nanoseconds, size_t bytes, size_t items) {
+	double seconds = static_cast<double>(nanoseconds) / 1'000'000'000;
+	std::cout << std::left << std::setw(24) << name << std::right << std::fixed << std::setprecision(1)
+		<< std::setw(10) << static_cast<double>(bytes) / (1024 * 1024) / seconds << " MB/s"
+		<< std::setprecision(2) << std::setw(10) << static_cast<double>(nanoseconds) / items << " ns/item\n";
+}
+
+#endif
+
+
+/******************************************************************************
+
+This software is provided under two licenses. Choose whichever you prefer.
+
+
+============================= Apache License V2.0 =============================
+
+Copyright 2020 Matthew Roever
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+	http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+
+================================= MIT License =================================
+
+Copyright (c) 2020 Matthew Roever
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+******************************************************************************/
\ No newline at end of file
@@ -0,0 +1,191 @@
+// File:		Keyword_Benchmark.cpp
+// Language:	C++17
+// Purpose:		Measures keyword recognition against the keyword map it replaced.
+// License:		At bottom of document.
+
+// STL
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+// Internal
+#include "Benchmark.h"
+#include "Scanner_Support.h"
+
+
+/**************************************************************************
+*
+*	Keyword map the perfect hash replaced, kept as the baseline
+*
+*************************************************************************/
+
+// Defines a keyword for word comparison.
+struct Map_Keyword {
+	std::string text{};
+	Keyword_Type type;
+};
+
+
+// Creates the set of all supported keywords as the scanner used to, keyed
+// by the hash of their text.
+static std::map<uint32_t, Map_Keyword> build_keywords() {
+	std::map<uint32_t, Map_Keyword> keywords{};
+	for (const Keyword_Spelling& k : keyword_spellings) {
+		keywords[hash_text(k.text)] = { k.text, k.type };
+	}
+	return keywords;
+}
+
+
+// Matches a word to the text of a lexeme. Both strings are taken by value,
+// as they were.
+static bool match_text(const std::string txt, Lexeme l, const std::string word) {
+	// Must be the same length
+	if ((l.end - l.begin) != word.length()) {
+		return false;
+	}
+	// Match text
+	else {
+		return 0 == std::memcmp(txt.data() + l.begin, word.data(), word.length());
+	}
+}
+
+
+/**************************************************************************
+*
+*	Benchmark
+*
+*************************************************************************/
+
+// Builds lines of words separated by spaces, one in five a keyword and the
+// rest identifiers of 1 to 12 letters and digits. The words of each line
+// are added to words.
+static std::vector<std::string> word_lines(size_t count, uint32_t seed, std::vector<std::vector<Lexeme>>& words) {
+	static constexpr char letters[] = "abcdefghijklmnopqrstuvwxyz_ABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789";
+	std::mt19937 random{ seed };
+	std::vector<std::string> lines(count);
+	words.assign(count, {});
+	for (size_t i = 0; i < count; ++i) {
+		std::string& line = lines[i];
+		while (line.length() < 80) {
+			uint32_t begin = (uint32_t)line.length();
+			if (random() % 5 == 0) {
+				line += keyword_spellings[random() % std::size(keyword_spellings)].text;
+			}
+			else {
+				// Identifiers start with a letter
+				line += letters[random() % 53];
+				for (uint32_t n = random() % 12; n > 0; --n) {
+					line += letters[random() % (sizeof(letters) - 1)];
+				}
+			}
+			words[i].push_back({ begin, (uint32_t)line.length() });
+			line += ' ';
+		}
+	}
+	return lines;
+}
+
+
+int main() {
+	std::vector<std::vector<Lexeme>> words{};
+	const std::vector<std::string> lines = word_lines(50'000, 1, words);
+	size_t bytes = 0;
+	size_t wordCount = 0;
+	for (size_t i = 0; i < lines.size(); ++i) {
+		bytes += lines[i].length();
+		wordCount += words[i].size();
+	}
+
+	// Old map, hashed with the current crc32c so only the lookup differs
+	const std::map<uint32_t, Map_Keyword> keywords = build_keywords();
+	std::vector<Keyword_Type> mapTypes{};
+	mapTypes.reserve(wordCount);
+	int64_t mapTime = fastest_run([&] {
+		mapTypes.clear();
+		for (size_t i = 0; i < lines.size(); ++i) {
+			for (const Lexeme& l : words[i]) {
+				auto it = keywords.find(hash_text(lines[i], l));
+				if (it != keywords.end() && match_text(lines[i], l, it->second.text)) {
+					mapTypes.push_back(it->second.type);
+				}
+			}
+		}
+	});
+
+	// Perfect hash
+	std::vector<Keyword_Type> tableTypes{};
+	tableTypes.reserve(wordCount);
+	int64_t tableTime = fastest_run([&] {
+		tableTypes.clear();
+		for (size_t i = 0; i < lines.size(); ++i) {
+			for (const Lexeme& l : words[i]) {
+				Keyword_Type type{};
+				if (find_keyword(lines[i].data() + l.begin, l.end - l.begin, keyword_table, type)) {
+					tableTypes.push_back(type);
+				}
+			}
+		}
+	});
+
+	if (mapTypes != tableTypes) {
+		std::cout << "The keyword lookups found different keywords.\n";
+		return EXIT_FAILURE;
+	}
+	std::cout << "Keyword recognition, " << wordCount << " words, " << tableTypes.size() << " keywords\n";
+	print_result("Keyword map", mapTime, bytes, wordCount);
+	print_result("Perfect hash", tableTime, bytes, wordCount);
+	return EXIT_SUCCESS;
+}
+
+
+/******************************************************************************
+
+This software is provided under two licenses. Choose whichever you prefer.
+
+
+============================= Apache License V2.0 =============================
+
+Copyright 2020 Matthew Roever
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+	http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+
+================================= MIT License =================================
+
+Copyright (c) 2020 Matthew Roever
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+******************************************************************************/
\ No newline at end of file
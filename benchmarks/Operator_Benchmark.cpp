@@ -0,0 +1,285 @@
+// File:		Operator_Benchmark.cpp
+// Language:	C++17
+// Purpose:		Measures operator scanning against the operator tree it replaced.
+// License:		At bottom of document.
+
+// STL
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Internal
+#include "Benchmark.h"
+#include "Scanner_Support.h"
+
+
+/**************************************************************************
+*
+*	Operator tree the lexer table replaced, kept as the baseline
+*
+*************************************************************************/
+
+// Defines an operator and dependent operators.
+//
+// Fields:
+//	+ type: The operator type if a dependent operator is not found.
+//	+ symbol: The character to match on.
+//	+ ops: Dependent operators that contain this operator. Ex. += containts +.
+struct Tree_Operator {
+	Operator_Type type;
+	char symbol = '\0';
+	std::vector<Tree_Operator> ops{};
+};
+
+
+// Creates the operator hierarchy as the scanner used to.
+static std::vector<Tree_Operator> build_operator_hierarchy() {
+	return std::vector<Tree_Operator>{
+		{ Operator_Type::ACCESSOR, '.', {} },
+		{ Operator_Type::ASTERISK, '*', {
+			{ Operator_Type::MULTIPLY_EQUAL, '=', {} },
+		} },
+		{ Operator_Type::BACK_SLASH, '\\', {} },
+		{ Operator_Type::BITWISE_AND, '&', {
+			{ Operator_Type::BITWISE_AND_EQUAL, '=', {} },
+			{ Operator_Type::LOGICAL_AND, '&', {} }
+		} },
+		{ Operator_Type::BITWISE_NOT, '~', {} },
+		{ Operator_Type::BITWISE_OR, '|', {
+			{ Operator_Type::BITWISE_OR_EQUAL, '=', {} },
+			{ Operator_Type::LOGICAL_OR, '|', {} }
+		} },
+		{ Operator_Type::BITWISE_XOR, '^', {
+			{ Operator_Type::BITWISE_XOR_EQUAL, '=', {} },
+			{ Operator_Type::LOGICAL_XOR, '^', {} }
+		} },
+		{ Operator_Type::CLOSED_CURLY, '}', {} },
+		{ Operator_Type::CLOSED_PAREN, ')', {} },
+		{ Operator_Type::CLOSED_SQUARE, ']', {
+			{ Operator_Type::CLOSED_ATTRIBUTE, ']', {} }
+		} },
+		{ Operator_Type::COLON, ':', {
+			{ Operator_Type::SCOPE, ':', {} }
+		} },
+		{ Operator_Type::COMMA, ',', {} },
+		{ Operator_Type::EQUALS, '=', {
+			{ Operator_Type::EQUALS_TO, '=', {} },
+			{ Operator_Type::MATCH_CASE, '>', {} }
+		} },
+		{ Operator_Type::GREATER, '>', {
+			{ Operator_Type::GREATER_EQUAL, '=', {} },
+			{ Operator_Type::RIGHT_SHIFT, '>', {
+				{ Operator_Type::RIGHT_SHIFT_EQUAL, '=', {} }
+			} }
+		} },
+		{ Operator_Type::LESS, '<', {
+			{ Operator_Type::LESS_EQUAL, '=', {
+				{ Operator_Type::THREE_WAY_COMP, '>', {} }
+			} },
+			{ Operator_Type::LEFT_SHIFT, '<', {
+				{ Operator_Type::LEFT_SHIFT_EQUAL, '=', {} }
+			} }
+		} },
+		{ Operator_Type::LOGICAL_NOT, '!', {
+			{ Operator_Type::NOT_EQUAL, '=', {} }
+		} },
+		{ Operator_Type::MACRO, '#', {} },
+		{ Operator_Type::MINUS, '-', {
+			{ Operator_Type::ARROW, '>', {} },
+			{ Operator_Type::DECREMENT, '-', {} },
+			{ Operator_Type::MINUS_EQUAL, '=', {} }
+		} },
+		{ Operator_Type::MODULO, '%', {
+			{ Operator_Type::MODULO_EQUAL, '=', {} }
+		} },
+		{ Operator_Type::OPEN_CURLY, '{', {} },
+		{ Operator_Type::OPEN_PAREN, '(', {} },
+		{ Operator_Type::OPEN_SQUARE, '[', {
+			{ Operator_Type::OPEN_ATTRIBUTE, '[', {} }
+		} },
+		{ Operator_Type::PLUS, '+', {
+			{ Operator_Type::INCREMENT, '+', {} },
+			{ Operator_Type::PLUS_EQUAL, '=', {} }
+		} },
+		{ Operator_Type::SEMICOLON, ';', {} },
+		{ Operator_Type::TERNARY, '?', {} }
+	};
+}
+
+
+// Scans for operators by walking the tree.
+static uint32_t tree_scan_operator(const std::string& s, uint32_t index, const std::vector<Tree_Operator>& ops,
+	Operator_Type& type) {
+	for (const auto& op : ops) {
+		if (op.symbol == s[index]) {
+			type = op.type;
+			uint32_t newIndex = index + 1;
+			if (op.ops.size() && newIndex < s.length()) {
+				return tree_scan_operator(s, newIndex, op.ops, type);
+			}
+			else {
+				return newIndex;
+			}
+		}
+	}
+	return index;
+}
+
+
+/**************************************************************************
+*
+*	Benchmark
+*
+*************************************************************************/
+
+// Spellings of the operators both scanners know. Division is left out, the
+// old scanner handled / with comments.
+static std::vector<std::string_view> operator_spellings_used() {
+	std::vector<std::string_view> spellings{};
+	for (const Operator_Spelling& op : operator_spellings) {
+		std::string_view text = op.text;
+		if (text != "/" && text != "/=" && op.type != Operator_Type::UNSUPPORTED_OPERATOR) {
+			spellings.push_back(text);
+		}
+	}
+	return spellings;
+}
+
+
+// Builds lines of random operators. With spaces, one in four operators is
+// followed by a space, otherwise they are all written together.
+static std::vector<std::string> operator_lines(size_t count, bool spaces, uint32_t seed) {
+	const std::vector<std::string_view> spellings = operator_spellings_used();
+	std::mt19937 random{ seed };
+	std::vector<std::string> lines(count);
+	for (auto& line : lines) {
+		while (line.length() < 80) {
+			line += spellings[random() % spellings.size()];
+			if (spaces && random() % 4 == 0) {
+				line += ' ';
+			}
+		}
+	}
+	return lines;
+}
+
+
+// Times both scanners over the lines. Whitespace is skipped by the
+// scanner's own function in both, called only at a whitespace byte as the
+// scanner does, so only the operators differ. Returns false if the
+// scanners disagree.
+static bool compare_scanners(const std::string& name, const std::vector<std::string>& lines) {
+	size_t bytes = 0;
+	for (const auto& line : lines) {
+		bytes += line.length();
+	}
+
+	// Old tree
+	const std::vector<Tree_Operator> tree = build_operator_hierarchy();
+	std::vector<Operator_Type> treeTypes{};
+	treeTypes.reserve(bytes);
+	int64_t treeTime = fastest_run([&] {
+		treeTypes.clear();
+		for (const auto& line : lines) {
+			uint32_t i = 0;
+			while (i < line.length()) {
+				if (static_cast<uint8_t>(line[i]) <= ' ') {
+					i = scan_whitespace(line, i);
+					continue;
+				}
+				Operator_Type type = Operator_Type::UNSUPPORTED_OPERATOR;
+				i = tree_scan_operator(line, i, tree, type);
+				treeTypes.push_back(type);
+			}
+		}
+	});
+
+	// Lexer table through the scanner's lexeme function
+	Symbol_Table symbols{};
+	Constant_Pool constants{};
+	String_Pool strings{};
+	std::vector<Operator_Type> tableTypes{};
+	tableTypes.reserve(bytes);
+	int64_t tableTime = fastest_run([&] {
+		tableTypes.clear();
+		Line_State state = Line_State::NORMAL;
+		Open_Literal literal{};
+		Lexeme lex{};
+		Token tok{};
+		for (const auto& line : lines) {
+			uint32_t i = 0;
+			while (i < line.length()) {
+				if (scan_lexeme(line, i, state, literal, lex, tok, symbols, constants, strings)) {
+					tableTypes.push_back(tok.subtype.op);
+				}
+			}
+		}
+	});
+
+	if (treeTypes != tableTypes) {
+		std::cout << name << ": the scanners found different operators.\n";
+		return false;
+	}
+	std::cout << name << ", " << lines.size() << " lines, " << tableTypes.size() << " operators\n";
+	print_result("Operator tree", treeTime, bytes, treeTypes.size());
+	print_result("Lexer table", tableTime, bytes, tableTypes.size());
+	std::cout << "\n";
+	return true;
+}
+
+
+int main() {
+	bool same = compare_scanners("Packed operators", operator_lines(50'000, false, 1));
+	same &= compare_scanners("Spaced operators", operator_lines(50'000, true, 2));
+	return same ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+
+/******************************************************************************
+
+This software is provided under two licenses. Choose whichever you prefer.
+
+
+============================= Apache License V2.0 =============================
+
+Copyright 2020 Matthew Roever
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+	http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+
+================================= MIT License =================================
+
+Copyright (c) 2020 Matthew Roever
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+******************************************************************************/
\ No newline at end of file
@@ -0,0 +1,236 @@
+// File:		Artifact_Cache.cpp
+// Language:	C++17
+// Purpose:		Content addressed store for the output of compiler phases.
+// License:		At bottom of document.
+
+// Header
+#include "Artifact_Cache.h"
+
+// STL
+#include <algorithm>
+#include <random>
+#include <stdexcept>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+// Internal
+#include "Hash.h"
+#include "Lexer_Spec.h"
+
+
+// Formats a value as 16 lowercase hex digits.
+static std::string to_hex(uint64_t v) {
+	static constexpr char digits[] = "0123456789abcdef";
+	std::string s(16, '0');
+	for (int i = 15; i >= 0; --i) {
+		s[i] = digits[v & 0xF];
+		v >>= 4;
+	}
+	return s;
+}
+
+
+// Uses the store in directory, creating the directory if needed.
+Artifact_Cache::Artifact_Cache(std::filesystem::path directory, uint64_t budget) :
+	directory(std::move(directory)), budget(budget) {
+	std::error_code ec{};
+	std::filesystem::create_directories(this->directory, ec);
+}
+
+
+// Gets the name of an artifact from the hash of its source bytes, the
+// phase that produced it with the version of the phase's output format,
+// and the options that change the phase's output. COMPILER_VERSION and
+// language_fingerprint are always part of the name.
+std::string Artifact_Cache::key(uint64_t sourceHash, std::string_view phase, uint32_t phaseVersion,
+	std::string_view flags) {
+	// Text parts end with a 0 so they can not run into each other
+	std::string parts{};
+	parts.append(reinterpret_cast<const char*>(&sourceHash), sizeof(sourceHash));
+	parts.append(reinterpret_cast<const char*>(&phaseVersion), sizeof(phaseVersion));
+	parts.append(reinterpret_cast<const char*>(&language_fingerprint), sizeof(language_fingerprint));
+	parts.append(COMPILER_VERSION);
+	parts.push_back('\0');
+	parts.append(phase);
+	parts.push_back('\0');
+	parts.append(flags);
+	std::string name = to_hex(xxhash64(parts.data(), parts.size()));
+	name.push_back('.');
+	name.append(phase);
+	return name;
+}
+
+
+// Finds an artifact and counts a hit or a miss. A hit is marked as
+// recently used. Returns an empty path on a miss.
+std::filesystem::path Artifact_Cache::find(const std::string& key) {
+	std::filesystem::path path = path_of(key);
+	std::error_code ec{};
+	if (!std::filesystem::is_regular_file(path, ec)) {
+		missCount.fetch_add(1, std::memory_order_relaxed);
+		return {};
+	}
+	std::filesystem::last_write_time(path, std::filesystem::file_time_type::clock::now(), ec);
+	hitCount.fetch_add(1, std::memory_order_relaxed);
+	return path;
+}
+
+
+// Counts an artifact returned by find() that could not be used as a miss
+// instead of a hit. Storing the artifact again replaces the file.
+//
+// Error Handling:
+//	+ Never throws.
+void Artifact_Cache::reject() noexcept {
+	hitCount.fetch_sub(1, std::memory_order_relaxed);
+	missCount.fetch_add(1, std::memory_order_relaxed);
+}
+
+
+// Stores an artifact. write is given a temporary path in the store to
+// write the artifact to, which is then renamed to the artifact. Least
+// recently used artifacts are removed once the shard is over budget.
+// Returns false if the artifact could not be stored.
+//
+// Error Handling:
+//	+ I/O errors, including std::runtime_error from write, only leave the
+//	  artifact unstored. The temporary file is removed.
+bool Artifact_Cache::store(const std::string& key, const std::function<void(const std::filesystem::path&)>& write) {
+	const std::filesystem::path path = path_of(key);
+	const std::filesystem::path shard = path.parent_path();
+	std::error_code ec{};
+	std::filesystem::create_directories(shard, ec);
+
+	// The temporary name must not be shared with another thread or process
+	static std::random_device device{};
+	static const uint64_t processTag = (uint64_t(device()) << 32) | device();
+	uint64_t unique = processTag + tempCount.fetch_add(1, std::memory_order_relaxed);
+	std::filesystem::path temporary = shard / (key + "." + to_hex(unique) + ".tmp");
+	try {
+		write(temporary);
+	}
+	catch (const std::runtime_error&) {
+		std::filesystem::remove(temporary, ec);
+		return false;
+	}
+
+	// Replaces an artifact another process stored meanwhile, which has the
+	// same content
+	std::filesystem::rename(temporary, path, ec);
+	if (ec) {
+		std::filesystem::remove(temporary, ec);
+		return false;
+	}
+	storeCount.fetch_add(1, std::memory_order_relaxed);
+	evict(shard, path);
+	return true;
+}
+
+
+// Gets the path of an artifact.
+std::filesystem::path Artifact_Cache::path_of(const std::string& key) const {
+	return directory / key.substr(0, 1) / key;
+}
+
+
+// Removes the least recently used artifacts of a shard, other than keep,
+// until it is under 90% of its share of the budget. Temporary files are
+// neither counted nor removed unless they are older than STALE_TEMPORARY.
+void Artifact_Cache::evict(const std::filesystem::path& shard, const std::filesystem::path& keep) {
+	struct Entry {
+		std::filesystem::path path{};
+		uint64_t size = 0;
+		std::filesystem::file_time_type used{};
+	};
+	const uint64_t limit = budget / SHARDS;
+	std::vector<Entry> entries{};
+	uint64_t total = 0;
+	std::error_code ec{};
+	const auto stale = std::filesystem::file_time_type::clock::now() - STALE_TEMPORARY;
+	for (std::filesystem::directory_iterator it(shard, ec), end{}; !ec && it != end; it.increment(ec)) {
+		// Files removed by another process while listing are skipped
+		std::error_code fileError{};
+		Entry e{ it->path(), it->file_size(fileError), it->last_write_time(fileError) };
+		if (fileError) {
+			continue;
+		}
+
+		// Temporary files are being written by another store, unless the
+		// writer died long ago
+		if (e.path.extension() == ".tmp") {
+			if (e.used < stale) {
+				std::filesystem::remove(e.path, fileError);
+			}
+			continue;
+		}
+		total += e.size;
+		entries.push_back(std::move(e));
+	}
+	if (total <= limit) {
+		return;
+	}
+	std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) {
+		return a.used < b.used;
+	});
+	const uint64_t target = limit - limit / 10;
+	for (const Entry& e : entries) {
+		if (total <= target) {
+			break;
+		}
+		if (e.path == keep) {
+			continue;
+		}
+		if (std::filesystem::remove(e.path, ec)) {
+			evictionCount.fetch_add(1, std::memory_order_relaxed);
+			total -= e.size;
+		}
+	}
+}
+
+
+/******************************************************************************
+
+This software is provided under two licenses. Choose whichever you prefer.
+
+
+============================= Apache License V2.0 =============================
+
+Copyright 2020 Matthew Roever
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+	http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+
+================================= MIT License =================================
+
+Copyright (c) 2020 Matthew Roever
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+******************************************************************************/
\ No newline at end of file
@@ -0,0 +1,195 @@
+// File:		Artifact_Cache.h
+// Language:	C++17
+// Purpose:		Content addressed store for the output of compiler phases.
+// License:		At bottom of document.
+
+#ifndef ARTIFACT_CACHE_H
+#define ARTIFACT_CACHE_H
+
+// STL
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <string>
+#include <string_view>
+
+
+// Version of the compiler, part of every artifact key. Changes to the lexical
+// rules are covered by language_fingerprint in Lexer_Spec.h, this must be
+// raised with any other change to the output of a phase that its own format
+// version does not cover.
+constexpr char COMPILER_VERSION[] = "0.1";
+
+
+// Directory of artifacts, the output of a compiler phase for some input,
+// shared by any number of compiler processes. Artifacts are named by a hash
+// of everything their content depends on, so a name is only ever written
+// with the same content and a found artifact is always current. Artifacts
+// are written to a temporary file and renamed into place, other processes see
+// a whole artifact or none.
+//
+// The store is split into 16 shards by the first character of the name, each
+// allowed a sixteenth of the size budget. Using an artifact marks it as
+// recently used by its modification time. After a store the shard it went to
+// is trimmed to 90% of its share, least recently used artifacts first, so
+// only a small directory is listed and no shared index has to be locked. The
+// artifact just stored is kept even if it alone is over the share.
+//
+// The store is an optimisation: a directory that can not be read or written
+// only causes misses, it never fails a compile.
+class Artifact_Cache {
+public:
+	// Size budget unless another is given, 1 GB.
+	static constexpr uint64_t DEFAULT_BUDGET = uint64_t(1) << 30;
+
+
+	// Uses the store in directory, creating the directory if needed.
+	Artifact_Cache(std::filesystem::path directory, uint64_t budget = DEFAULT_BUDGET);
+
+
+	// Gets the name of an artifact from the hash of its source bytes, the
+	// phase that produced it with the version of the phase's output format,
+	// and the options that change the phase's output. COMPILER_VERSION and
+	// language_fingerprint are always part of the name.
+	static std::string key(uint64_t sourceHash, std::string_view phase, uint32_t phaseVersion,
+		std::string_view flags);
+
+
+	// Finds an artifact and counts a hit or a miss. A hit is marked as
+	// recently used. Returns an empty path on a miss.
+	std::filesystem::path find(const std::string& key);
+
+
+	// Counts an artifact returned by find() that could not be used as a miss
+	// instead of a hit. Storing the artifact again replaces the file.
+	//
+	// Error Handling:
+	//	+ Never throws.
+	void reject() noexcept;
+
+
+	// Stores an artifact. write is given a temporary path in the store to
+	// write the artifact to, which is then renamed to the artifact. Least
+	// recently used artifacts are removed once the shard is over budget.
+	// Returns false if the artifact could not be stored.
+	//
+	// Error Handling:
+	//	+ I/O errors, including std::runtime_error from write, only leave the
+	//	  artifact unstored. The temporary file is removed.
+	bool store(const std::string& key, const std::function<void(const std::filesystem::path&)>& write);
+
+
+	// Gets the number of artifacts found by this process.
+	//
+	// Error Handling:
+	//	+ Never throws.
+	uint64_t hits() const noexcept {
+		return hitCount.load(std::memory_order_relaxed);
+	}
+
+
+	// Gets the number of artifacts this process looked for but did not find.
+	//
+	// Error Handling:
+	//	+ Never throws.
+	uint64_t misses() const noexcept {
+		return missCount.load(std::memory_order_relaxed);
+	}
+
+
+	// Gets the number of artifacts stored by this process.
+	//
+	// Error Handling:
+	//	+ Never throws.
+	uint64_t stores() const noexcept {
+		return storeCount.load(std::memory_order_relaxed);
+	}
+
+
+	// Gets the number of artifacts removed by this process to stay in budget.
+	//
+	// Error Handling:
+	//	+ Never throws.
+	uint64_t evictions() const noexcept {
+		return evictionCount.load(std::memory_order_relaxed);
+	}
+
+private:
+	// Number of shards, one per leading hex digit of a name.
+	static constexpr uint32_t SHARDS = 16;
+
+
+	// Age after which a temporary file is taken to be left by a writer that
+	// died, rather than one still being written.
+	static constexpr std::chrono::hours STALE_TEMPORARY{ 1 };
+
+
+	// Gets the path of an artifact.
+	std::filesystem::path path_of(const std::string& key) const;
+
+
+	// Removes the least recently used artifacts of a shard, other than keep,
+	// until it is under 90% of its share of the budget. Temporary files are
+	// neither counted nor removed unless they are older than STALE_TEMPORARY.
+	void evict(const std::filesystem::path& shard, const std::filesystem::path& keep);
+
+
+	std::filesystem::path directory{};
+	uint64_t budget = DEFAULT_BUDGET;
+	std::atomic<uint64_t> hitCount{ 0 };
+	std::atomic<uint64_t> missCount{ 0 };
+	std::atomic<uint64_t> storeCount{ 0 };
+	std::atomic<uint64_t> evictionCount{ 0 };
+	std::atomic<uint64_t> tempCount{ 0 };
+};
+
+#endif
+
+
+/******************************************************************************
+
+This software is provided under two licenses. Choose whichever you prefer.
+
+
+============================= Apache License V2.0 =============================
+
+Copyright 2020 Matthew Roever
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+	http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+
+================================= MIT License =================================
+
+Copyright (c) 2020 Matthew Roever
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+******************************************************************************/
\ No newline at end of file
@@ -0,0 +1,127 @@
+// File:		CPU_Features.cpp
+// Language:	C++17
+// Purpose:		Detects processor features for runtime SIMD dispatch.
+// License:		At bottom of document.
+
+// Header
+#include "CPU_Features.h"
+
+// Platform
+#if SIMD_X86 && !defined(_MSC_VER)
+#include <cpuid.h>
+#endif
+
+
+#if SIMD_X86
+// Runs the cpuid instruction for a leaf and subleaf.
+static void run_cpuid(uint32_t leaf, uint32_t subleaf, uint32_t regs[4]) noexcept {
+#if defined(_MSC_VER)
+	int r[4]{};
+	__cpuidex(r, static_cast<int>(leaf), static_cast<int>(subleaf));
+	for (int i = 0; i < 4; ++i) {
+		regs[i] = static_cast<uint32_t>(r[i]);
+	}
+#else
+	__cpuid_count(leaf, subleaf, regs[0], regs[1], regs[2], regs[3]);
+#endif
+}
+
+
+// Reads the extended control register that lists the register state saved by
+// the operating system.
+static uint64_t read_xcr0() noexcept {
+#if defined(_MSC_VER)
+	return _xgetbv(0);
+#else
+	uint32_t eax = 0;
+	uint32_t edx = 0;
+	__asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+	return (static_cast<uint64_t>(edx) << 32) | eax;
+#endif
+}
+#endif
+
+
+// Queries the processor.
+static CPU_Features detect_features() noexcept {
+	CPU_Features features{};
+#if SIMD_X86
+	uint32_t regs[4]{};
+	run_cpuid(0, 0, regs);
+	uint32_t maxLeaf = regs[0];
+	if (maxLeaf < 1) {
+		return features;
+	}
+
+	// Leaf 1: SSE4.2 (ecx 20), OSXSAVE (ecx 27), AVX (ecx 28)
+	run_cpuid(1, 0, regs);
+	features.sse42 = (regs[2] & (1u << 20)) != 0;
+	bool osxsave = (regs[2] & (1u << 27)) != 0;
+	bool avx = (regs[2] & (1u << 28)) != 0;
+
+	// Leaf 7: AVX2 (ebx 5), only usable if the OS saves the XMM and YMM state
+	if (maxLeaf >= 7 && osxsave && avx && (read_xcr0() & 0x6) == 0x6) {
+		run_cpuid(7, 0, regs);
+		features.avx2 = (regs[1] & (1u << 5)) != 0;
+	}
+#endif
+	return features;
+}
+
+
+// Gets the features of the processor. Detected once on first use.
+//
+// Error Handling:
+//	+ Never throws.
+const CPU_Features& cpu_features() noexcept {
+	static const CPU_Features features = detect_features();
+	return features;
+}
+
+
+
+/******************************************************************************
+
+This software is provided under two licenses. Choose whichever you prefer.
+
+
+============================= Apache License V2.0 =============================
+
+Copyright 2020 Matthew Roever
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+	http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+
+================================= MIT License =================================
+
+Copyright (c) 2020 Matthew Roever
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+******************************************************************************/
\ No newline at end of file
@@ -0,0 +1,134 @@
+// File:		CPU_Features.h
+// Language:	C++17
+// Purpose:		Detects processor features for runtime SIMD dispatch.
+// License:		At bottom of document.
+
+#ifndef CPU_FEATURES_H
+#define CPU_FEATURES_H
+
+// STL
+#include <cstdint>
+
+// Platform
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+
+// Set when compiling for x86-64, where SSE4.2 and AVX2 paths are available.
+#if defined(_M_X64) || defined(__x86_64__)
+#define SIMD_X86 1
+#else
+#define SIMD_X86 0
+#endif
+
+
+// Allows a function to use instructions beyond the compiler's target. MSVC
+// accepts any intrinsic without a flag, GCC and Clang need a target attribute.
+#if SIMD_X86 && (defined(__GNUC__) || defined(__clang__))
+#define TARGET_SSE42 __attribute__((target("sse4.2")))
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define TARGET_SSE42
+#define TARGET_AVX2
+#endif
+
+
+// Instruction set extensions of the processor running the program.
+//
+// Fields:
+//	+ sse42: SSE4.2 and everything before it (SSSE3 shuffles, CRC32).
+//	+ avx2: AVX2 with operating system support for the YMM registers.
+struct CPU_Features {
+	bool sse42 = false;
+	bool avx2 = false;
+};
+
+
+// Gets the features of the processor. Detected once on first use.
+//
+// Error Handling:
+//	+ Never throws.
+const CPU_Features& cpu_features() noexcept;
+
+
+// Gets the index of the lowest set bit. The value must not be 0.
+//
+// Error Handling:
+//	+ Never throws.
+inline uint32_t count_trailing_zeros(uint32_t value) noexcept {
+#if defined(_MSC_VER)
+	unsigned long index = 0;
+	_BitScanForward(&index, value);
+	return static_cast<uint32_t>(index);
+#else
+	return static_cast<uint32_t>(__builtin_ctz(value));
+#endif
+}
+
+
+// Gets the index of the lowest set bit. The value must not be 0.
+//
+// Error Handling:
+//	+ Never throws.
+inline uint32_t count_trailing_zeros(uint64_t value) noexcept {
+#if defined(_MSC_VER) && defined(_WIN64)
+	unsigned long index = 0;
+	_BitScanForward64(&index, value);
+	return static_cast<uint32_t>(index);
+#elif defined(_MSC_VER)
+	uint32_t low = static_cast<uint32_t>(value);
+	return low ? count_trailing_zeros(low) : 32 + count_trailing_zeros(static_cast<uint32_t>(value >> 32));
+#else
+	return static_cast<uint32_t>(__builtin_ctzll(value));
+#endif
+}
+
+#endif
+
+
+/******************************************************************************
+
+This software is provided under two licenses. Choose whichever you prefer.
+
+
+============================= Apache License V2.0 =============================
+
+Copyright 2020 Matthew Roever
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+	http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+
+================================= MIT License =================================
+
+Copyright (c) 2020 Matthew Roever
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+******************************************************************************/
\ No newline at end of file
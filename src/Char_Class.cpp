@@ -0,0 +1,155 @@
+// File:		Char_Class.cpp
+// Language:	C++17
+// Purpose:		Character classification tables and SIMD class scanning.
+// License:		At bottom of document.
+
+// Header
+#include "Char_Class.h"
+
+// Internal
+#include "CPU_Features.h"
+
+// Platform
+#if SIMD_X86
+#include <immintrin.h>
+#endif
+
+
+// Scans one character at a time.
+static uint32_t span_class_scalar(const char* s, uint32_t index, uint32_t length, uint8_t cls, const Char_Class_Lut&) {
+	for (uint32_t i = index; i < length; ++i) {
+		if (!(char_classes.classes[static_cast<uint8_t>(s[i])] & cls)) {
+			return i;
+		}
+	}
+	return length;
+}
+
+
+#if SIMD_X86
+// Scans 16 characters at a time.
+TARGET_SSE42 static uint32_t span_class_sse42(const char* s, uint32_t index, uint32_t length, uint8_t cls, const Char_Class_Lut& lut) {
+	const __m128i lo = _mm_load_si128(reinterpret_cast<const __m128i*>(lut.lo));
+	const __m128i hi = _mm_load_si128(reinterpret_cast<const __m128i*>(lut.hi));
+	const __m128i nibble = _mm_set1_epi8(0x0F);
+	const __m128i zero = _mm_setzero_si128();
+	uint32_t i = index;
+	for (; i + 16 <= length; i += 16) {
+		__m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i));
+		__m128i l = _mm_shuffle_epi8(lo, _mm_and_si128(v, nibble));
+		__m128i h = _mm_shuffle_epi8(hi, _mm_and_si128(_mm_srli_epi16(v, 4), nibble));
+		__m128i outside = _mm_cmpeq_epi8(_mm_and_si128(l, h), zero);
+		uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(outside));
+		if (mask != 0) {
+			return i + count_trailing_zeros(mask);
+		}
+	}
+	return span_class_scalar(s, i, length, cls, lut);
+}
+
+
+// Scans 32 characters at a time.
+TARGET_AVX2 static uint32_t span_class_avx2(const char* s, uint32_t index, uint32_t length, uint8_t cls, const Char_Class_Lut& lut) {
+	const __m256i lo = _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i*>(lut.lo)));
+	const __m256i hi = _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i*>(lut.hi)));
+	const __m256i nibble = _mm256_set1_epi8(0x0F);
+	const __m256i zero = _mm256_setzero_si256();
+	uint32_t i = index;
+	for (; i + 32 <= length; i += 32) {
+		__m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s + i));
+		__m256i l = _mm256_shuffle_epi8(lo, _mm256_and_si256(v, nibble));
+		__m256i h = _mm256_shuffle_epi8(hi, _mm256_and_si256(_mm256_srli_epi16(v, 4), nibble));
+		__m256i outside = _mm256_cmpeq_epi8(_mm256_and_si256(l, h), zero);
+		uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(outside));
+		if (mask != 0) {
+			return i + count_trailing_zeros(mask);
+		}
+	}
+	return span_class_scalar(s, i, length, cls, lut);
+}
+#endif
+
+
+// Signature shared by every implementation.
+using Span_Function = uint32_t(*)(const char*, uint32_t, uint32_t, uint8_t, const Char_Class_Lut&);
+
+
+// Picks the widest implementation the processor supports.
+static Span_Function select_span_class() {
+#if SIMD_X86
+	if (cpu_features().avx2) {
+		return span_class_avx2;
+	}
+	if (cpu_features().sse42) {
+		return span_class_sse42;
+	}
+#endif
+	return span_class_scalar;
+}
+
+
+// Selected once at startup.
+static const Span_Function span_class_impl = select_span_class();
+
+
+// Finds the first character at or after index that is not in the class.
+// Returns length if every remaining character is in the class. Uses AVX2 or
+// SSE4.2 when the processor supports it, selected once at startup.
+uint32_t span_class(const char* s, uint32_t index, uint32_t length, uint8_t cls, const Char_Class_Lut& lut) {
+	// Most spans are a single character, check the first two before paying for
+	// a vector load.
+	if (index >= length || !(char_classes.classes[static_cast<uint8_t>(s[index])] & cls)) {
+		return index;
+	}
+	if (index + 1 >= length || !(char_classes.classes[static_cast<uint8_t>(s[index + 1])] & cls)) {
+		return index + 1;
+	}
+	return span_class_impl(s, index + 2, length, cls, lut);
+}
+
+
+/******************************************************************************
+
+This software is provided under two licenses. Choose whichever you prefer.
+
+
+============================= Apache License V2.0 =============================
+
+Copyright 2020 Matthew Roever
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+	http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+
+================================= MIT License =================================
+
+Copyright (c) 2020 Matthew Roever
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+******************************************************************************/
\ No newline at end of file
@@ -0,0 +1,171 @@
+// File:		Char_Class.h
+// Language:	C++17
+// Purpose:		Character classification tables and SIMD class scanning.
+// License:		At bottom of document.
+
+#ifndef CHAR_CLASS_H
+#define CHAR_CLASS_H
+
+// STL
+#include <cstdint>
+#include <stdexcept>
+
+
+// Character classes used by the scanner. A character may be in several.
+enum Char_Class : uint8_t {
+	CHAR_WHITESPACE = 1 << 0,
+	CHAR_WORD = 1 << 1,
+	CHAR_NON_ASCII = 1 << 2
+};
+
+
+// Gets the classes of a single byte.
+//
+// Classes:
+//	+ CHAR_WHITESPACE: Bytes <= 32. Bytes >= 128 are only CHAR_NON_ASCII,
+//		the scanner decodes the UTF-8 character they belong to.
+//	+ CHAR_WORD: (0-9), (A-Z), (a-z), _ and 127.
+//	+ CHAR_NON_ASCII: Bytes >= 128, part of a multibyte UTF-8 character.
+constexpr uint8_t classify_char(uint8_t c) {
+	uint8_t classes = 0;
+	if (c <= 32) {
+		classes |= CHAR_WHITESPACE;
+	}
+	if ((c >= '0' && c <= '9') || (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z')
+		|| c == '_' || c == 127) {
+		classes |= CHAR_WORD;
+	}
+	if (c >= 128) {
+		classes |= CHAR_NON_ASCII;
+	}
+	return classes;
+}
+
+
+// Classes of every byte value.
+struct Char_Class_Table {
+	uint8_t classes[256]{};
+};
+
+
+// Creates the class table from classify_char.
+constexpr Char_Class_Table build_char_class_table() {
+	Char_Class_Table table{};
+	for (uint32_t c = 0; c < 256; ++c) {
+		table.classes[c] = classify_char(static_cast<uint8_t>(c));
+	}
+	return table;
+}
+
+
+// Class of every byte value, indexed by the unsigned byte.
+inline constexpr Char_Class_Table char_classes = build_char_class_table();
+
+
+// Splits membership of a single class into two 16 entry tables so a SIMD
+// shuffle can look up 16 or 32 bytes at once. A byte c is in the class when
+// (lo[c & 15] & hi[c >> 4]) != 0.
+struct Char_Class_Lut {
+	alignas(16) uint8_t lo[16]{};
+	alignas(16) uint8_t hi[16]{};
+};
+
+
+// Creates the nibble tables of a class from char_classes. Every distinct set
+// of low nibbles among the high nibble rows is given its own bit, more than 8
+// distinct rows is reported as a compile error.
+constexpr Char_Class_Lut build_char_class_lut(uint8_t cls) {
+	Char_Class_Lut lut{};
+	uint16_t rows[8]{};
+	uint32_t rowCount = 0;
+	for (uint32_t h = 0; h < 16; ++h) {
+		uint16_t row = 0;
+		for (uint32_t l = 0; l < 16; ++l) {
+			if (char_classes.classes[(h << 4) | l] & cls) {
+				row |= static_cast<uint16_t>(1u << l);
+			}
+		}
+		if (row == 0) {
+			continue;
+		}
+
+		// Reuse the bit of an identical row
+		uint32_t r = 0;
+		while (r < rowCount && rows[r] != row) {
+			r += 1;
+		}
+		if (r == rowCount) {
+			if (rowCount == 8) {
+				throw std::length_error("Character class needs more than 8 nibble rows.");
+			}
+			rows[rowCount++] = row;
+			for (uint32_t l = 0; l < 16; ++l) {
+				if (row & (1u << l)) {
+					lut.lo[l] |= static_cast<uint8_t>(1u << r);
+				}
+			}
+		}
+		lut.hi[h] = static_cast<uint8_t>(1u << r);
+	}
+	return lut;
+}
+
+
+// Nibble tables for the classes scanned with SIMD.
+inline constexpr Char_Class_Lut whitespace_lut = build_char_class_lut(CHAR_WHITESPACE);
+inline constexpr Char_Class_Lut word_lut = build_char_class_lut(CHAR_WORD);
+
+
+// Finds the first character at or after index that is not in the class.
+// Returns length if every remaining character is in the class. Uses AVX2 or
+// SSE4.2 when the processor supports it, selected once at startup.
+uint32_t span_class(const char* s, uint32_t index, uint32_t length, uint8_t cls, const Char_Class_Lut& lut);
+
+#endif
+
+
+/******************************************************************************
+
+This software is provided under two licenses. Choose whichever you prefer.
+
+
+============================= Apache License V2.0 =============================
+
+Copyright 2020 Matthew Roever
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+	http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+
+================================= MIT License =================================
+
+Copyright (c) 2020 Matthew Roever
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+******************************************************************************/
\ No newline at end of file
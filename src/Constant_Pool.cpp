@@ -0,0 +1,274 @@
+// File:		Constant_Pool.cpp
+// Language:	C++17
+// Purpose:		Decodes numeric literals and stores each distinct value once.
+// License:		At bottom of document.
+
+// Header
+#include "Constant_Pool.h"
+
+// STL
+#include <charconv>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <string>
+
+
+// Loads 8 bytes of text. The first character is the lowest byte, which
+// assumes a little endian processor like every target of the compiler.
+static uint64_t load_eight(const char* text) noexcept {
+	uint64_t v = 0;
+	std::memcpy(&v, text, 8);
+	return v;
+}
+
+
+// Checks if 8 loaded bytes are all decimal digits.
+static bool is_eight_digits(uint64_t v) noexcept {
+	return ((v & 0xF0F0F0F0F0F0F0F0) | (((v + 0x0606060606060606) & 0xF0F0F0F0F0F0F0F0) >> 4))
+		== 0x3333333333333333;
+}
+
+
+// Converts 8 loaded decimal digits to their value with three multiplies.
+static uint64_t parse_eight_digits(uint64_t v) noexcept {
+	v -= 0x3030303030303030;
+	v = (v * 10) + (v >> 8);
+	v = (((v & 0x000000FF000000FF) * (100 + (1000000ULL << 32)))
+		+ (((v >> 16) & 0x000000FF000000FF) * (1 + (10000ULL << 32)))) >> 32;
+	return v;
+}
+
+
+// Decodes (0-9)* with _ separators. Runs of 8 digits are converted at once.
+static uint64_t decode_integer(std::string_view s, bool& overflow) noexcept {
+	constexpr uint64_t MAX = std::numeric_limits<uint64_t>::max();
+	uint64_t value = 0;
+	size_t i = 0;
+	while (i < s.length()) {
+		// 8 digits without separators
+		if (s.length() - i >= 8) {
+			uint64_t v = load_eight(s.data() + i);
+			if (is_eight_digits(v)) {
+				uint64_t digits = parse_eight_digits(v);
+				if (value > (MAX - digits) / 100'000'000) {
+					overflow = true;
+					return MAX;
+				}
+				value = value * 100'000'000 + digits;
+				i += 8;
+				continue;
+			}
+		}
+
+		// Single digit or separator
+		char c = s[i++];
+		if (c == '_') {
+			continue;
+		}
+		uint64_t digit = static_cast<uint64_t>(c - '0');
+		if (value > (MAX - digit) / 10) {
+			overflow = true;
+			return MAX;
+		}
+		value = value * 10 + digit;
+	}
+	return value;
+}
+
+
+// Decodes (0-9, a-f, A-F)* with _ separators.
+static uint64_t decode_hex(std::string_view s, bool& overflow) noexcept {
+	uint64_t value = 0;
+	for (char c : s) {
+		if (c == '_') {
+			continue;
+		}
+		if (value >> 60) {
+			overflow = true;
+			return std::numeric_limits<uint64_t>::max();
+		}
+
+		// Letters have bit 6 set and a low nibble one less than their value
+		uint8_t b = static_cast<uint8_t>(c);
+		value = (value << 4) | ((b & 0xF) + 9 * (b >> 6));
+	}
+	return value;
+}
+
+
+// Decodes (0, 1)* with _ separators. Runs of 8 digits are gathered into a
+// byte with one multiply.
+static uint64_t decode_binary(std::string_view s, bool& overflow) noexcept {
+	uint64_t value = 0;
+	size_t i = 0;
+	while (i < s.length()) {
+		// 8 digits without separators
+		if (s.length() - i >= 8) {
+			uint64_t v = load_eight(s.data() + i);
+			if ((v & 0xFEFEFEFEFEFEFEFE) == 0x3030303030303030) {
+				if (value >> 56) {
+					overflow = true;
+					return std::numeric_limits<uint64_t>::max();
+				}
+				value = (value << 8) | (((v & 0x0101010101010101) * 0x8040201008040201) >> 56);
+				i += 8;
+				continue;
+			}
+		}
+
+		// Single digit or separator
+		char c = s[i++];
+		if (c == '_') {
+			continue;
+		}
+		if (value >> 63) {
+			overflow = true;
+			return std::numeric_limits<uint64_t>::max();
+		}
+		value = (value << 1) | static_cast<uint64_t>(c - '0');
+	}
+	return value;
+}
+
+
+// Decodes (0-9)*.(0-9)*(e, E)(+, -)(0-9)* with _ separators. Results that
+// are too large become infinity and are marked as overflow, results that
+// are too small round toward zero.
+static double decode_decimal(std::string_view s, bool& overflow) {
+	// Separators are removed from a copy
+	std::string copy{};
+	if (s.find('_') != std::string_view::npos) {
+		copy.reserve(s.length());
+		for (char c : s) {
+			if (c != '_') {
+				copy.push_back(c);
+			}
+		}
+		s = copy;
+	}
+
+	double value = 0;
+	auto result = std::from_chars(s.data(), s.data() + s.length(), value);
+	if (result.ec == std::errc::result_out_of_range) {
+		// Out of range is reported for overflow and underflow alike
+		copy.assign(s.data(), s.length());
+		value = std::strtod(copy.c_str(), nullptr);
+		overflow = std::isinf(value);
+	}
+	return value;
+}
+
+
+// Decodes the text of a numeric literal accepted by the number rules, including
+// any 0b or 0x prefix and _ separators.
+//
+// Error Handling:
+//	+ Values that do not fit are marked as overflow.
+//	+ Throws std::bad_alloc if a decimal literal with separators can not be
+//	  copied to remove them.
+Constant decode_number(std::string_view text, Number_Type type) {
+	Constant c{};
+	c.type = type;
+	switch (type) {
+	case Number_Type::BINARY: c.integer = decode_binary(text.substr(2), c.overflow); break;
+	case Number_Type::DECIMAL: c.decimal = decode_decimal(text, c.overflow); break;
+	case Number_Type::HEX: c.integer = decode_hex(text.substr(2), c.overflow); break;
+	case Number_Type::INTEGER: c.integer = decode_integer(text, c.overflow); break;
+	}
+	return c;
+}
+
+
+// Gets the index of a literal's value, adding the value if it is new.
+//
+// Error Handling:
+//	+ Throws std::length_error if the pool runs out of 32 bit indices.
+uint32_t Constant_Pool::add(std::string_view text, Number_Type type) {
+	return add(decode_number(text, type));
+}
+
+
+// Gets the index of a constant, adding it if it is new.
+//
+// Error Handling:
+//	+ Throws std::length_error if the pool runs out of 32 bit indices.
+uint32_t Constant_Pool::add(const Constant& value) {
+	char key[KEY_SIZE]{};
+	key[0] = static_cast<char>(value.type);
+	key[1] = static_cast<char>(value.overflow);
+	if (value.type == Number_Type::DECIMAL) {
+		std::memcpy(key + 2, &value.decimal, 8);
+	}
+	else {
+		std::memcpy(key + 2, &value.integer, 8);
+	}
+	return values.intern(std::string_view(key, KEY_SIZE));
+}
+
+
+// Gets a constant.
+//
+// Error Handling:
+//	+ Never throws. The index must have been returned by add.
+Constant Constant_Pool::get(uint32_t index) const noexcept {
+	std::string_view key = values.text(index);
+	Constant value{};
+	value.type = static_cast<Number_Type>(key[0]);
+	value.overflow = key[1] != 0;
+	if (value.type == Number_Type::DECIMAL) {
+		std::memcpy(&value.decimal, key.data() + 2, 8);
+	}
+	else {
+		std::memcpy(&value.integer, key.data() + 2, 8);
+	}
+	return value;
+}
+
+
+/******************************************************************************
+
+This software is provided under two licenses. Choose whichever you prefer.
+
+
+============================= Apache License V2.0 =============================
+
+Copyright 2020 Matthew Roever
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+	http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+
+================================= MIT License =================================
+
+Copyright (c) 2020 Matthew Roever
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+******************************************************************************/
\ No newline at end of file
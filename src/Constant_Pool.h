@@ -0,0 +1,140 @@
+// File:		Constant_Pool.h
+// Language:	C++17
+// Purpose:		Decodes numeric literals and stores each distinct value once.
+// License:		At bottom of document.
+
+#ifndef CONSTANT_POOL_H
+#define CONSTANT_POOL_H
+
+// STL
+#include <cstdint>
+#include <string_view>
+
+// Internal
+#include "Symbol_Table.h"
+#include "Vocabulary.h"
+
+
+// Numeric constants, see Vocabulary.h.
+enum class Number_Type : uint32_t {
+	NUMBER_TYPE_LIST(VOCABULARY_ENUMERATOR)
+};
+
+
+// Value of a numeric literal.
+//
+// Fields:
+//	+ type: Spelling of the literal.
+//	+ overflow: The literal does not fit its value, which is then the largest
+//	  representable value (UINT64_MAX or infinity).
+//	+ integer: Value of BINARY, HEX and INTEGER literals.
+//	+ decimal: Value of DECIMAL literals.
+struct Constant {
+	Number_Type type = Number_Type::INTEGER;
+	bool overflow = false;
+	uint64_t integer = 0;
+	double decimal = 0;
+};
+
+
+// Decodes the text of a numeric literal accepted by the number rules, including
+// any 0b or 0x prefix and _ separators.
+//
+// Error Handling:
+//	+ Values that do not fit are marked as overflow.
+//	+ Throws std::bad_alloc if a decimal literal with separators can not be
+//	  copied to remove them.
+Constant decode_number(std::string_view text, Number_Type type);
+
+
+// Maps numeric constants to dense 32 bit indices numbered from 0 in the order
+// they were first seen. Literals of the same type and value share an index,
+// so 1_000 and 1000 are the same constant but 0x10 and 16 are not. The pool
+// may be shared by any number of threads.
+class Constant_Pool {
+public:
+	// Gets the index of a literal's value, adding the value if it is new.
+	//
+	// Error Handling:
+	//	+ Throws std::length_error if the pool runs out of 32 bit indices.
+	uint32_t add(std::string_view text, Number_Type type);
+
+
+	// Gets the index of a constant, adding it if it is new.
+	//
+	// Error Handling:
+	//	+ Throws std::length_error if the pool runs out of 32 bit indices.
+	uint32_t add(const Constant& value);
+
+
+	// Gets a constant.
+	//
+	// Error Handling:
+	//	+ Never throws. The index must have been returned by add.
+	Constant get(uint32_t index) const noexcept;
+
+
+	// Gets the number of constants.
+	//
+	// Error Handling:
+	//	+ Never throws.
+	uint32_t size() const noexcept {
+		return values.size();
+	}
+
+private:
+	// Constants are interned by their encoding: type, overflow, then the
+	// 8 bytes of the value.
+	static constexpr size_t KEY_SIZE = 10;
+
+	Symbol_Table values{};
+};
+
+#endif
+
+
+/******************************************************************************
+
+This software is provided under two licenses. Choose whichever you prefer.
+
+
+============================= Apache License V2.0 =============================
+
+Copyright 2020 Matthew Roever
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+	http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+
+================================= MIT License =================================
+
+Copyright (c) 2020 Matthew Roever
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+******************************************************************************/
\ No newline at end of file
@@ -0,0 +1,154 @@
+// File:		Diagnostics.cpp
+// Language:	C++17
+// Purpose:		Collects the problems found in a source file.
+// License:		At bottom of document.
+
+// Header
+#include "Diagnostics.h"
+
+// STL
+#include <iterator>
+#include <new>
+#include <utility>
+
+
+// Adds a problem. Once the limit is reached, or memory runs out, the
+// problem is only counted.
+//
+// Error Handling:
+//	+ Never throws.
+void Diagnostics::report(Severity severity, uint32_t offset, uint32_t length, const char* message) noexcept {
+	counts[static_cast<size_t>(severity)] += 1;
+	if (kept.size() < limit) {
+		try {
+			kept.push_back({ severity, offset, length, message });
+		}
+		catch (const std::bad_alloc&) {
+		}
+	}
+}
+
+
+// Adds a problem. Once the limit is reached, or memory runs out, the
+// problem is only counted.
+//
+// Error Handling:
+//	+ Never throws.
+void Diagnostics::report(Severity severity, uint32_t offset, uint32_t length, std::string&& message) noexcept {
+	counts[static_cast<size_t>(severity)] += 1;
+	if (kept.size() < limit) {
+		try {
+			kept.push_back({ severity, offset, length, std::move(message) });
+		}
+		catch (const std::bad_alloc&) {
+		}
+	}
+}
+
+
+// Replaces the problems at offsets [begin, end) with replacement, which
+// must be in order and lie in that part of the file, and moves the
+// problems after it by shift. Used when part of a file is scanned again.
+// Returns false and leaves the problems unchanged if problems were
+// dropped, before or after the change.
+//
+// Error Handling:
+//	+ Never throws. Returns false if memory runs out.
+bool Diagnostics::replace(uint32_t begin, uint32_t end, uint32_t shift, std::vector<Diagnostic>& replacement) noexcept {
+	if (dropped() != 0) {
+		return false;
+	}
+	auto first = kept.begin();
+	while (first != kept.end() && first->offset < begin) {
+		++first;
+	}
+	auto last = first;
+	while (last != kept.end() && last->offset < end) {
+		++last;
+	}
+	const size_t size = kept.size() - (last - first) + replacement.size();
+	if (size > limit) {
+		return false;
+	}
+	try {
+		std::vector<Diagnostic> changed{};
+		changed.reserve(size);
+		changed.insert(changed.end(), std::make_move_iterator(kept.begin()), std::make_move_iterator(first));
+		changed.insert(changed.end(), std::make_move_iterator(replacement.begin()),
+			std::make_move_iterator(replacement.end()));
+		for (auto it = last; it != kept.end(); ++it) {
+			changed.push_back(std::move(*it));
+			changed.back().offset += shift;
+		}
+		kept.swap(changed);
+	}
+	catch (const std::bad_alloc&) {
+		return false;
+	}
+	counts[0] = 0;
+	counts[1] = 0;
+	counts[2] = 0;
+	for (const Diagnostic& d : kept) {
+		counts[static_cast<size_t>(d.severity)] += 1;
+	}
+	return true;
+}
+
+
+// Removes every problem, keeping the limit and memory.
+//
+// Error Handling:
+//	+ Never throws.
+void Diagnostics::clear() noexcept {
+	kept.clear();
+	counts[0] = 0;
+	counts[1] = 0;
+	counts[2] = 0;
+}
+
+
+/******************************************************************************
+
+This software is provided under two licenses. Choose whichever you prefer.
+
+
+============================= Apache License V2.0 =============================
+
+Copyright 2020 Matthew Roever
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+	http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+
+================================= MIT License =================================
+
+Copyright (c) 2020 Matthew Roever
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+******************************************************************************/
\ No newline at end of file
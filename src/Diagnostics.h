@@ -0,0 +1,189 @@
+// File:		Diagnostics.h
+// Language:	C++17
+// Purpose:		Collects the problems found in a source file.
+// License:		At bottom of document.
+
+#ifndef DIAGNOSTICS_H
+#define DIAGNOSTICS_H
+
+// STL
+#include <cstdint>
+#include <string>
+#include <vector>
+
+
+// How serious a problem is.
+enum class Severity : uint8_t {
+	NOTE,
+	WARNING,
+	ERROR
+};
+
+
+// A problem found in a source file. The text it refers to is found by its
+// offset in the Source_Buffer, like a token.
+//
+// Fields:
+//	+ severity: How serious the problem is.
+//	+ offset: Offset of the text in the source buffer.
+//	+ length: Length of the text, may be 0.
+//	+ message: Description of the problem.
+struct Diagnostic {
+	Severity severity = Severity::ERROR;
+	uint32_t offset = 0;
+	uint32_t length = 0;
+	std::string message{};
+};
+
+
+// Problems found in one source file, in the order they were reported. Only
+// the first limit problems are kept, the rest are counted so a file full of
+// errors can not flood the output. Reporting never throws, so the scanner can
+// report a problem and carry on with the rest of the file.
+class Diagnostics {
+public:
+	// Problems kept per file unless another limit is given.
+	static constexpr size_t DEFAULT_LIMIT = 100;
+
+
+	// Keeps at most limit problems.
+	//
+	// Error Handling:
+	//	+ Never throws.
+	explicit Diagnostics(size_t limit = DEFAULT_LIMIT) noexcept : limit(limit) {}
+
+
+	// Adds a problem. Once the limit is reached, or memory runs out, the
+	// problem is only counted.
+	//
+	// Error Handling:
+	//	+ Never throws.
+	void report(Severity severity, uint32_t offset, uint32_t length, const char* message) noexcept;
+
+
+	// Adds a problem. Once the limit is reached, or memory runs out, the
+	// problem is only counted.
+	//
+	// Error Handling:
+	//	+ Never throws.
+	void report(Severity severity, uint32_t offset, uint32_t length, std::string&& message) noexcept;
+
+
+	// Gets the problems that were kept.
+	//
+	// Error Handling:
+	//	+ Never throws.
+	const std::vector<Diagnostic>& entries() const noexcept {
+		return kept;
+	}
+
+
+	// Gets the number of problems reported with a severity, including those
+	// that were not kept.
+	//
+	// Error Handling:
+	//	+ Never throws.
+	size_t count(Severity severity) const noexcept {
+		return counts[static_cast<size_t>(severity)];
+	}
+
+
+	// Gets the number of problems that were reported but not kept.
+	//
+	// Error Handling:
+	//	+ Never throws.
+	size_t dropped() const noexcept {
+		return counts[0] + counts[1] + counts[2] - kept.size();
+	}
+
+
+	// Checks if no problem was reported.
+	//
+	// Error Handling:
+	//	+ Never throws.
+	bool empty() const noexcept {
+		return counts[0] + counts[1] + counts[2] == 0;
+	}
+
+
+	// Counts problems without keeping them, for problems that were dropped
+	// before, such as those restored from a token cache.
+	//
+	// Error Handling:
+	//	+ Never throws.
+	void count_only(Severity severity, size_t count) noexcept {
+		counts[static_cast<size_t>(severity)] += count;
+	}
+
+
+	// Replaces the problems at offsets [begin, end) with replacement, which
+	// must be in order and lie in that part of the file, and moves the
+	// problems after it by shift. Used when part of a file is scanned again.
+	// Returns false and leaves the problems unchanged if problems were
+	// dropped, before or after the change.
+	//
+	// Error Handling:
+	//	+ Never throws. Returns false if memory runs out.
+	bool replace(uint32_t begin, uint32_t end, uint32_t shift, std::vector<Diagnostic>& replacement) noexcept;
+
+
+	// Removes every problem, keeping the limit and memory.
+	//
+	// Error Handling:
+	//	+ Never throws.
+	void clear() noexcept;
+
+private:
+	std::vector<Diagnostic> kept{};
+	size_t counts[3] = {};
+	size_t limit = DEFAULT_LIMIT;
+};
+
+#endif
+
+
+/******************************************************************************
+
+This software is provided under two licenses. Choose whichever you prefer.
+
+
+============================= Apache License V2.0 =============================
+
+Copyright 2020 Matthew Roever
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+	http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+
+================================= MIT License =================================
+
+Copyright (c) 2020 Matthew Roever
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+******************************************************************************/
\ No newline at end of file
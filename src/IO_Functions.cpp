@@ -8,6 +8,7 @@
 
 // STL
 #include <algorithm>
+#include <iterator>
 
 
 // Prints a symbol multiple times.
@@ -18,13 +19,27 @@ void print_symbol(size_t count, char c) {
 }
 
 
-// Prints a line and marks a specific lexeme.
+// Prints a line and marks a specific lexeme. The lexeme is in bytes, one mark
+// is printed per character and tabs before it are kept.
 // This is a marked example:
 //           ^^^^^^
-void print_marked_lexeme(const std::string& s, Lexeme lex) {
+void print_marked_lexeme(std::string_view s, Lexeme lex) {
 	std::cout << s << "\n";
-	print_symbol(lex.begin, ' ');
-	print_symbol(lex.end - lex.begin, '^');
+
+	// One mark per character, tabs are copied so the marks line up
+	for (uint32_t i = 0; i < lex.begin && i < s.length(); ++i) {
+		if (s[i] == '\t') {
+			std::cout << '\t';
+		}
+		else if ((static_cast<uint8_t>(s[i]) & 0xC0) != 0x80) {
+			std::cout << ' ';
+		}
+	}
+	for (uint32_t i = lex.begin; i < lex.end && i < s.length(); ++i) {
+		if ((static_cast<uint8_t>(s[i]) & 0xC0) != 0x80) {
+			std::cout << '^';
+		}
+	}
 	std::cout << "\n";
 }
 
@@ -35,124 +50,45 @@ void print_marked_lexeme(const std::string& s, Lexeme lex) {
 *
 *************************************************************************/
 
+// Printed text of each enum value, indexed by the value. Generated from
+// Vocabulary.h and stored as characters rather than pointers, so the tables
+// need no relocation when the program loads.
+static constexpr char token_type_names[][12] = { TOKEN_TYPE_LIST(VOCABULARY_TEXT) };
+static constexpr char keyword_names[][16] = { KEYWORD_LIST(VOCABULARY_NAME) };
+static constexpr char number_type_names[][8] = { NUMBER_TYPE_LIST(VOCABULARY_TEXT) };
+static constexpr char string_type_names[][8] = { STRING_TYPE_LIST(VOCABULARY_TEXT) };
+static constexpr char operator_names[][24] = { OPERATOR_LIST(VOCABULARY_TEXT) "UNSUPPORTED_OPERATOR" };
+static constexpr char severity_names[][8] = { "Note", "Warning", "Error" };
+static_assert(std::size(operator_names) == static_cast<size_t>(Operator_Type::UNSUPPORTED_OPERATOR) + 1,
+	"Every operator needs a name.");
+
+
+// Prints the name of t, or unknown if t has no name.
+template <typename T, size_t N, size_t Length>
+static std::ostream& print_name(std::ostream& os, T t, const char (&names)[N][Length], const char* unknown) {
+	size_t i = static_cast<size_t>(t);
+	return os << (i < N ? names[i] : unknown);
+}
+
+
 // Enumerations
 std::ostream& operator<<(std::ostream& os, Token_Type t) {
-	switch (t) {
-	case Token_Type::EOL: os << "EOL"; break;
-	case Token_Type::KEYWORD: os << "KEYWORD   "; break;
-	case Token_Type::NUMBER: os << "NUMBER    "; break;
-	case Token_Type::OPERATOR: os << "OPERATOR  "; break;
-	case Token_Type::STRING: os << "STRING    "; break;
-	case Token_Type::WORD: os << "WORD      "; break;
-	default: os << "UNKNOWN  "; break;
-	}
-	return os;
+	return print_name(os, t, token_type_names, "UNKNOWN  ");
 }
 std::ostream& operator<<(std::ostream& os, Keyword_Type t) {
-	switch (t) {
-	case Keyword_Type::I8: os << "I8"; break;
-	case Keyword_Type::I16: os << "I16"; break;
-	case Keyword_Type::I32: os << "I32"; break;
-	case Keyword_Type::I64: os << "I64"; break;
-	case Keyword_Type::U8: os << "U8"; break;
-	case Keyword_Type::U16: os << "U16"; break;
-	case Keyword_Type::U32: os << "U32"; break;
-	case Keyword_Type::U64: os << "U64"; break;
-	case Keyword_Type::F16: os << "F16"; break;
-	case Keyword_Type::F32: os << "F32"; break;
-	case Keyword_Type::F64: os << "F64"; break;
-	case Keyword_Type::CLASS: os << "CLASS"; break;
-	case Keyword_Type::LET: os << "LET"; break;
-	case Keyword_Type::SELF: os << "SELF"; break;
-	case Keyword_Type::STRUCT: os << "STRUCT"; break;
-	case Keyword_Type::VAR: os << "VAR"; break;
-	case Keyword_Type::CREF: os << "CREF"; break;
-	case Keyword_Type::FN: os << "FN"; break;
-	case Keyword_Type::MOVE: os << "MOVE"; break;
-	case Keyword_Type::REF: os << "REF"; break;
-	case Keyword_Type::RETURN: os << "RETURN"; break;
-	case Keyword_Type::NAMESPACE: os << "NAMESPACE"; break;
-	default: os << "UNKNOWN"; break;
-	}
-	return os;
+	return print_name(os, t, keyword_names, "UNKNOWN");
 }
 std::ostream& operator<<(std::ostream& os, Number_Type t) {
-	switch (t) {
-	case Number_Type::BINARY: os << "BINARY"; break;
-	case Number_Type::DECIMAL: os << "DECIMAL"; break;
-	case Number_Type::HEX: os << "HEX"; break;
-	case Number_Type::INTEGER: os << "INTEGER"; break;
-	default: os << "UNKNOWN"; break;
-	}
-	return os;
+	return print_name(os, t, number_type_names, "UNKNOWN");
 }
 std::ostream& operator<<(std::ostream& os, String_Type t) {
-	switch (t) {
-	case String_Type::DOUBLE: os << "DOUBLE"; break;
-	case String_Type::SINGLE: os << "SINGLE"; break;
-	default: os << "UNKNOWN"; break;
-	}
-	return os;
+	return print_name(os, t, string_type_names, "UNKNOWN");
 }
 std::ostream& operator<<(std::ostream& os, Operator_Type t) {
-	switch (t) {
-	case Operator_Type::ACCESSOR: os << "."; break;
-	case Operator_Type::ARROW: os << "->"; break;
-	case Operator_Type::ASTERISK: os << "*"; break;
-	case Operator_Type::BACK_SLASH: os << "\\"; break;
-	case Operator_Type::BITWISE_AND: os << "&"; break;
-	case Operator_Type::BITWISE_AND_EQUAL: os << "&="; break;
-	case Operator_Type::BITWISE_NOT: os << "~"; break;
-	case Operator_Type::BITWISE_OR: os << "|"; break;
-	case Operator_Type::BITWISE_OR_EQUAL: os << "|="; break;
-	case Operator_Type::BITWISE_XOR: os << "^"; break;
-	case Operator_Type::BITWISE_XOR_EQUAL: os << "^="; break;
-	case Operator_Type::CLOSED_ATTRIBUTE: os << "]]"; break;
-	case Operator_Type::CLOSED_CURLY: os << "}"; break;
-	case Operator_Type::CLOSED_PAREN: os << ")"; break;
-	case Operator_Type::CLOSED_SQUARE: os << "]"; break;
-	case Operator_Type::COLON: os << ":"; break;
-	case Operator_Type::COMMA: os << ","; break;
-	case Operator_Type::DECREMENT: os << "--"; break;
-	case Operator_Type::DIVIDE: os << "/"; break;
-	case Operator_Type::DIVIDE_EQUALS: os << "/="; break;
-	case Operator_Type::EQUALS: os << "="; break;
-	case Operator_Type::EQUALS_TO: os << "=="; break;
-	case Operator_Type::GREATER: os << ">"; break;
-	case Operator_Type::GREATER_EQUAL: os << ">="; break;
-	case Operator_Type::INCREMENT: os << "++"; break;
-	case Operator_Type::LEFT_SHIFT: os << "<<"; break;
-	case Operator_Type::LEFT_SHIFT_EQUAL: os << "<<="; break;
-	case Operator_Type::LESS: os << "<"; break;
-	case Operator_Type::LESS_EQUAL: os << "<="; break;
-	case Operator_Type::LOGICAL_AND: os << "&&"; break;
-	case Operator_Type::LOGICAL_NOT: os << "!"; break;
-	case Operator_Type::LOGICAL_OR: os << "||"; break;
-	case Operator_Type::LOGICAL_XOR: os << "^^"; break;
-	case Operator_Type::MACRO: os << "#"; break;
-	case Operator_Type::MATCH_CASE: os << "=>"; break;
-	case Operator_Type::MINUS: os << "-"; break;
-	case Operator_Type::MINUS_EQUAL: os << "-="; break;
-	case Operator_Type::MODULO: os << "%"; break;
-	case Operator_Type::MODULO_EQUAL: os << "%="; break;
-	case Operator_Type::MULTIPLY_EQUAL: os << "*="; break;
-	case Operator_Type::NOT_EQUAL: os << "!="; break;
-	case Operator_Type::OPEN_ATTRIBUTE: os << "[["; break;
-	case Operator_Type::OPEN_CURLY: os << "{"; break;
-	case Operator_Type::OPEN_PAREN: os << "("; break;
-	case Operator_Type::OPEN_SQUARE: os << "["; break;
-	case Operator_Type::PLUS: os << "+"; break;
-	case Operator_Type::PLUS_EQUAL: os << "+="; break;
-	case Operator_Type::RIGHT_SHIFT: os << ">>"; break;
-	case Operator_Type::RIGHT_SHIFT_EQUAL: os << ">>="; break;
-	case Operator_Type::SCOPE: os << "::"; break;
-	case Operator_Type::SEMICOLON: os << ";"; break;
-	case Operator_Type::TERNARY: os << "?"; break;
-	case Operator_Type::THREE_WAY_COMP: os << "<=>"; break;
-	case Operator_Type::UNSUPPORTED_OPERATOR: os << "UNSUPPORTED_OPERATOR"; break;
-	default: os << "UKNOWN_OPERATOR"; break;
-	}
-	return os;
+	return print_name(os, t, operator_names, "UKNOWN_OPERATOR");
+}
+std::ostream& operator<<(std::ostream& os, Severity t) {
+	return print_name(os, t, severity_names, "Unknown");
 }
 
 
@@ -9,8 +9,10 @@
 // STL
 #include <iostream>
 #include <string>
+#include <string_view>
 
 // Internal
+#include "Diagnostics.h"
 #include "Scanner.h"
 
 
@@ -34,10 +36,11 @@ void print_number_pad(T num, size_t pad) {
 void print_symbol(size_t count, char c);
 
 
-// Prints a line and marks a specific lexeme.
+// Prints a line and marks a specific lexeme. The lexeme is in bytes, one mark
+// is printed per character and tabs before it are kept.
 // This is a marked example:
 //           ^^^^^^
-void print_marked_lexeme(const std::string& s, Lexeme lex);
+void print_marked_lexeme(std::string_view s, Lexeme lex);
 
 
 /**************************************************************************
@@ -52,6 +55,7 @@ std::ostream& operator<<(std::ostream& os, Keyword_Type t);
 std::ostream& operator<<(std::ostream& os, Number_Type t);
 std::ostream& operator<<(std::ostream& os, String_Type t);
 std::ostream& operator<<(std::ostream& os, Operator_Type t);
+std::ostream& operator<<(std::ostream& os, Severity t);
 
 #endif
 
@@ -0,0 +1,151 @@
+// File:		Intern_Storage.h
+// Language:	C++17
+// Purpose:		Storage shared by the tables that intern text as dense 32 bit indices.
+// License:		At bottom of document.
+
+#ifndef INTERN_STORAGE_H
+#define INTERN_STORAGE_H
+
+// STL
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <vector>
+
+
+// Array indexed by any 32 bit index whose items never move. Items are kept in
+// pages, page p holding 1024 << p items, so 23 pages cover every index and a
+// page is only created once an index in it is used. An item may be read by
+// any thread once its index has been published, while other items are added.
+template <typename T>
+class Paged_Array {
+public:
+	Paged_Array() = default;
+	Paged_Array(const Paged_Array&) = delete;
+	Paged_Array& operator=(const Paged_Array&) = delete;
+
+
+	~Paged_Array() {
+		for (auto& page : pages) {
+			delete[] page.load(std::memory_order_relaxed);
+		}
+	}
+
+
+	// Gets an item. The item must have been set with at().
+	//
+	// Error Handling:
+	//	+ Never throws.
+	const T& operator[](uint32_t index) const noexcept {
+		uint32_t page = 0;
+		locate(index, page);
+		return pages[page].load(std::memory_order_acquire)[index];
+	}
+
+
+	// Gets an item to set, creating its page if needed.
+	T& at(uint32_t index) {
+		uint32_t page = 0;
+		locate(index, page);
+		T* items = pages[page].load(std::memory_order_acquire);
+		if (!items) {
+			std::lock_guard<std::mutex> guard{ pageLock };
+			items = pages[page].load(std::memory_order_relaxed);
+			if (!items) {
+				items = new T[size_t(1) << (FIRST_PAGE_BITS + page)];
+				pages[page].store(items, std::memory_order_release);
+			}
+		}
+		return items[index];
+	}
+
+private:
+	static constexpr uint32_t FIRST_PAGE_BITS = 10;
+	static constexpr uint32_t PAGES = 23;
+
+
+	// Gets the page holding an index, and changes the index to the item's
+	// position within the page.
+	static void locate(uint32_t& index, uint32_t& page) noexcept {
+		uint64_t n = (static_cast<uint64_t>(index) >> FIRST_PAGE_BITS) + 1;
+		page = 0;
+		while (n >>= 1) {
+			page += 1;
+		}
+		index -= static_cast<uint32_t>(((uint64_t(1) << page) - 1) << FIRST_PAGE_BITS);
+	}
+
+
+	// Pages of items, guarded by pageLock when created
+	std::mutex pageLock{};
+	std::atomic<T*> pages[PAGES]{};
+};
+
+
+// Text copied into blocks of at least 64 KB that are never moved or freed
+// before the storage, so views of stored text stay valid. Not synchronized,
+// each shard of a table has its own.
+class Text_Blocks {
+public:
+	// Copies text into the blocks.
+	std::string_view store(std::string_view text);
+
+private:
+	static constexpr size_t BLOCK_SIZE = 64 * 1024;
+
+	std::vector<std::unique_ptr<char[]>> blocks{};
+	char* next = nullptr;
+	size_t left = 0;
+};
+
+#endif
+
+
+/******************************************************************************
+
+This software is provided under two licenses. Choose whichever you prefer.
+
+
+============================= Apache License V2.0 =============================
+
+Copyright 2020 Matthew Roever
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+	http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+
+================================= MIT License =================================
+
+Copyright (c) 2020 Matthew Roever
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+******************************************************************************/
\ No newline at end of file
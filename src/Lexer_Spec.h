@@ -0,0 +1,759 @@
+// File:		Lexer_Spec.h
+// Language:	C++17
+// Purpose:		Declarative rules of the language's lexemes and the automaton
+//				built from them at compile time.
+// License:		At bottom of document.
+
+#ifndef LEXER_SPEC_H
+#define LEXER_SPEC_H
+
+// STL
+#include <cstdint>
+#include <stdexcept>
+
+// Internal
+#include "Char_Class.h"
+#include "Constant_Pool.h"
+#include "Scanner.h"
+
+
+/**************************************************************************
+*
+*	Lexer rules
+*
+*************************************************************************/
+
+// Decides how a lexeme is finished once the automaton has matched it.
+// Operators and numbers are matched in full by the automaton, the other rules
+// only match their first characters and the scanner finds the end.
+enum class Lexeme_Rule : uint8_t {
+	NONE,						// No lexeme starts here
+	WHITESPACE,					// Spanned by scan_whitespace
+	WORD,						// Spanned by scan_word, then checked for keywords
+	NON_ASCII,					// Whitespace or a word above ASCII
+	NUMBER,						// Subtype is the Number_Type
+	OPERATOR,					// Subtype is the Operator_Type
+	LINE_COMMENT,				// //, runs to the end of the line
+	BLOCK_COMMENT,				// /*, runs to */ on this or a later line
+	DOUBLE_QUOTE,				// " string literal
+	SINGLE_QUOTE				// ' string literal
+};
+
+
+// Defines a lexeme that is spelled out in full, or the characters that start
+// one.
+//
+// Fields:
+//	+ text: The characters that make up the lexeme.
+//	+ rule: The rule of the lexeme when the text is matched.
+struct Lexeme_Spelling {
+	const char* text = "";
+	Lexeme_Rule rule;
+};
+
+
+// Comments and string literals. Only their start is matched by the
+// automaton, the longest spelling wins so // and /* are not read as /.
+inline constexpr Lexeme_Spelling lexeme_spellings[] = {
+	{ "//", Lexeme_Rule::LINE_COMMENT },
+	{ "/*", Lexeme_Rule::BLOCK_COMMENT },
+	{ "\"", Lexeme_Rule::DOUBLE_QUOTE },
+	{ "'", Lexeme_Rule::SINGLE_QUOTE }
+};
+
+
+// Defines the spelling of an operator.
+//
+// Fields:
+//	+ text: The characters that make up the operator.
+//	+ type: The operator type produced when the text is matched.
+struct Operator_Spelling {
+	const char* text = "";
+	Operator_Type type;
+};
+
+
+// All supported operators, generated from OPERATOR_LIST and
+// UNSUPPORTED_OPERATOR_LIST in Vocabulary.h. The lexer automaton is built
+// from this table at compile time.
+#define OPERATOR_SPELLING(name, text) { text, Operator_Type::name },
+inline constexpr Operator_Spelling operator_spellings[] = {
+	OPERATOR_LIST(OPERATOR_SPELLING)
+	UNSUPPORTED_OPERATOR_LIST(OPERATOR_SPELLING)
+};
+#undef OPERATOR_SPELLING
+
+
+// States of the number rules. START is the start state of the automaton, the
+// others are given states of their own when it is built.
+enum class Number_State : uint8_t {
+	START,
+	ZERO,
+	INTEGER,
+	INTEGER_SEPARATOR,
+	INTEGER_END,
+	BINARY_PREFIX,
+	BINARY,
+	BINARY_SEPARATOR,
+	BINARY_END,
+	HEX_PREFIX,
+	HEX,
+	HEX_SEPARATOR,
+	HEX_END,
+	FRACTION,
+	FRACTION_DIGITS,
+	FRACTION_SEPARATOR,
+	FRACTION_END,
+	EXPONENT_MARK,
+	EXPONENT_SIGN,
+	EXPONENT,
+	EXPONENT_SEPARATOR,
+	EXPONENT_END,
+	COUNT
+};
+
+
+// Defines a transition of the number rules.
+//
+// Fields:
+//	+ from: State the transition leaves.
+//	+ bytes: The bytes that take it. a-z is a range, a - at either end is
+//		itself. \n stands for the end of the line and consumes nothing.
+//	+ to: State the transition enters.
+struct Number_Step {
+	Number_State from;
+	const char* bytes = "";
+	Number_State to;
+};
+
+
+// Numbers are binary 0b1, hex 0xF, integers 1 and decimals 1.5e-3. A _
+// separator is part of a number if it is followed by a digit or ends the
+// line. A prefix or exponent mark without a digit after it is not part of
+// the number.
+inline constexpr Number_Step number_steps[] = {
+	{ Number_State::START, "0", Number_State::ZERO },
+	{ Number_State::START, "1-9", Number_State::INTEGER },
+
+	// Integers, 0b and 0x only follow a leading 0
+	{ Number_State::ZERO, "0-9", Number_State::INTEGER },
+	{ Number_State::ZERO, "_", Number_State::INTEGER_SEPARATOR },
+	{ Number_State::ZERO, ".", Number_State::FRACTION },
+	{ Number_State::ZERO, "b", Number_State::BINARY_PREFIX },
+	{ Number_State::ZERO, "x", Number_State::HEX_PREFIX },
+	{ Number_State::INTEGER, "0-9", Number_State::INTEGER },
+	{ Number_State::INTEGER, "_", Number_State::INTEGER_SEPARATOR },
+	{ Number_State::INTEGER, ".", Number_State::FRACTION },
+	{ Number_State::INTEGER_SEPARATOR, "0-9", Number_State::INTEGER },
+	{ Number_State::INTEGER_SEPARATOR, "\n", Number_State::INTEGER_END },
+
+	// Binary
+	{ Number_State::BINARY_PREFIX, "01", Number_State::BINARY },
+	{ Number_State::BINARY, "01", Number_State::BINARY },
+	{ Number_State::BINARY, "_", Number_State::BINARY_SEPARATOR },
+	{ Number_State::BINARY_SEPARATOR, "01", Number_State::BINARY },
+	{ Number_State::BINARY_SEPARATOR, "\n", Number_State::BINARY_END },
+
+	// Hexadecimal
+	{ Number_State::HEX_PREFIX, "0-9a-fA-F", Number_State::HEX },
+	{ Number_State::HEX, "0-9a-fA-F", Number_State::HEX },
+	{ Number_State::HEX, "_", Number_State::HEX_SEPARATOR },
+	{ Number_State::HEX_SEPARATOR, "0-9a-fA-F", Number_State::HEX },
+	{ Number_State::HEX_SEPARATOR, "\n", Number_State::HEX_END },
+
+	// Decimals, the fraction may be empty or start with a separator
+	{ Number_State::FRACTION, "0-9", Number_State::FRACTION_DIGITS },
+	{ Number_State::FRACTION, "_", Number_State::FRACTION_SEPARATOR },
+	{ Number_State::FRACTION, "eE", Number_State::EXPONENT_MARK },
+	{ Number_State::FRACTION_DIGITS, "0-9", Number_State::FRACTION_DIGITS },
+	{ Number_State::FRACTION_DIGITS, "_", Number_State::FRACTION_SEPARATOR },
+	{ Number_State::FRACTION_DIGITS, "eE", Number_State::EXPONENT_MARK },
+	{ Number_State::FRACTION_SEPARATOR, "0-9", Number_State::FRACTION_DIGITS },
+	{ Number_State::FRACTION_SEPARATOR, "\n", Number_State::FRACTION_END },
+	{ Number_State::EXPONENT_MARK, "+-", Number_State::EXPONENT_SIGN },
+	{ Number_State::EXPONENT_MARK, "0-9", Number_State::EXPONENT },
+	{ Number_State::EXPONENT_MARK, "_", Number_State::EXPONENT_SEPARATOR },
+	{ Number_State::EXPONENT_SIGN, "0-9", Number_State::EXPONENT },
+	{ Number_State::EXPONENT_SIGN, "_", Number_State::EXPONENT_SEPARATOR },
+	{ Number_State::EXPONENT, "0-9", Number_State::EXPONENT },
+	{ Number_State::EXPONENT, "_", Number_State::EXPONENT_SEPARATOR },
+	{ Number_State::EXPONENT_SEPARATOR, "0-9", Number_State::EXPONENT },
+	{ Number_State::EXPONENT_SEPARATOR, "\n", Number_State::EXPONENT_END }
+};
+
+
+// Digits the scanner skips in bulk while the automaton stays in a state.
+enum class Digit_Span : uint8_t {
+	NONE,
+	BINARY,
+	DECIMAL,
+	HEX
+};
+
+
+// Defines a number state that completes a number.
+//
+// Fields:
+//	+ state: The accepting state.
+//	+ type: The number type produced when the automaton stops in it.
+//	+ span: Digits and separators that loop on the state. They are skipped
+//		eight at a time instead of one transition each.
+struct Number_Accept {
+	Number_State state;
+	Number_Type type;
+	Digit_Span span = Digit_Span::NONE;
+};
+
+
+// Accepting states of the number rules.
+inline constexpr Number_Accept number_accepts[] = {
+	{ Number_State::ZERO, Number_Type::INTEGER },
+	{ Number_State::INTEGER, Number_Type::INTEGER, Digit_Span::DECIMAL },
+	{ Number_State::INTEGER_END, Number_Type::INTEGER },
+	{ Number_State::BINARY, Number_Type::BINARY, Digit_Span::BINARY },
+	{ Number_State::BINARY_END, Number_Type::BINARY },
+	{ Number_State::HEX, Number_Type::HEX, Digit_Span::HEX },
+	{ Number_State::HEX_END, Number_Type::HEX },
+	{ Number_State::FRACTION, Number_Type::DECIMAL },
+	{ Number_State::FRACTION_DIGITS, Number_Type::DECIMAL, Digit_Span::DECIMAL },
+	{ Number_State::FRACTION_END, Number_Type::DECIMAL },
+	{ Number_State::EXPONENT, Number_Type::DECIMAL, Digit_Span::DECIMAL },
+	{ Number_State::EXPONENT_END, Number_Type::DECIMAL }
+};
+
+
+// Defines the lexemes that start with any byte of a character class.
+//
+// Fields:
+//	+ cls: The character class of the first byte.
+//	+ rule: The rule of the lexeme.
+struct Class_Start {
+	uint8_t cls;
+	Lexeme_Rule rule;
+};
+
+
+// Lexemes started by a class. Bytes already taken by a spelling or number
+// are left to them, so digits start numbers rather than words.
+inline constexpr Class_Start class_starts[] = {
+	{ CHAR_WHITESPACE, Lexeme_Rule::WHITESPACE },
+	{ CHAR_WORD, Lexeme_Rule::WORD },
+	{ CHAR_NON_ASCII, Lexeme_Rule::NON_ASCII }
+};
+
+
+/**************************************************************************
+*
+*	Lexer automaton
+*
+*************************************************************************/
+
+// Maximum number of states in the lexer automaton, before it is minimized.
+constexpr uint32_t LEXER_STATES = 128;
+
+
+// Byte standing for the end of the line. Lines never contain it.
+constexpr uint8_t LEXER_EOL = '\n';
+
+
+// What the automaton knows about a state.
+//
+// Fields:
+//	+ rule: The rule of a lexeme ending in the state, NONE if it is not
+//		accepting.
+//	+ subtype: The Number_Type or Operator_Type of an accepting state.
+//	+ span: Digits skipped in bulk on entering the state.
+struct Lexer_State {
+	Lexeme_Rule rule = Lexeme_Rule::NONE;
+	uint8_t subtype = 0;
+	Digit_Span span = Digit_Span::NONE;
+};
+
+
+// Deterministic finite automaton that recognizes every lexeme. Each state has
+// a transition for every possible byte, so matching costs one table load per
+// character. State 0 is the start state and doubles as the reject state since
+// no transition ever returns to it.
+//
+// Fields:
+//	+ next: Transition to the next state, indexed by [state][byte].
+//	+ states: What is known about each state.
+//	+ count: Number of states in use.
+struct Lexer_Table {
+	uint8_t next[LEXER_STATES][256]{};
+	Lexer_State states[LEXER_STATES]{};
+	uint32_t count = 1;
+};
+
+
+// Gives the state reached from state by c a new state if it has none.
+// Reports running out of states as a compile error.
+constexpr uint8_t lexer_transition(Lexer_Table& table, uint32_t state, uint8_t c) {
+	if (table.next[state][c] == 0) {
+		if (table.count == LEXER_STATES) {
+			throw std::length_error("Lexer table is full.");
+		}
+		table.next[state][c] = static_cast<uint8_t>(table.count++);
+	}
+	return table.next[state][c];
+}
+
+
+// Adds a spelled out lexeme. Two spellings with the same text are reported as
+// a compile error.
+constexpr void add_lexer_spelling(Lexer_Table& table, const char* text, Lexeme_Rule rule, uint8_t subtype) {
+	uint32_t state = 0;
+	for (uint32_t i = 0; text[i] != '\0'; ++i) {
+		state = lexer_transition(table, state, static_cast<uint8_t>(text[i]));
+	}
+	if (table.states[state].rule != Lexeme_Rule::NONE) {
+		throw std::logic_error("Lexeme is spelled twice.");
+	}
+	table.states[state].rule = rule;
+	table.states[state].subtype = subtype;
+}
+
+
+// Adds the number rules. A transition that another rule already takes is
+// reported as a compile error.
+constexpr void add_number_rules(Lexer_Table& table) {
+	constexpr uint32_t count = static_cast<uint32_t>(Number_State::COUNT);
+	uint8_t states[count]{};
+	for (uint32_t i = 1; i < count; ++i) {
+		if (table.count == LEXER_STATES) {
+			throw std::length_error("Lexer table is full.");
+		}
+		states[i] = static_cast<uint8_t>(table.count++);
+	}
+	for (const auto& step : number_steps) {
+		uint8_t from = states[static_cast<uint32_t>(step.from)];
+		uint8_t to = states[static_cast<uint32_t>(step.to)];
+		const char* b = step.bytes;
+		for (uint32_t i = 0; b[i] != '\0'; ++i) {
+			uint8_t lo = static_cast<uint8_t>(b[i]);
+			uint8_t hi = lo;
+			if (b[i + 1] == '-' && b[i + 2] != '\0') {
+				hi = static_cast<uint8_t>(b[i + 2]);
+				i += 2;
+			}
+			for (uint32_t c = lo; c <= hi; ++c) {
+				if (table.next[from][c] != 0) {
+					throw std::logic_error("Number rules overlap another lexeme.");
+				}
+				table.next[from][c] = to;
+			}
+		}
+	}
+	for (const auto& accept : number_accepts) {
+		auto& state = table.states[states[static_cast<uint32_t>(accept.state)]];
+		state.rule = Lexeme_Rule::NUMBER;
+		state.subtype = static_cast<uint8_t>(accept.type);
+		state.span = accept.span;
+	}
+}
+
+
+// Mixes a value into a hash, used to find equal rows and columns quickly.
+constexpr uint32_t lexer_mix(uint32_t hash, uint32_t value) {
+	return (hash ^ value) * 0x01000193;
+}
+
+
+// Merges states that no input can tell apart (Moore's algorithm). States
+// start out split by what they accept and are split again by the groups
+// their transitions lead to until no group splits. Bytes whose transitions
+// are the same in every state are compared once, which keeps the compile
+// time work small.
+constexpr Lexer_Table minimize_lexer_table(const Lexer_Table& table) {
+	const uint32_t count = table.count;
+
+	// Group equal columns into byte classes
+	uint32_t columnHash[256]{};
+	for (uint32_t c = 0; c < 256; ++c) {
+		uint32_t hash = 0x811C9DC5;
+		for (uint32_t s = 0; s < count; ++s) {
+			hash = lexer_mix(hash, table.next[s][c]);
+		}
+		columnHash[c] = hash;
+	}
+	uint8_t classByte[256]{};
+	uint32_t classes = 0;
+	for (uint32_t c = 0; c < 256; ++c) {
+		uint32_t k = 0;
+		for (; k < classes; ++k) {
+			uint32_t r = classByte[k];
+			if (columnHash[r] != columnHash[c]) {
+				continue;
+			}
+			uint32_t s = 0;
+			while (s < count && table.next[s][r] == table.next[s][c]) {
+				s += 1;
+			}
+			if (s == count) {
+				break;
+			}
+		}
+		if (k == classes) {
+			classByte[classes++] = static_cast<uint8_t>(c);
+		}
+	}
+
+	// Split by what each state accepts. The start state is never merged.
+	uint8_t group[LEXER_STATES]{};
+	uint8_t rep[LEXER_STATES]{};
+	uint32_t groups = 1;
+	for (uint32_t s = 1; s < count; ++s) {
+		const Lexer_State& a = table.states[s];
+		uint32_t g = 1;
+		for (; g < groups; ++g) {
+			const Lexer_State& b = table.states[rep[g]];
+			if (a.rule == b.rule && a.subtype == b.subtype && a.span == b.span) {
+				break;
+			}
+		}
+		if (g == groups) {
+			rep[groups++] = static_cast<uint8_t>(s);
+		}
+		group[s] = static_cast<uint8_t>(g);
+	}
+
+	// Split by the groups transitions lead to, 0 stays the reject state
+	while (true) {
+		uint32_t rowHash[LEXER_STATES]{};
+		for (uint32_t s = 0; s < count; ++s) {
+			uint32_t hash = lexer_mix(0x811C9DC5, group[s]);
+			for (uint32_t k = 0; k < classes; ++k) {
+				uint8_t to = table.next[s][classByte[k]];
+				hash = lexer_mix(hash, to == 0 ? 0xFF : group[to]);
+			}
+			rowHash[s] = hash;
+		}
+		uint8_t split[LEXER_STATES]{};
+		uint8_t splitRep[LEXER_STATES]{};
+		uint32_t splits = 1;
+		for (uint32_t s = 1; s < count; ++s) {
+			uint32_t g = 1;
+			for (; g < splits; ++g) {
+				uint32_t r = splitRep[g];
+				if (rowHash[r] != rowHash[s] || group[r] != group[s]) {
+					continue;
+				}
+				uint32_t k = 0;
+				for (; k < classes; ++k) {
+					uint8_t a = table.next[r][classByte[k]];
+					uint8_t b = table.next[s][classByte[k]];
+					if ((a == 0) != (b == 0) || group[a] != group[b]) {
+						break;
+					}
+				}
+				if (k == classes) {
+					break;
+				}
+			}
+			if (g == splits) {
+				splitRep[splits++] = static_cast<uint8_t>(s);
+			}
+			split[s] = static_cast<uint8_t>(g);
+		}
+		for (uint32_t s = 0; s < count; ++s) {
+			group[s] = split[s];
+			rep[s] = splitRep[s];
+		}
+		if (splits == groups) {
+			break;
+		}
+		groups = splits;
+	}
+
+	// One state per group, taken from its first state
+	Lexer_Table result{};
+	result.count = groups;
+	for (uint32_t g = 0; g < groups; ++g) {
+		for (uint32_t c = 0; c < 256; ++c) {
+			uint8_t to = table.next[rep[g]][c];
+			result.next[g][c] = (to == 0) ? 0 : group[to];
+		}
+		result.states[g] = table.states[rep[g]];
+	}
+	return result;
+}
+
+
+// Creates the lexer automaton from lexeme_spellings, operator_spellings,
+// number_steps and class_starts, then minimizes it. Evaluated at compile
+// time, rules that conflict or exceed LEXER_STATES are reported as a compile
+// error.
+constexpr Lexer_Table build_lexer_table() {
+	Lexer_Table table{};
+	for (const auto& lexeme : lexeme_spellings) {
+		add_lexer_spelling(table, lexeme.text, lexeme.rule, 0);
+	}
+	for (const auto& op : operator_spellings) {
+		add_lexer_spelling(table, op.text, Lexeme_Rule::OPERATOR, static_cast<uint8_t>(op.type));
+	}
+	add_number_rules(table);
+
+	// Each class start gets one state for all of its bytes
+	for (const auto& start : class_starts) {
+		uint8_t state = 0;
+		for (uint32_t c = 0; c < 256; ++c) {
+			if ((char_classes.classes[c] & start.cls) == 0 || table.next[0][c] != 0) {
+				continue;
+			}
+			if (state == 0) {
+				state = lexer_transition(table, 0, static_cast<uint8_t>(c));
+				table.states[state].rule = start.rule;
+			}
+			table.next[0][c] = state;
+		}
+	}
+	return minimize_lexer_table(table);
+}
+
+
+// Lexer automaton of the language.
+inline constexpr Lexer_Table lexer_table = build_lexer_table();
+
+
+/**************************************************************************
+*
+*	Keywords
+*
+*************************************************************************/
+
+// Defines the spelling of a keyword.
+//
+// Fields:
+//	+ text: The characters that make up the keyword.
+//	+ type: The keyword type produced when the text is matched.
+struct Keyword_Spelling {
+	const char* text = "";
+	Keyword_Type type;
+};
+
+
+// All supported keywords, generated from KEYWORD_LIST in Vocabulary.h. The
+// perfect hash table is built from this table at compile time.
+#define KEYWORD_SPELLING(name, text) { text, Keyword_Type::name },
+inline constexpr Keyword_Spelling keyword_spellings[] = {
+	KEYWORD_LIST(KEYWORD_SPELLING)
+};
+#undef KEYWORD_SPELLING
+
+
+// Size of the keyword hash table. Must be a power of two, a table roughly
+// three times larger than the keyword count keeps the multiplier search short.
+constexpr uint32_t KEYWORD_SLOT_BITS = 6;
+constexpr uint32_t KEYWORD_SLOTS = 1u << KEYWORD_SLOT_BITS;
+
+
+// Longest keyword that can be stored in the keyword hash table.
+constexpr uint32_t KEYWORD_MAX_LENGTH = 15;
+
+
+// Entry in the keyword hash table. Empty slots have a length of 0.
+struct Keyword_Slot {
+	char text[KEYWORD_MAX_LENGTH + 1]{};
+	uint32_t length = 0;
+	Keyword_Type type{};
+};
+
+
+// Perfect hash table of all keywords. A word is hashed from its length, first
+// and last character, so every word is checked against exactly one slot.
+struct Keyword_Table {
+	uint32_t multiplier = 0;
+	Keyword_Slot slots[KEYWORD_SLOTS]{};
+};
+
+
+// Packs the bytes of a word used for keyword hashing.
+constexpr uint32_t keyword_key(char first, char last, uint32_t length) {
+	return static_cast<uint8_t>(first)
+		| (static_cast<uint32_t>(static_cast<uint8_t>(last)) << 8)
+		| ((length & 0xFF) << 16);
+}
+
+
+// Selects the keyword slot for a packed key.
+constexpr uint32_t keyword_slot(uint32_t key, uint32_t multiplier) {
+	return (key * multiplier) >> (32 - KEYWORD_SLOT_BITS);
+}
+
+
+// Creates the keyword hash table from keyword_spellings. Evaluated at compile
+// time, searches for a multiplier that places every keyword in its own slot.
+// Failing to find one is reported as a compile error.
+constexpr Keyword_Table build_keyword_table() {
+	constexpr size_t count = sizeof(keyword_spellings) / sizeof(keyword_spellings[0]);
+	uint32_t keys[count]{};
+	for (size_t i = 0; i < count; ++i) {
+		const char* text = keyword_spellings[i].text;
+		uint32_t length = 0;
+		while (text[length] != '\0') {
+			length += 1;
+		}
+		if (length == 0 || length > KEYWORD_MAX_LENGTH) {
+			throw std::length_error("Keyword length is not supported.");
+		}
+		keys[i] = keyword_key(text[0], text[length - 1], length);
+	}
+
+	// Try multipliers until no two keywords share a slot
+	uint32_t multiplier = 0x9E3779B1;
+	for (uint32_t attempt = 0; attempt < 1000; ++attempt) {
+		uint64_t used = 0;
+		bool collision = false;
+		for (size_t i = 0; i < count && !collision; ++i) {
+			uint64_t bit = uint64_t(1) << keyword_slot(keys[i], multiplier);
+			collision = (used & bit) != 0;
+			used |= bit;
+		}
+
+		// Fill the table
+		if (!collision) {
+			Keyword_Table table{};
+			table.multiplier = multiplier;
+			for (size_t i = 0; i < count; ++i) {
+				auto& slot = table.slots[keyword_slot(keys[i], multiplier)];
+				const char* text = keyword_spellings[i].text;
+				while (text[slot.length] != '\0') {
+					slot.text[slot.length] = text[slot.length];
+					slot.length += 1;
+				}
+				slot.type = keyword_spellings[i].type;
+			}
+			return table;
+		}
+		multiplier = (multiplier + 0x3C6EF362) | 1;
+	}
+	throw std::logic_error("No perfect hash found for the keywords.");
+}
+
+
+// Keyword hash table of the language.
+inline constexpr Keyword_Table keyword_table = build_keyword_table();
+
+
+/**************************************************************************
+*
+*	Fingerprint
+*
+*************************************************************************/
+
+// Mixes text and the 0 ending it into a 64 bit FNV-1a hash, so texts in a
+// row can not run into each other.
+constexpr uint64_t fingerprint_text(uint64_t hash, const char* text) {
+	do {
+		hash = (hash ^ static_cast<uint8_t>(*text)) * 0x100000001B3;
+	} while (*text++ != '\0');
+	return hash;
+}
+
+
+// Mixes a value into a 64 bit FNV-1a hash, one byte at a time.
+constexpr uint64_t fingerprint_value(uint64_t hash, uint32_t value) {
+	for (uint32_t i = 0; i < 4; ++i) {
+		hash = (hash ^ ((value >> (8 * i)) & 0xFF)) * 0x100000001B3;
+	}
+	return hash;
+}
+
+
+// Every list of Vocabulary.h as the name then the text of each entry, each
+// list headed by its own name.
+#define VOCABULARY_FINGERPRINT(name, text) #name, text,
+inline constexpr const char* vocabulary_entries[] = {
+	"TOKEN_TYPE_LIST", TOKEN_TYPE_LIST(VOCABULARY_FINGERPRINT)
+	"KEYWORD_LIST", KEYWORD_LIST(VOCABULARY_FINGERPRINT)
+	"OPERATOR_LIST", OPERATOR_LIST(VOCABULARY_FINGERPRINT)
+	"UNSUPPORTED_OPERATOR_LIST", UNSUPPORTED_OPERATOR_LIST(VOCABULARY_FINGERPRINT)
+	"NUMBER_TYPE_LIST", NUMBER_TYPE_LIST(VOCABULARY_FINGERPRINT)
+	"STRING_TYPE_LIST", STRING_TYPE_LIST(VOCABULARY_FINGERPRINT)
+};
+#undef VOCABULARY_FINGERPRINT
+
+
+// Hashes the vocabulary, the keyword and operator spellings and the lexer
+// automaton. Evaluated at compile time.
+constexpr uint64_t build_language_fingerprint() {
+	uint64_t hash = 0xCBF29CE484222325;
+	for (const char* text : vocabulary_entries) {
+		hash = fingerprint_text(hash, text);
+	}
+	for (const auto& keyword : keyword_spellings) {
+		hash = fingerprint_text(hash, keyword.text);
+		hash = fingerprint_value(hash, static_cast<uint32_t>(keyword.type));
+	}
+	for (const auto& op : operator_spellings) {
+		hash = fingerprint_text(hash, op.text);
+		hash = fingerprint_value(hash, static_cast<uint32_t>(op.type));
+	}
+
+	// States past count are never reached and stay empty
+	hash = fingerprint_value(hash, lexer_table.count);
+	for (uint32_t s = 0; s < lexer_table.count; ++s) {
+		const Lexer_State& state = lexer_table.states[s];
+		hash = fingerprint_value(hash, static_cast<uint32_t>(state.rule));
+		hash = fingerprint_value(hash, state.subtype);
+		hash = fingerprint_value(hash, static_cast<uint32_t>(state.span));
+		for (uint32_t c = 0; c < 256; ++c) {
+			hash = fingerprint_value(hash, lexer_table.next[s][c]);
+		}
+	}
+	return hash;
+}
+
+
+// Fingerprint of the language's lexical rules. Part of every artifact key, so
+// output stored by a compiler with other rules is never used.
+inline constexpr uint64_t language_fingerprint = build_language_fingerprint();
+
+#endif
+
+
+/******************************************************************************
+
+This software is provided under two licenses. Choose whichever you prefer.
+
+
+============================= Apache License V2.0 =============================
+
+Copyright 2020 Matthew Roever
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+	http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+
+================================= MIT License =================================
+
+Copyright (c) 2020 Matthew Roever
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+******************************************************************************/
\ No newline at end of file
@@ -4,10 +4,14 @@
 // License:		At bottom of document.
 
 // STL
+#include <algorithm>
+#include <cstdint>
 #include <filesystem>
 #include <iostream>
+#include <optional>
 #include <stdexcept>
 #include <string>
+#include <thread>
 #include <vector>
 
 // Internal
@@ -34,6 +38,28 @@
 *		Prints all lexemes identified by the compiler.
 *	-print_tokens
 *		Prints all tokens identified by the compiler.
+*	-no_mmap
+*		Reads the file into memory instead of memory mapping it.
+*	-stream
+*		Scans the file as a token stream without storing lexemes or tokens.
+*		Lexemes can not be printed.
+*	-threads <count>
+*		Number of threads used to scan the file. Defaults to 1. Use 0 for the
+*		number of hardware threads.
+*	-emit_tokens <file_address>
+*		Writes the scanner output to a token cache file. Can not be combined
+*		with -stream.
+*	-load_tokens <file_address>
+*		Uses the scanner output in a token cache file instead of scanning, if
+*		the cache was written for the same text. Otherwise the file is scanned.
+*	-cache <directory_address>
+*		Keeps the output of each compiler phase in an artifact store, which
+*		may be shared by compilers running at the same time. Output stored
+*		for the same text, compiler version and options is used instead of
+*		running the phase again.
+*	-cache_size <megabytes>
+*		Size budget of the artifact store, least recently used output is
+*		removed to stay within it. Defaults to 1024.
 //
 //	NOT YET SUPPORTED.
 //
@@ -55,6 +81,13 @@ struct Arguments {
 	bool printFile = false;
 	bool printLexemes = false;
 	bool printTokens = false;
+	bool useMmap = true;
+	uint32_t threads = 1;
+	bool stream = false;
+	std::filesystem::path emitTokens{};
+	std::filesystem::path loadTokens{};
+	std::filesystem::path cacheDirectory{};
+	uint64_t cacheBudget = Artifact_Cache::DEFAULT_BUDGET;
 	//bool printSymbolTable = false;
 	//bool printAST = false;
 };
@@ -102,6 +135,47 @@ Arguments process_CLI(const std::vector<std::string>& cli) {
 		else if (cli[i] == "-print_tokens") {
 			args.printTokens = true;
 		}
+		// Read instead of memory mapping
+		else if (cli[i] == "-no_mmap") {
+			args.useMmap = false;
+		}
+		// Stream tokens instead of storing them
+		else if (cli[i] == "-stream") {
+			args.stream = true;
+		}
+		// Scanner threads
+		else if (cli[i] == "-threads") {
+			i += 1;
+			int count = std::stoi(cli.at(i));
+			if (count < 0) {
+				throw std::runtime_error("Thread count can not be negative: " + cli[i]);
+			}
+			args.threads = (count == 0) ? std::max(1u, std::thread::hardware_concurrency()) : (uint32_t)count;
+		}
+		// Write a token cache
+		else if (cli[i] == "-emit_tokens") {
+			i += 1;
+			args.emitTokens = cli.at(i);
+		}
+		// Read a token cache
+		else if (cli[i] == "-load_tokens") {
+			i += 1;
+			args.loadTokens = cli.at(i);
+		}
+		// Artifact store
+		else if (cli[i] == "-cache") {
+			i += 1;
+			args.cacheDirectory = cli.at(i);
+		}
+		// Artifact store budget
+		else if (cli[i] == "-cache_size") {
+			i += 1;
+			long long megabytes = std::stoll(cli.at(i));
+			if (megabytes <= 0) {
+				throw std::runtime_error("Cache size must be positive: " + cli[i]);
+			}
+			args.cacheBudget = static_cast<uint64_t>(megabytes) << 20;
+		}
 		//// Print the symbol table
 		//else if (cli[i] == "-print_symbol_table") {
 		//	args.printSymbolTable = true;
@@ -115,6 +189,9 @@ Arguments process_CLI(const std::vector<std::string>& cli) {
 			throw std::runtime_error("Invalid CLI argument: " + cli[i]);
 		}
 	}
+	if (args.stream && !args.emitTokens.empty()) {
+		throw std::runtime_error("-emit_tokens can not be used with -stream.");
+	}
 	return args;
 }
 
@@ -140,10 +217,38 @@ int main(int argc, char** argv) {
 		return EXIT_FAILURE;
 	}
 
-	// Run compiler
+	// Run compiler, any error in the code fails the run
+	int status = EXIT_SUCCESS;
 	try {
-		Source_Code code{ cmds.filePath };
-		code.run_scanner();
+		Symbol_Table symbols{};
+		Constant_Pool constants{};
+		String_Pool strings{};
+		std::optional<Artifact_Cache> artifacts{};
+		Source_Code code{ cmds.filePath, symbols, constants, strings, cmds.useMmap };
+
+		// No option changes the output of a phase yet, so no flags are keyed
+		if (!cmds.cacheDirectory.empty()) {
+			artifacts.emplace(cmds.cacheDirectory, cmds.cacheBudget);
+			code.use_artifacts(*artifacts);
+		}
+
+		// A cache for the same text replaces the scan, and is not written again
+		bool cached = !cmds.loadTokens.empty() && code.load_tokens(cmds.loadTokens);
+		if (!cached) {
+			if (cmds.stream) {
+				code.stream_scanner();
+			}
+			else {
+				code.run_scanner(cmds.threads);
+			}
+		}
+		if (!cmds.emitTokens.empty() && !(cached && cmds.emitTokens == cmds.loadTokens)) {
+			code.emit_tokens(cmds.emitTokens);
+		}
+		code.print_diagnostics();
+		if (code.error_count() != 0) {
+			status = EXIT_FAILURE;
+		}
 
 		// Output
 		if (cmds.printTiming) {
@@ -170,12 +275,13 @@ int main(int argc, char** argv) {
 	}
 	catch (const std::exception& err) {
 		std::cout << "Error: " << err.what() << "\n";
+		status = EXIT_FAILURE;
 	}
 
 	// Exit
 	std::cout << "Exiting: ";
 	system("pause");
-	return EXIT_SUCCESS;
+	return status;
 }
 
 
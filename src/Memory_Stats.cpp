@@ -0,0 +1,179 @@
+// File:		Memory_Stats.cpp
+// Language:	C++17
+// Purpose:		Counts heap allocations for compiler statistics.
+// License:		At bottom of document.
+
+// Header
+#include "Memory_Stats.h"
+
+// STL
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+
+// Allocations made through operator new.
+static std::atomic<uint64_t> allocations{ 0 };
+
+
+// Gets the number of heap allocations made through operator new since the
+// program started. The unaligned global operators new and delete are
+// replaced to keep the count.
+//
+// Error Handling:
+//	+ Never throws.
+uint64_t allocation_count() noexcept {
+	return allocations.load(std::memory_order_relaxed);
+}
+
+
+// Counts the allocation, otherwise behaves as the standard operator new.
+static void* counted_new(std::size_t size) {
+	allocations.fetch_add(1, std::memory_order_relaxed);
+	if (size == 0) {
+		size = 1;
+	}
+	for (;;) {
+		void* p = std::malloc(size);
+		if (p) {
+			return p;
+		}
+		std::new_handler handler = std::get_new_handler();
+		if (!handler) {
+			throw std::bad_alloc();
+		}
+		handler();
+	}
+}
+
+
+// Counts the allocation, returning nullptr where counted_new would throw.
+//
+// Error Handling:
+//	+ Never throws.
+static void* counted_new(std::size_t size, const std::nothrow_t&) noexcept {
+	try {
+		return counted_new(size);
+	}
+	catch (...) {
+		return nullptr;
+	}
+}
+
+
+/**************************************************************************
+*
+*	Replaced global operators
+*
+*************************************************************************/
+
+// Every unaligned form is replaced, not only the one the others call by
+// default, since sanitizer runtimes replace whichever forms are left and
+// memory would then be released by another allocator than the one that gave
+// it. The aligned forms are all left to the standard library.
+
+// Counts the allocation.
+void* operator new(std::size_t size) {
+	return counted_new(size);
+}
+
+
+// Counts the allocation.
+void* operator new[](std::size_t size) {
+	return counted_new(size);
+}
+
+
+// Counts the allocation, nullptr if it failed.
+void* operator new(std::size_t size, const std::nothrow_t& tag) noexcept {
+	return counted_new(size, tag);
+}
+
+
+// Counts the allocation, nullptr if it failed.
+void* operator new[](std::size_t size, const std::nothrow_t& tag) noexcept {
+	return counted_new(size, tag);
+}
+
+
+// Releases memory from operator new.
+void operator delete(void* p) noexcept {
+	std::free(p);
+}
+
+
+// Releases memory from operator new[].
+void operator delete[](void* p) noexcept {
+	std::free(p);
+}
+
+
+// Releases memory from operator new.
+void operator delete(void* p, std::size_t) noexcept {
+	std::free(p);
+}
+
+
+// Releases memory from operator new[].
+void operator delete[](void* p, std::size_t) noexcept {
+	std::free(p);
+}
+
+
+// Releases memory from the nothrow operator new.
+void operator delete(void* p, const std::nothrow_t&) noexcept {
+	std::free(p);
+}
+
+
+// Releases memory from the nothrow operator new[].
+void operator delete[](void* p, const std::nothrow_t&) noexcept {
+	std::free(p);
+}
+
+
+/******************************************************************************
+
+This software is provided under two licenses. Choose whichever you prefer.
+
+
+============================= Apache License V2.0 =============================
+
+Copyright 2020 Matthew Roever
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+	http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+
+================================= MIT License =================================
+
+Copyright (c) 2020 Matthew Roever
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+******************************************************************************/
\ No newline at end of file
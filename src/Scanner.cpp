@@ -6,247 +6,962 @@
 // Header
 #include "Scanner.h"
 
+// STL
+#include <algorithm>
+#include <exception>
+#include <iterator>
+
 // Internal
 #include "Scanner_Support.h"
 
 
-// Scans input text to produce lexemes and tokens.
-Scanner_Results scan(const std::vector<std::string>& code) {
-	Scanner_Results results{};
-	results.lines.resize(code.size());
-	results.tokens.reserve(code.size());
-	std::vector<Token> toks{};
-	auto operators = build_operator_hierarchy();
-	auto keywords = build_keywords();
-
-	// Process each line
-	for (size_t i = 0; i < code.size(); ++i) {
-		results.lines[i].text = code[i];
-
-		// Process each line of code
-		uint32_t index = 0;
-		uint32_t newIndex = 0;
-		Token tok;
-		while (index < code[i].length()) {
-			// Check for whitespace
-			newIndex = scan_whitespace(code[i], index);
-			if (newIndex != index) {
-				results.lines[i].lexemes.push_back({ index, newIndex });
-				index = newIndex;
-				continue;
-			}
+// Adds a token to the open statement.
+void Token_Table::push_back(const Token& tok) {
+	types.push_back(tok.type);
+	subtypes.push_back(tok.subtype);
+	offsets.push_back(tok.offset);
+	lengths.push_back(tok.length);
+}
 
-			// Check for numbers
-			newIndex = scan_number(code[i], index, tok.subtype.num);
-			if (newIndex != index) {
-				tok.lexeme = (uint32_t)results.lines[i].lexemes.size();
-				tok.lineNumber = (uint32_t)i;
-				tok.type = Token_Type::NUMBER;
-				toks.push_back(tok);
-				results.lines[i].lexemes.push_back({ index, newIndex });
-				index = newIndex;
-				continue;
-			}
 
-			// Check for comments
-			Comment_Case cc = Comment_Case::NONE;
-			newIndex = scan_comment(code[i], index, cc);
-			if (newIndex != index) {
-				// Comment was contained to the line
-				if (cc == Comment_Case::NONE) {
-					results.lines[i].lexemes.push_back({ index, newIndex });
-					index = newIndex;
-					continue;
-				}
-				// Division operator found
-				else if (cc == Comment_Case::DIVISION) {
-					tok.lexeme = (uint32_t)results.lines[i].lexemes.size();
-					tok.lineNumber = (uint32_t)i;
-					tok.type = Token_Type::OPERATOR;
-					tok.subtype.op = Operator_Type::DIVIDE;
-					toks.push_back(tok);
-					results.lines[i].lexemes.push_back({ index, newIndex });
-					index = newIndex;
-					continue;
-				}
-				// Division equals operator found
-				else if (cc == Comment_Case::DIVISION_EQUALS) {
-					tok.lexeme = (uint32_t)results.lines[i].lexemes.size();
-					tok.lineNumber = (uint32_t)i;
-					tok.type = Token_Type::OPERATOR;
-					tok.subtype.op = Operator_Type::DIVIDE_EQUALS;
-					toks.push_back(tok);
-					results.lines[i].lexemes.push_back({ index, newIndex });
-					index = newIndex;
-					continue;
-				}
-				// Multiline comment found
-				else if (cc == Comment_Case::MULTILINE) {
-					results.lines[i].lexemes.push_back({ index, newIndex });
-
-					// Process each line until the end of the MLC is found
-					i += 1;
-					for (; i < code.size(); ++i) {
-						if (code[i].length() == 0) continue;
-						results.lines[i].text = code[i];
-						size_t pos = code[i].find("*/");
-						if (pos == std::string::npos) {
-							results.lines[i].lexemes.push_back({ 0, (uint32_t)code[i].length() });
-						}
-						else {
-							index = (uint32_t)pos + 2;
-							results.lines[i].lexemes.push_back({ 0, index });
-							break;
-						}
-					}
-					continue;
-				}
-				// Single line comment with a line continuation found
-				else {
-					results.lines[i].lexemes.push_back({ index, newIndex });
-					i += 1;
-					for (; i < code.size(); ++i) {
-						if (code[i].length() == 0) continue;
-						results.lines[i].text = code[i];
-						results.lines[i].lexemes.push_back({ 0, (uint32_t)code[i].length() });
-						if (code[i].back() != '\\') break;
-					}
-					break;
-				}
+// Removes the last token.
+//
+// Error Handling:
+//	+ Never throws. The table must not be empty.
+void Token_Table::pop_back() noexcept {
+	types.pop_back();
+	subtypes.pop_back();
+	offsets.pop_back();
+	lengths.pop_back();
+}
+
+
+// Ends the open statement after its last token.
+void Token_Table::end_statement() {
+	statementEnds.push_back((uint32_t)size());
+}
+
+
+// Adds the tokens of another table, starting at one of its statements.
+// The open statement of this table continues into the added tokens.
+void Token_Table::append(const Token_Table& other, size_t firstStatement) {
+	const uint32_t begin = other.statement_begin(firstStatement);
+	const uint32_t shift = (uint32_t)size() - begin;
+	types.insert(types.end(), other.types.begin() + begin, other.types.end());
+	subtypes.insert(subtypes.end(), other.subtypes.begin() + begin, other.subtypes.end());
+	offsets.insert(offsets.end(), other.offsets.begin() + begin, other.offsets.end());
+	lengths.insert(lengths.end(), other.lengths.begin() + begin, other.lengths.end());
+	for (size_t i = firstStatement; i < other.statementEnds.size(); ++i) {
+		statementEnds.push_back(other.statementEnds[i] + shift);
+	}
+}
+
+
+// Removes every token and statement, keeping the memory.
+//
+// Error Handling:
+//	+ Never throws.
+void Token_Table::clear() noexcept {
+	types.clear();
+	subtypes.clear();
+	offsets.clear();
+	lengths.clear();
+	statementEnds.clear();
+}
+
+
+// Reserves space for a number of tokens.
+void Token_Table::reserve(size_t tokens) {
+	types.reserve(tokens);
+	subtypes.reserve(tokens);
+	offsets.reserve(tokens);
+	lengths.reserve(tokens);
+	statementEnds.reserve(tokens / 4);
+}
+
+
+// Gets a view of the results. The view is valid until the results change.
+//
+// Error Handling:
+//	+ Never throws.
+Scanner_View Scanner_Results::view() const noexcept {
+	Scanner_View v{};
+	v.lines = lines.data();
+	v.lexemes = lexemes.data();
+	v.types = tokens.types.data();
+	v.subtypes = tokens.subtypes.data();
+	v.offsets = tokens.offsets.data();
+	v.lengths = tokens.lengths.data();
+	v.statementEnds = tokens.statementEnds.data();
+	v.partners = brackets.partners.data();
+	v.unmatched = brackets.unmatched.data();
+	v.lineCount = (uint32_t)lines.size();
+	v.lexemeCount = (uint32_t)lexemes.size();
+	v.tokenCount = (uint32_t)tokens.size();
+	v.statementCount = (uint32_t)tokens.statement_count();
+	v.unmatchedCount = (uint32_t)brackets.unmatched.size();
+	return v;
+}
+
+
+// Statements and the state left at the end of a range of lines.
+struct Chunk_Results {
+	size_t first = 0;
+	size_t last = 0;
+	std::vector<Lexeme> lexemes{};
+	Token_Table tokens{};
+	Line_State state = Line_State::NORMAL;
+	Open_Literal literal{};
+	std::exception_ptr error{};
+};
+
+
+// Adds the open literal to the pool once its last piece was scanned. The
+// pieces are the last tokens of the table and all get the literal's index.
+static void end_literal(Open_Literal& literal, Token_Table& tokens, String_Pool& strings) {
+	uint32_t index = strings.add(literal.text, literal.type);
+	for (size_t i = tokens.size() - literal.pieces; i < tokens.size(); ++i) {
+		tokens.subtypes[i].literal = index;
+	}
+	literal.pieces = 0;
+}
+
+
+// Scans one line, which starts at lineBegin in the source. Lexemes are
+// appended to lexemes. Tokens are added to the open statement of the table,
+// which is ended at the end of the line. The state and literal carry
+// multiline comments and strings between lines.
+static void scan_line(std::string_view text, uint32_t lineBegin, Line_State& state, Open_Literal& literal,
+	Line& line, std::vector<Lexeme>& lexemes, Token_Table& tokens, Symbol_Table& symbols,
+	Constant_Pool& constants, String_Pool& strings) {
+	// A blank line ends a string continuation
+	if (text.empty() &&
+		(state == Line_State::DOUBLE_CONTINUATION || state == Line_State::SINGLE_CONTINUATION)) {
+		state = Line_State::NORMAL;
+		if (literal.pieces) {
+			end_literal(literal, tokens, strings);
+		}
+	}
+
+	// Process each lexeme
+	const size_t firstLexeme = lexemes.size();
+	uint32_t index = 0;
+	Lexeme lex{};
+	Token tok{};
+	while (index < text.length()) {
+		if (scan_lexeme(text, index, state, literal, lex, tok, symbols, constants, strings)) {
+			tok.offset = lineBegin + lex.begin;
+			tok.length = lex.end - lex.begin;
+			tokens.push_back(tok);
+			if (literal.pieces && state == Line_State::NORMAL) {
+				end_literal(literal, tokens, strings);
 			}
+		}
+		lexemes.push_back(lex);
+	}
+	line.firstLexeme = (uint32_t)firstLexeme;
+	line.lexemeCount = (uint32_t)(lexemes.size() - firstLexeme);
+
+	// Mark end of line, unless a comment or string continues on the next line
+	if (state == Line_State::NORMAL && tokens.open_count()) {
+		size_t last = tokens.size() - 1;
+		const uint32_t lineEnd = lineBegin + (uint32_t)text.length();
+
+		// If a backslash is the last token and last lexeme (line continuation
+		// mark), remove the token and do not place a EOL token
+		if (tokens.types[last] == Token_Type::OPERATOR &&
+			tokens.subtypes[last].op == Operator_Type::BACK_SLASH &&
+			tokens.offsets[last] + tokens.lengths[last] == lineEnd) {
+			tokens.pop_back();
+		}
+		// Mark the end of the line (equivalent to a ; in C++)
+		else {
+			tokens.push_back({ lineEnd, 0, Token_Type::EOL, 0 });
+			tokens.end_statement();
+		}
+	}
+	line.state = state;
+	line.openStatement = tokens.open_count() != 0;
+}
 
-			// Check for double quote string literal
-			bool nextLine = false;
-			newIndex = scan_string_double_quote(code[i], index, nextLine);
-			if (newIndex != index) {
-				tok.lexeme = (uint32_t)results.lines[i].lexemes.size();
-				tok.lineNumber = (uint32_t)i;
-				tok.type = Token_Type::STRING;
-				tok.subtype.str = String_Type::DOUBLE;
-				toks.push_back(tok);
-				results.lines[i].lexemes.push_back({ index, newIndex });
-				index = newIndex;
-
-				// Check for line continuations
-				if (nextLine) {
-					i += 1;
-					for (; i < code.size(); ++i) {
-						if (code[i].length() == 0) {
-							index = 0;
-							break;
-						}
-						results.lines[i].text = code[i];
-						index = scan_string_end_quote(code[i], '"', nextLine);
-						tok.lexeme = 0;
-						tok.lineNumber = (uint32_t)i;
-						toks.push_back(tok);
-						results.lines[i].lexemes.push_back({ 0, index });
-						if (!nextLine) break;
-					}
-				}
-				continue;
+
+// Ends the literal and the statement left open at the end of the file, the
+// EOL token is placed at sourceLength.
+static void end_file(uint32_t sourceLength, Open_Literal& literal, Token_Table& tokens, String_Pool& strings) {
+	if (literal.pieces) {
+		end_literal(literal, tokens, strings);
+	}
+	if (tokens.open_count()) {
+		tokens.push_back({ sourceLength, 0, Token_Type::EOL, 0 });
+		tokens.end_statement();
+	}
+}
+
+
+// Scans a range of lines starting from the NORMAL state with no open statement.
+// Errors are stored in the results.
+static void scan_chunk(const Source_Buffer& source, std::vector<Line>& lines, Chunk_Results& chunk,
+	Symbol_Table& symbols, Constant_Pool& constants, String_Pool& strings) noexcept {
+	try {
+		const size_t bytes = source.line_begin(chunk.last - 1) - source.line_begin(chunk.first);
+		chunk.lexemes.reserve(bytes / 4);
+		chunk.tokens.reserve(bytes / 8);
+		for (size_t i = chunk.first; i < chunk.last; ++i) {
+			scan_line(source.line(i), source.line_begin(i), chunk.state, chunk.literal, lines[i], chunk.lexemes, chunk.tokens,
+				symbols, constants, strings);
+		}
+	}
+	catch (...) {
+		chunk.error = std::current_exception();
+	}
+}
+
+
+// Splits the lines into chunks of roughly equal size in bytes, each holding
+// at least minBytes unless there is only one. Chunks start at the beginning
+// of a line.
+static std::vector<Chunk_Results> split_chunks(const Source_Buffer& source, uint32_t threads, uint32_t minBytes) {
+	const size_t lineCount = source.line_count();
+	const uint32_t bytes = (uint32_t)source.text().length();
+	uint32_t count = std::max<uint32_t>(1, std::min(threads, bytes / minBytes));
+
+	std::vector<Chunk_Results> chunks{};
+	size_t first = 0;
+	for (uint32_t c = 1; c <= count && first < lineCount; ++c) {
+		size_t last = lineCount;
+		if (c != count) {
+			uint32_t offset = (uint32_t)((uint64_t)bytes * c / count);
+			last = std::max(first + 1, source.line_of(offset) + 1);
+			last = std::min(last, lineCount);
+		}
+		chunks.emplace_back();
+		chunks.back().first = first;
+		chunks.back().last = last;
+		first = last;
+	}
+	return chunks;
+}
+
+
+// Gets the first statement whose EOL token is at or after an offset, which
+// is the first statement ending on or after the line starting at the offset.
+static size_t find_statement(const Token_Table& tokens, size_t begin, uint32_t offset) {
+	auto it = std::lower_bound(tokens.statementEnds.begin() + begin, tokens.statementEnds.end(), offset,
+		[&](uint32_t end, uint32_t o) {
+			return tokens.offsets[end - 1] < o;
+		});
+	return it - tokens.statementEnds.begin();
+}
+
+
+// Replaces count items of a vector at index with the replacement items. Only
+// the difference in size moves the items that follow.
+template <typename T>
+static void splice(std::vector<T>& v, size_t index, size_t count, std::vector<T>& replacement) {
+	size_t common = std::min(count, replacement.size());
+	std::move(replacement.begin(), replacement.begin() + common, v.begin() + index);
+	if (count > common) {
+		v.erase(v.begin() + index + common, v.begin() + index + count);
+	}
+	else {
+		v.insert(v.begin() + index + common,
+			std::make_move_iterator(replacement.begin() + common), std::make_move_iterator(replacement.end()));
+	}
+}
+
+
+// A bracket operator by the type of its single form, the levels it opens or
+// closes and whether it opens. Other operators have no levels.
+struct Bracket {
+	Operator_Type kind = Operator_Type::OPEN_PAREN;
+	uint32_t levels = 0;
+	bool open = false;
+};
+
+
+// A bracket still open while matching.
+struct Open_Bracket {
+	uint32_t token = 0;
+	Operator_Type kind = Operator_Type::OPEN_PAREN;
+	uint32_t levels = 1;
+};
+
+
+// Gets an operator as a bracket, with no levels if it is not one.
+static inline Bracket bracket_of(Operator_Type op) noexcept {
+	switch (op) {
+	case Operator_Type::OPEN_PAREN: return { Operator_Type::OPEN_PAREN, 1, true };
+	case Operator_Type::OPEN_SQUARE: return { Operator_Type::OPEN_SQUARE, 1, true };
+	case Operator_Type::OPEN_ATTRIBUTE: return { Operator_Type::OPEN_SQUARE, 2, true };
+	case Operator_Type::OPEN_CURLY: return { Operator_Type::OPEN_CURLY, 1, true };
+	case Operator_Type::CLOSED_PAREN: return { Operator_Type::OPEN_PAREN, 1, false };
+	case Operator_Type::CLOSED_SQUARE: return { Operator_Type::OPEN_SQUARE, 1, false };
+	case Operator_Type::CLOSED_ATTRIBUTE: return { Operator_Type::OPEN_SQUARE, 2, false };
+	case Operator_Type::CLOSED_CURLY: return { Operator_Type::OPEN_CURLY, 1, false };
+	default: return {};
+	}
+}
+
+
+// Matches bracket token i against the stack of brackets still open. A [[
+// counts as two square brackets, closed together by ]] or one at a time by
+// ]. A ]] may likewise close two [. A closing bracket that does not match the
+// top of the stack closes the nearest open bracket of its kind and the
+// brackets above that one are left unclosed. With no open bracket of its
+// kind, the closing bracket is unmatched and the stack is kept. Partners are
+// passed to partner(token, partner) and unmatched brackets to
+// unmatched(token). Returns the depth below which the stack is unchanged.
+template <typename Partner, typename Unmatched>
+static inline size_t match_bracket(uint32_t i, Bracket bracket, std::vector<Open_Bracket>& stack, Partner&& partner,
+	Unmatched&& unmatched) {
+	size_t low = stack.size();
+	if (bracket.open) {
+		stack.push_back({ i, bracket.kind, bracket.levels });
+		return low;
+	}
+	const Operator_Type kind = bracket.kind;
+	uint32_t levels = bracket.levels;
+
+	// Find the nearest open bracket of the same kind
+	size_t top = stack.size();
+	while (top > 0 && stack[top - 1].kind != kind) {
+		top -= 1;
+	}
+	if (top == 0) {
+		unmatched(i);
+		return low;
+	}
+	for (size_t j = top; j < stack.size(); ++j) {
+		unmatched(stack[j].token);
+	}
+	stack.resize(top);
+
+	// Close as many levels as the closing bracket holds, its partner is the
+	// outermost bracket it reached
+	while (levels > 0 && !stack.empty() && stack.back().kind == kind) {
+		Open_Bracket& o = stack.back();
+		low = stack.size() - 1;
+		uint32_t taken = std::min(levels, o.levels);
+		o.levels -= taken;
+		levels -= taken;
+		partner(i, o.token);
+		if (o.levels == 0) {
+			partner(o.token, i);
+			stack.pop_back();
+		}
+	}
+	if (levels > 0) {
+		unmatched(i);
+	}
+	return low;
+}
+
+
+// Finds the partner of every bracket, see match_bracket().
+static void match_brackets(const Token_Table& tokens, Bracket_Index& brackets) {
+	std::vector<Open_Bracket> stack{};
+	brackets.partners.assign(tokens.size(), Bracket_Index::NO_PARTNER);
+	brackets.unmatched.clear();
+	auto partner = [&](uint32_t token, uint32_t p) { brackets.partners[token] = p; };
+	auto unmatched = [&](uint32_t token) { brackets.unmatched.push_back(token); };
+	for (uint32_t i = 0; i < (uint32_t)tokens.size(); ++i) {
+		if (tokens.types[i] != Token_Type::OPERATOR) {
+			continue;
+		}
+		const Bracket bracket = bracket_of(tokens.subtypes[i].op);
+		if (bracket.levels != 0) {
+			match_bracket(i, bracket, stack, partner, unmatched);
+		}
+	}
+	for (const Open_Bracket& o : stack) {
+		brackets.unmatched.push_back(o.token);
+	}
+	std::sort(brackets.unmatched.begin(), brackets.unmatched.end());
+}
+
+
+// Matches the brackets again after old tokens [begin, end) are replaced by
+// added, before the tokens are spliced. The stack of brackets open before
+// begin is rebuilt by walking back from begin, each closing bracket skipping
+// to its partner. The old and new tokens are matched from that stack, then
+// the tokens after the edit are matched against both stacks in step until
+// they hold the same brackets again. The tokens after that keep their
+// partners, moved by the difference in tokens. Sets matchedEnd to the end of
+// the new tokens whose brackets were matched again. The brackets before
+// begin that became or stopped being unmatched are added to toggled. Returns
+// false, leaving the brackets unchanged, if the stacks still differ
+// MAX_REMATCH tokens after the edit, as an edit that leaves a bracket open
+// or closes one changes every bracket after it and a full match is cheaper.
+static bool rematch_brackets(const Token_Table& tokens, uint32_t begin, uint32_t end, const Token_Table& added,
+	Bracket_Index& brackets, uint32_t& matchedEnd, std::vector<uint32_t>& toggled) {
+	static constexpr uint32_t MAX_REMATCH = 64 * 1024;
+	static constexpr uint32_t NO_PARTNER = Bracket_Index::NO_PARTNER;
+	std::vector<uint32_t>& partners = brackets.partners;
+	const uint32_t oldSize = (uint32_t)tokens.size();
+	const uint32_t shift = (uint32_t)added.size() - (end - begin);
+
+	// Rebuild the stack open before begin. A closing bracket whose partner
+	// is still open took one level of a [[
+	std::vector<Open_Bracket> before{};
+	uint32_t partial = NO_PARTNER;
+	for (uint32_t i = begin; i-- > 0;) {
+		if (tokens.types[i] != Token_Type::OPERATOR) {
+			continue;
+		}
+		const Bracket bracket = bracket_of(tokens.subtypes[i].op);
+		if (bracket.levels == 0) {
+			continue;
+		}
+		if (bracket.open) {
+			before.push_back({ i, bracket.kind, (i == partial) ? 1 : bracket.levels });
+			continue;
+		}
+		const uint32_t p = partners[i];
+		if (p == NO_PARTNER) {
+			continue;
+		}
+		if (partners[p] != i) {
+			partial = p;
+			i = p + 1;
+		}
+		else {
+			i = p;
+		}
+	}
+	std::reverse(before.begin(), before.end());
+
+	// Match the old and new tokens, the depth of the stacks they share is
+	// tracked until both stacks are the same
+	std::vector<Open_Bracket> oldStack = before;
+	std::vector<Open_Bracket> newStack = before;
+	size_t common = before.size();
+	std::vector<uint32_t> rangePartners{};
+	std::vector<std::pair<uint32_t, uint32_t>> beforePartners{};
+	std::vector<uint32_t> rangeUnmatched{};
+	auto ignore_partner = [](uint32_t, uint32_t) {};
+	auto ignore_unmatched = [](uint32_t) {};
+	auto partner = [&](uint32_t token, uint32_t p) {
+		if (token >= begin) {
+			rangePartners[token - begin] = p;
+		}
+		else {
+			beforePartners.push_back({ token, p });
+		}
+	};
+	auto unmatched = [&](uint32_t token) { rangeUnmatched.push_back(token); };
+	for (uint32_t i = begin; i < end; ++i) {
+		if (tokens.types[i] != Token_Type::OPERATOR) {
+			continue;
+		}
+		const Bracket bracket = bracket_of(tokens.subtypes[i].op);
+		if (bracket.levels != 0) {
+			common = std::min(common, match_bracket(i, bracket, oldStack, ignore_partner, ignore_unmatched));
+		}
+	}
+	for (uint32_t i = 0; i < (uint32_t)added.size(); ++i) {
+		rangePartners.push_back(NO_PARTNER);
+		if (added.types[i] != Token_Type::OPERATOR) {
+			continue;
+		}
+		const Bracket bracket = bracket_of(added.subtypes[i].op);
+		if (bracket.levels != 0) {
+			common = std::min(common, match_bracket(begin + i, bracket, newStack, partner, unmatched));
+		}
+	}
+	uint32_t next = end;
+	while (next < oldSize && !(common == oldStack.size() && common == newStack.size())) {
+		if (next - end == MAX_REMATCH) {
+			return false;
+		}
+		rangePartners.push_back(NO_PARTNER);
+		const Bracket bracket = (tokens.types[next] == Token_Type::OPERATOR) ?
+			bracket_of(tokens.subtypes[next].op) : Bracket{};
+		if (bracket.levels != 0) {
+			common = std::min(common, match_bracket(next, bracket, oldStack, ignore_partner, ignore_unmatched));
+			common = std::min(common, match_bracket(next + shift, bracket, newStack, partner, unmatched));
+		}
+		++next;
+	}
+	if (common != oldStack.size() || common != newStack.size()) {
+		for (const Open_Bracket& o : newStack) {
+			unmatched(o.token);
+		}
+		newStack.clear();
+	}
+
+	// Once the stacks agree they only hold brackets from before begin, as
+	// both are checked before each token. Those keep their partner, moved
+	// like the tokens after the edit. The others are given their new partners
+	auto moved = [&](uint32_t p) {
+		return (p != NO_PARTNER && p >= end) ? p + shift : p;
+	};
+	const size_t kept = newStack.size();
+	for (const Open_Bracket& o : newStack) {
+		partners[o.token] = moved(partners[o.token]);
+	}
+	for (size_t i = kept; i < before.size(); ++i) {
+		partners[before[i].token] = NO_PARTNER;
+	}
+	for (const auto& p : beforePartners) {
+		partners[p.first] = p.second;
+	}
+	matchedEnd = next + shift;
+	splice(partners, begin, next - begin, rangePartners);
+	if (shift != 0) {
+		uint32_t* p = partners.data();
+		for (size_t i = matchedEnd; i < partners.size(); ++i) {
+			p[i] += (p[i] >= end && p[i] != NO_PARTNER) ? shift : 0;
+		}
+	}
+
+	// Unmatched brackets before begin, with those closed or left open by the
+	// edit changed
+	std::vector<uint32_t>& oldUnmatched = brackets.unmatched;
+	std::sort(rangeUnmatched.begin(), rangeUnmatched.end());
+	const auto rangeFirst = std::lower_bound(rangeUnmatched.begin(), rangeUnmatched.end(), begin);
+	const auto oldFirst = std::lower_bound(oldUnmatched.begin(), oldUnmatched.end(), begin);
+	const auto oldLast = std::lower_bound(oldFirst, oldUnmatched.end(), next);
+	std::vector<uint32_t> unmatchedNow{};
+	std::vector<uint32_t> unmatchedBefore{};
+	unmatchedNow.reserve(oldUnmatched.size() + rangeUnmatched.size());
+	auto resolved = before.begin() + kept;
+	for (auto it = oldUnmatched.begin(); it != oldFirst; ++it) {
+		while (resolved != before.end() && resolved->token < *it) {
+			++resolved;
+		}
+		if (resolved != before.end() && resolved->token == *it) {
+			unmatchedBefore.push_back(*it);
+		}
+		else {
+			unmatchedNow.push_back(*it);
+		}
+	}
+	const size_t middle = unmatchedNow.size();
+	unmatchedNow.insert(unmatchedNow.end(), rangeUnmatched.begin(), rangeFirst);
+	std::inplace_merge(unmatchedNow.begin(), unmatchedNow.begin() + middle, unmatchedNow.end());
+	std::set_symmetric_difference(unmatchedBefore.begin(), unmatchedBefore.end(), rangeUnmatched.begin(), rangeFirst,
+		std::back_inserter(toggled));
+
+	// Unmatched brackets of the edit, then those after it moved
+	unmatchedNow.insert(unmatchedNow.end(), rangeFirst, rangeUnmatched.end());
+	for (auto it = oldLast; it != oldUnmatched.end(); ++it) {
+		unmatchedNow.push_back(*it + shift);
+	}
+	oldUnmatched.swap(unmatchedNow);
+	return true;
+}
+
+
+// Gets the message for an unmatched bracket. Opening brackets were never
+// closed, closing brackets closed nothing.
+static std::string bracket_problem(std::string_view text, const Token_Table& tokens, uint32_t i) {
+	std::string message = "'";
+	message += text.substr(tokens.offsets[i], tokens.lengths[i]);
+	switch (tokens.subtypes[i].op) {
+	case Operator_Type::OPEN_PAREN:
+	case Operator_Type::OPEN_SQUARE:
+	case Operator_Type::OPEN_ATTRIBUTE:
+	case Operator_Type::OPEN_CURLY:
+		message += "' is never closed.";
+		break;
+	default:
+		message += "' does not close an open bracket.";
+		break;
+	}
+	return message;
+}
+
+
+// Finds the /* of a block comment left open at the end of the file. The
+// lines inside the comment hold one lexeme at most and the line it opens on
+// ends with it. Returns UINT32_MAX if every block comment is closed.
+static uint32_t find_open_comment(const Source_Buffer& source, const std::vector<Line>& lines,
+	const std::vector<Lexeme>& lexemes) {
+	size_t i = lines.size();
+	if (i == 0 || lines[i - 1].state != Line_State::MULTILINE_COMMENT) {
+		return UINT32_MAX;
+	}
+	i -= 1;
+	while (i > 0 && lines[i - 1].state == Line_State::MULTILINE_COMMENT && lines[i].lexemeCount <= 1) {
+		i -= 1;
+	}
+	const Line& line = lines[i];
+	return source.line_begin(i) + lexemes[line.firstLexeme + line.lexemeCount - 1].begin;
+}
+
+
+// Finds the problems of tokens [begin, end) and of the text they span,
+// text[textBegin, textEnd): bytes that are not UTF-8, the problems of each
+// token alone (see token_problem()), the unmatched brackets [bracket,
+// bracketEnd) among the tokens and the block comment left open at
+// commentOffset, if it is in the text. Each is passed in offset order to
+// report(severity, offset, length, message).
+template <typename Report>
+static void find_problems(std::string_view text, const Token_Table& tokens, const Constant_Pool& constants,
+	uint32_t begin, uint32_t end, uint32_t textBegin, uint32_t textEnd, const uint32_t* bracket,
+	const uint32_t* bracketEnd, uint32_t commentOffset, Report&& report) {
+	// Bytes that are not UTF-8 are reported before the problems after them
+	uint32_t runEnd = 0;
+	uint32_t run = find_invalid_utf8(text, textBegin, textEnd, runEnd);
+	auto report_bytes = [&](uint32_t offset) {
+		while (run < offset && run < textEnd) {
+			report(Severity::ERROR, run, runEnd - run, "Invalid UTF-8.");
+			run = find_invalid_utf8(text, runEnd, textEnd, runEnd);
+		}
+	};
+
+	char quote = 0;
+	for (uint32_t i = begin; i < end; ++i) {
+		const Token_Type type = tokens.types[i];
+		if (type == Token_Type::ERROR || type == Token_Type::STRING || type == Token_Type::NUMBER) {
+			const Token tok = tokens.get(i);
+			const Token next = (i + 1 < tokens.size()) ? tokens.get(i + 1) : Token{};
+			const char* problem = token_problem(text, tok, (i + 1 < tokens.size()) ? &next : nullptr, quote,
+				constants);
+			if (problem) {
+				report_bytes(tok.offset);
+				report(Severity::ERROR, tok.offset, tok.length, problem);
 			}
+		}
+		else if (bracket != bracketEnd && *bracket == i) {
+			report_bytes(tokens.offsets[i]);
+			report(Severity::ERROR, tokens.offsets[i], tokens.lengths[i], bracket_problem(text, tokens, i));
+			++bracket;
+		}
+	}
+	if (commentOffset >= textBegin && commentOffset < textEnd) {
+		report_bytes(commentOffset);
+		report(Severity::ERROR, commentOffset, 2, "Block comment is never closed.");
+	}
+	report_bytes(textEnd);
+}
+
+
+// Reports every problem of the scanner results in offset order, replacing
+// the problems reported before. See find_problems().
+static void report_problems(const Source_Buffer& source, const Constant_Pool& constants,
+	Scanner_Results& results) {
+	results.diagnostics.clear();
+	const uint32_t* unmatched = results.brackets.unmatched.data();
+	find_problems(source.text(), results.tokens, constants, 0, (uint32_t)results.tokens.size(), 0,
+		results.sourceLength, unmatched, unmatched + results.brackets.unmatched.size(),
+		find_open_comment(source, results.lines, results.lexemes),
+		[&](Severity severity, uint32_t offset, uint32_t length, auto&& message) {
+			results.diagnostics.report(severity, offset, length, std::forward<decltype(message)>(message));
+		});
+}
 
-			// Check for single quote string literal
-			newIndex = scan_string_single_quote(code[i], index, nextLine);
-			if (newIndex != index) {
-				tok.lexeme = (uint32_t)results.lines[i].lexemes.size();
-				tok.lineNumber = (uint32_t)i;
-				tok.type = Token_Type::STRING;
-				tok.subtype.str = String_Type::SINGLE;
-				toks.push_back(tok);
-				results.lines[i].lexemes.push_back({ index, newIndex });
-				index = newIndex;
-
-				// Check for line continuations
-				if (nextLine) {
-					i += 1;
-					for (; i < code.size(); ++i) {
-						if (code[i].length() == 0) {
-							index = 0;
-							break;
-						}
-						results.lines[i].text = code[i];
-						index = scan_string_end_quote(code[i], '\'', nextLine);
-						tok.lexeme = 0;
-						tok.lineNumber = (uint32_t)i;
-						toks.push_back(tok);
-						results.lines[i].lexemes.push_back({ 0, index });
-						if (!nextLine) break;
+
+// Reports again the problems of tokens [begin, end) after rematch_brackets(),
+// and of the text they span from lineBegin on if that is before them,
+// replacing those at offsets [offsetBegin, offsetEnd) before the edit and
+// moving the problems after them by shift. The brackets before begin in
+// toggled have their problem added or removed. A block comment left open at
+// the end of the file is not reported. Returns false if the problems must be
+// reported in full, see Diagnostics::replace().
+static bool update_problems(std::string_view text, const Token_Table& tokens, const Constant_Pool& constants,
+	const Bracket_Index& brackets, uint32_t begin, uint32_t end, uint32_t lineBegin, uint32_t offsetBegin,
+	uint32_t offsetEnd, uint32_t shift, const std::vector<uint32_t>& toggled, Diagnostics& diagnostics) {
+	const std::vector<uint32_t>& unmatched = brackets.unmatched;
+	std::vector<Diagnostic> problems{};
+	for (uint32_t t : toggled) {
+		problems.clear();
+		if (std::binary_search(unmatched.begin(), unmatched.end(), t)) {
+			problems.push_back({ Severity::ERROR, tokens.offsets[t], tokens.lengths[t],
+				bracket_problem(text, tokens, t) });
+		}
+		if (!diagnostics.replace(tokens.offsets[t], tokens.offsets[t] + 1, 0, problems)) {
+			return false;
+		}
+	}
+	problems.clear();
+	const uint32_t textLength = (uint32_t)text.length();
+	const uint32_t textBegin = std::min(lineBegin, (begin < tokens.size()) ? tokens.offsets[begin] : textLength);
+	const uint32_t textEnd = (end < tokens.size()) ? tokens.offsets[end] : textLength;
+	const auto first = std::lower_bound(unmatched.begin(), unmatched.end(), begin);
+	const auto last = std::lower_bound(first, unmatched.end(), end);
+	find_problems(text, tokens, constants, begin, end, textBegin, textEnd,
+		unmatched.data() + (first - unmatched.begin()), unmatched.data() + (last - unmatched.begin()), UINT32_MAX,
+		[&](Severity severity, uint32_t offset, uint32_t length, auto&& message) {
+			problems.push_back({ severity, offset, length, std::string(std::forward<decltype(message)>(message)) });
+		});
+	return diagnostics.replace(offsetBegin, offsetEnd, shift, problems);
+}
+
+
+// Scans input text into results, reusing their memory. With a pool, the text
+// is split into chunks that are scanned in parallel. Each chunk assumes it
+// starts outside of any comment, string or statement. The chunks are then
+// joined in order and any chunk where that guess was wrong is scanned again
+// from the correct state, up to the first line where both scans agree.
+// Brackets are matched once every token is known.
+//
+// Error Handling:
+//	+ Unrecognized characters and bytes that are not UTF-8 become ERROR
+//	  tokens and scanning carries on. They are reported in
+//	  results.diagnostics with unmatched brackets, string literals and
+//	  block comments never closed and numbers too large for their type.
+//	+ Throws std::length_error if a pool is full. The results are left
+//	  partly filled in that case.
+void Scanner::scan(const Source_Buffer& source, Scanner_Results& results, Thread_Pool* pool) const {
+	const size_t lineCount = source.line_count();
+	results.lines.assign(lineCount, Line{});
+	results.lexemes.clear();
+	results.tokens.clear();
+	results.sourceLength = (uint32_t)source.text().length();
+	Line_State state = Line_State::NORMAL;
+	Open_Literal literal{};
+
+	// Single threaded
+	if (!pool || pool->size() < 2) {
+		results.lexemes.reserve(source.text().length() / 4);
+		results.tokens.reserve(source.text().length() / 8);
+		for (size_t i = 0; i < lineCount; ++i) {
+			scan_line(source.line(i), source.line_begin(i), state, literal, results.lines[i], results.lexemes,
+				results.tokens, *symbols, *constants, *strings);
+		}
+	}
+	else {
+		// Scan all chunks from an assumed state
+		std::vector<Chunk_Results> chunks = split_chunks(source, pool->size(), minChunkBytes);
+		pool->run(chunks.size(), [&](size_t c) {
+			scan_chunk(source, results.lines, chunks[c], *symbols, *constants, *strings);
+		});
+
+		// Join the chunks in order
+		size_t lexemeCount = 0;
+		size_t tokenCount = 0;
+		for (const auto& chunk : chunks) {
+			lexemeCount += chunk.lexemes.size();
+			tokenCount += chunk.tokens.size();
+		}
+		results.lexemes.reserve(lexemeCount);
+		results.tokens.reserve(tokenCount + 1);
+		for (auto& chunk : chunks) {
+			size_t sync = chunk.first;
+
+			// The chunk did not start from the assumed state, rescan its lines
+			// until the state matches the first scan again
+			if (state != Line_State::NORMAL || results.tokens.open_count()) {
+				sync = chunk.last;
+				for (size_t i = chunk.first; i < chunk.last; ++i) {
+					Line& line = results.lines[i];
+					Line_State guessState = line.state;
+					bool guessOpen = line.openStatement;
+					scan_line(source.line(i), source.line_begin(i), state, literal, line, results.lexemes,
+						results.tokens, *symbols, *constants, *strings);
+					if (!chunk.error && state == guessState && !guessOpen && !results.tokens.open_count()) {
+						sync = i + 1;
+						break;
 					}
 				}
+			}
+			if (sync == chunk.last && sync != chunk.first) {
 				continue;
 			}
 
-			// Check for operators
-			newIndex = scan_operator(code[i], index, operators, tok.subtype.op);
-			if (newIndex != index) {
-				tok.lexeme = (uint32_t)results.lines[i].lexemes.size();
-				tok.lineNumber = (uint32_t)i;
-				tok.type = Token_Type::OPERATOR;
-				toks.push_back(tok);
-				results.lines[i].lexemes.push_back({ index, newIndex });
-				index = newIndex;
-				continue;
+			// The rest of the first scan is correct
+			if (chunk.error) {
+				std::rethrow_exception(chunk.error);
+			}
+			const uint32_t lexemeBegin = results.lines[sync].firstLexeme;
+			const uint32_t shift = (uint32_t)results.lexemes.size() - lexemeBegin;
+			for (size_t i = sync; i < chunk.last; ++i) {
+				results.lines[i].firstLexeme += shift;
 			}
+			results.lexemes.insert(results.lexemes.end(), chunk.lexemes.begin() + lexemeBegin, chunk.lexemes.end());
+			results.tokens.append(chunk.tokens, find_statement(chunk.tokens, 0, source.line_begin(sync)));
+			state = chunk.state;
+			literal = std::move(chunk.literal);
+			chunk.lexemes = std::vector<Lexeme>{};
+			chunk.tokens = Token_Table{};
+		}
+	}
+	end_file(results.sourceLength, literal, results.tokens, *strings);
+	match_brackets(results.tokens, results.brackets);
+	report_problems(source, *constants, results);
+}
 
 
-			// Check for a word
-			newIndex = scan_word(code[i], index);
-			if (newIndex != index) {
-				tok.lexeme = (uint32_t)results.lines[i].lexemes.size();
-				tok.lineNumber = (uint32_t)i;
-				Lexeme lex{ index,newIndex };
-				tok.subtype.hash = hash_text(code[i], lex);
-				auto key = keywords.find(tok.subtype.hash);
-				if (key != keywords.end()) {
-					if (match_text(code[i], lex, key->second.text)) {
-						tok.type = Token_Type::KEYWORD;
-						tok.subtype.key = key->second.type;
-					}
-					else {
-						tok.type = Token_Type::WORD;
-					}
-				}
-				else {
-					tok.type = Token_Type::WORD;
-				}
-				toks.push_back(tok);
-				results.lines[i].lexemes.push_back(lex);
-				index = newIndex;
-				continue;
-			}
+// Scans a batch of inputs, results[i] gets the results of sources[i].
+// Given a thread pool, each thread scans whole inputs, which suits many
+// small inputs better than splitting each into chunks. results is resized
+// to the number of inputs, the memory of entries already present is
+// reused.
+//
+// Error Handling:
+//	+ Problems in an input are reported in the diagnostics of its results,
+//	  see scan().
+//	+ Throws std::length_error if a pool is full. Every input is scanned
+//	  first, then the error of the first failed input is thrown. The results
+//	  of the other inputs are complete.
+void Scanner::scan_batch(const std::vector<Source_Buffer>& sources, std::vector<Scanner_Results>& results,
+	Thread_Pool* pool) const {
+	results.resize(sources.size());
+	std::vector<std::exception_ptr> errors(sources.size());
+	auto task = [&](size_t i) {
+		try {
+			scan(sources[i], results[i]);
+		}
+		catch (...) {
+			errors[i] = std::current_exception();
+		}
+	};
+	if (pool && pool->size() > 1) {
+		pool->run(sources.size(), task);
+	}
+	else {
+		for (size_t i = 0; i < sources.size(); ++i) {
+			task(i);
+		}
+	}
+	for (const auto& error : errors) {
+		if (error) {
+			std::rethrow_exception(error);
+		}
+	}
+}
+
 
-			// Should never be reached.
-			throw std::runtime_error("Scanner failed.");
-			system("pause");
+// Updates the results of scan() after lines [first, first + removed) were
+// replaced by inserted lines (see Source_Buffer::replace_lines). Scanning
+// starts at the statement open before the edit and stops at the first
+// line after the edit where the scanner state matches the previous
+// results. The new lines and statements are spliced into results. Brackets
+// are matched again only up to where the brackets left open agree with the
+// previous results, and only the problems up to there are reported again.
+//
+// Error Handling:
+//	+ Problems are reported in results.diagnostics, see scan().
+//	+ Throws std::length_error if a pool is full. The results are left
+//	  unchanged in that case.
+void Scanner::rescan(const Source_Buffer& source, size_t first, size_t removed, size_t inserted,
+	Scanner_Results& results) const {
+	const size_t lineCount = source.line_count();
+	const size_t oldLast = first + removed;
+	Token_Table& tokens = results.tokens;
+
+	// Rebuild the statement left open before the edit from the line it began on
+	size_t start = first;
+	while (start > 0 && results.lines[start - 1].openStatement) {
+		start -= 1;
+	}
+	Line_State state = (start > 0) ? results.lines[start - 1].state : Line_State::NORMAL;
+	Open_Literal literal{};
+	Token_Table added{};
+	std::vector<Lexeme> lexemes{};
+	Line scratch{};
+	for (size_t i = start; i < first; ++i) {
+		scan_line(source.line(i), source.line_begin(i), state, literal, scratch, lexemes, added, *symbols, *constants,
+			*strings);
+		lexemes.clear();
+	}
+
+	// Scan the inserted lines, then continue past the edit until the state
+	// matches the previous results
+	std::vector<Line> lines(inserted);
+	size_t sync = lineCount;
+	Line_State oldState = results.lines[oldLast - 1].state;
+	bool oldOpen = results.lines[oldLast - 1].openStatement;
+	for (size_t i = first; i < lineCount; ++i) {
+		const size_t n = i - first;
+		if (n >= inserted) {
+			const Line& old = results.lines[oldLast + n - inserted];
+			oldState = old.state;
+			oldOpen = old.openStatement;
+			lines.emplace_back();
 		}
+		scan_line(source.line(i), source.line_begin(i), state, literal, lines[n], lexemes, added, *symbols, *constants,
+			*strings);
+		if (n + 1 >= inserted && state == oldState && !oldOpen && !added.open_count()) {
+			sync = i + 1;
+			break;
+		}
+	}
+	const uint32_t sourceLength = (uint32_t)source.text().length();
+	if (sync == lineCount) {
+		end_file(sourceLength, literal, added, *strings);
+	}
 
-		// Mark end of line
-		if (toks.size()) {
-			auto& lastTok = toks.back();
+	// Statements from the open one before the edit to the line where the
+	// state matched are replaced
+	const size_t oldSync = sync + removed - inserted;
+	const size_t removedLines = oldSync - first;
+	const uint32_t offsetShift = sourceLength - results.sourceLength;
+	const size_t firstStatement = find_statement(tokens, 0, source.line_begin(first));
+	const size_t lastStatement = (sync == lineCount) ? tokens.statement_count() :
+		find_statement(tokens, firstStatement, source.line_begin(sync) - offsetShift);
+	const uint32_t tokenBegin = tokens.statement_begin(firstStatement);
+	const uint32_t tokenEnd = tokens.statement_begin(lastStatement);
+	const uint32_t tokenShift = (uint32_t)added.size() - (tokenEnd - tokenBegin);
+
+	// Match the brackets again from the edit up to where the brackets open
+	// agree with the previous results, before the old tokens are replaced
+	const uint32_t oldTokens = (uint32_t)tokens.size();
+	std::vector<uint32_t> toggled{};
+	uint32_t matchedEnd = 0;
+	uint32_t problemsBegin = 0;
+	uint32_t problemsEnd = 0;
+	const bool matched = results.brackets.partners.size() == oldTokens
+		&& rematch_brackets(tokens, tokenBegin, tokenEnd, added, results.brackets, matchedEnd, toggled);
+	const uint32_t lineBegin = source.line_begin(first);
+	if (matched) {
+		const uint32_t oldMatchedEnd = matchedEnd - tokenShift;
+		problemsBegin = std::min(lineBegin, (tokenBegin < oldTokens) ? tokens.offsets[tokenBegin] :
+			results.sourceLength);
+		problemsEnd = (oldMatchedEnd < oldTokens) ? tokens.offsets[oldMatchedEnd] : UINT32_MAX;
+	}
+	const bool openComment = results.lines.back().state == Line_State::MULTILINE_COMMENT;
 
-			// If a backslash is the last token and last lexeme (line continuation
-			// mark), remove the token and do not place a EOL token
-			if (lastTok.type == Token_Type::OPERATOR &&
-				lastTok.subtype.op == Operator_Type::BACK_SLASH &&
-				(lastTok.lexeme + 1) == results.lines[i].lexemes.size()) {
-				toks.pop_back();
-			}
-			// Mark the end of the line (equivalent to a ; in C++)
-			else if (lastTok.type != Token_Type::EOL) {
-				toks.push_back({ (uint32_t)i, 0, Token_Type::EOL, 0 });
-				results.tokens.push_back(std::move(toks));
-			}
+	// Move the statements after the edit
+	if (offsetShift != 0) {
+		for (size_t i = tokenEnd; i < tokens.size(); ++i) {
+			tokens.offsets[i] += offsetShift;
+		}
+	}
+	if (tokenShift != 0) {
+		for (size_t i = lastStatement; i < tokens.statement_count(); ++i) {
+			tokens.statementEnds[i] += tokenShift;
+		}
+	}
+	for (auto& end : added.statementEnds) {
+		end += tokenBegin;
+	}
+
+	// Move the lexemes of the lines after the edit
+	const uint32_t lexemeBegin = results.lines[first].firstLexeme;
+	const Line& lastRemoved = results.lines[oldSync - 1];
+	const uint32_t lexemeEnd = lastRemoved.firstLexeme + lastRemoved.lexemeCount;
+	const uint32_t lexemeShift = (uint32_t)lexemes.size() - (lexemeEnd - lexemeBegin);
+	if (lexemeShift != 0) {
+		for (size_t i = oldSync; i < results.lines.size(); ++i) {
+			results.lines[i].firstLexeme += lexemeShift;
 		}
 	}
+	for (auto& line : lines) {
+		line.firstLexeme += lexemeBegin;
+	}
+
+	// Splice
+	splice(results.lexemes, lexemeBegin, lexemeEnd - lexemeBegin, lexemes);
+	const size_t tokenCount = tokenEnd - tokenBegin;
+	splice(tokens.types, tokenBegin, tokenCount, added.types);
+	splice(tokens.subtypes, tokenBegin, tokenCount, added.subtypes);
+	splice(tokens.offsets, tokenBegin, tokenCount, added.offsets);
+	splice(tokens.lengths, tokenBegin, tokenCount, added.lengths);
+	splice(tokens.statementEnds, firstStatement, lastStatement - firstStatement, added.statementEnds);
+	splice(results.lines, first, removedLines, lines);
+	results.sourceLength = sourceLength;
+	if (!matched) {
+		match_brackets(tokens, results.brackets);
+	}
 
-	// Check for unpushed line
-	if (toks.size() != 0) {
-		toks.push_back({ (uint32_t)results.lines.size(), 0, Token_Type::EOL, 0 });
-		results.tokens.push_back(std::move(toks));
+	// A block comment left open at the end of the file is reported in full
+	if (!matched || openComment || results.lines.back().state == Line_State::MULTILINE_COMMENT
+		|| !update_problems(source.text(), tokens, *constants, results.brackets, tokenBegin, matchedEnd, lineBegin,
+		problemsBegin, problemsEnd, offsetShift, toggled, results.diagnostics)) {
+		report_problems(source, *constants, results);
 	}
-	return results;
 }
 
 
@@ -10,8 +10,18 @@
 #include <algorithm>
 #include <cstdint>
 #include <string>
+#include <string_view>
 #include <vector>
 
+// Internal
+#include "Constant_Pool.h"
+#include "Diagnostics.h"
+#include "Source_Buffer.h"
+#include "String_Pool.h"
+#include "Symbol_Table.h"
+#include "Thread_Pool.h"
+#include "Vocabulary.h"
+
 
 // Position of a lexical element in the source code.
 struct Lexeme {
@@ -20,157 +30,393 @@ struct Lexeme {
 };
 
 
-// Current recognized tokens; will increase with time.
-enum class Token_Type : uint32_t {
-	EOL,		// End of Line - no text
-	KEYWORD,
-	NUMBER,
-	OPERATOR,
-	STRING,
-	WORD
+// Current recognized tokens; will increase with time. See Vocabulary.h.
+enum class Token_Type : uint8_t {
+	TOKEN_TYPE_LIST(VOCABULARY_ENUMERATOR)
 };
 
 
-// Keywords
+// Keywords, see Vocabulary.h.
 enum class Keyword_Type : uint32_t {
-	// Types
-	I8,
-	I16,
-	I32,
-	I64,
-	U8,
-	U16,
-	U32,
-	U64,
-	F16,
-	F32,
-	F64,
-
-	// Data
-	CLASS,
-	LET,
-	SELF,
-	STRUCT,
-	VAR,
-
-	// Functional
-	CREF,
-	FN,
-	MOVE,
-	REF,
-	RETURN,
-
-	// Other
-	NAMESPACE
+	KEYWORD_LIST(VOCABULARY_ENUMERATOR)
 };
 
 
-// Numeric constants
-enum class Number_Type : uint32_t {
-	BINARY,
-	DECIMAL,
-	HEX,
-	INTEGER
+// Operators, see Vocabulary.h.
+enum class Operator_Type : uint32_t {
+	OPERATOR_LIST(VOCABULARY_ENUMERATOR)
+	UNSUPPORTED_OPERATOR,		// Any operator that does not match a pattern
 };
 
 
-// String literals
-enum class String_Type : uint32_t {
-	DOUBLE,						// "
-	SINGLE						// '
+// Meaning of a token within its type.
+union Token_Subtype {
+	uint32_t symbol = 0;		// ID of a WORD in the Symbol_Table
+	Keyword_Type key;
+	uint32_t constant;			// Index of a NUMBER in the Constant_Pool
+	Operator_Type op;
+	uint32_t literal;			// Index of a STRING in the String_Pool
 };
 
 
-// Operators
-enum class Operator_Type : uint32_t {
-	ACCESSOR,					// .
-	ARROW,						// ->
-	ASTERISK,					// *
-	BACK_SLASH,					// \ 
-	BITWISE_AND,				// &
-	BITWISE_AND_EQUAL,			// &=
-	BITWISE_NOT,				// ~
-	BITWISE_OR,					// |
-	BITWISE_OR_EQUAL,			// |=
-	BITWISE_XOR,				// ^
-	BITWISE_XOR_EQUAL,			// ^=
-	CLOSED_ATTRIBUTE,			// ]]
-	CLOSED_CURLY,				// }
-	CLOSED_PAREN,				// )
-	CLOSED_SQUARE,				// ]
-	COLON,						// :
-	COMMA,						// ,
-	DECREMENT,					// --
-	DIVIDE,						// /
-	DIVIDE_EQUALS,				// /=
-	EQUALS,						// =
-	EQUALS_TO,					// ==
-	GREATER,					// >
-	GREATER_EQUAL,				// >=
-	INCREMENT,					// ++
-	LEFT_SHIFT,					// <<
-	LEFT_SHIFT_EQUAL,			// <<=
-	LESS,						// <
-	LESS_EQUAL,					// <=
-	LOGICAL_AND,				// &&
-	LOGICAL_NOT,				// !
-	LOGICAL_OR,					// ||
-	LOGICAL_XOR,				// ^^
-	MACRO,						// #
-	MATCH_CASE,					// =>
-	MINUS,						// -
-	MINUS_EQUAL,				// -=
-	MODULO,						// %
-	MODULO_EQUAL,				// %=
-	MULTIPLY_EQUAL,				// *=
-	NOT_EQUAL,					// !=
-	OPEN_ATTRIBUTE,				// [[
-	OPEN_CURLY,					// {
-	OPEN_PAREN,					// (
-	OPEN_SQUARE,				// [
-	PLUS,						// +
-	PLUS_EQUAL,					// +=
-	RIGHT_SHIFT,				// >>
-	RIGHT_SHIFT_EQUAL,			// >>=
-	SCOPE,						// ::
-	SEMICOLON,					// ;
-	TERNARY,					// ?
-	THREE_WAY_COMP,				// <=>
-	UNSUPPORTED_OPERATOR,		// Any operator that does not match a pattern
+// Text with contextual meaning. The text is found by its offset in the
+// Source_Buffer, the line and column are only worked out when needed (see
+// Source_Buffer::location). An EOL token is placed at the end of its line's
+// text with a length of 0.
+struct Token {
+	uint32_t offset = 0;
+	uint32_t length = 0;
+	Token_Type type;
+	Token_Subtype subtype;
 };
 
 
-// Text with contextual meaning.
-struct Token {
-	uint32_t lineNumber = 0;
-	uint32_t lexeme = 0;
-	Token_Type type;
-	union {
-		uint32_t hash = 0;
-		Keyword_Type key;
-		Number_Type num;
-		Operator_Type op;
-		String_Type str;
-	} subtype;
+// Gets the text of a token. The view is valid until the buffer is modified.
+//
+// Error Handling:
+//	+ Never throws. The token must come from the buffer.
+inline std::string_view token_text(const Source_Buffer& source, const Token& tok) noexcept {
+	return source.text().substr(tok.offset, tok.length);
+}
+
+
+// Tokens of a file stored as parallel arrays, one entry per token. Statements
+// are consecutive runs of tokens that end with an EOL token. Tokens after the
+// last statement end belong to a statement that is still open.
+//
+// Fields:
+//	+ types: Type of every token, one byte each.
+//	+ subtypes: Subtype of every token.
+//	+ offsets: Offset of every token in the source buffer.
+//	+ lengths: Length of every token's text.
+//	+ statementEnds: One past the last token of every statement.
+struct Token_Table {
+	std::vector<Token_Type> types{};
+	std::vector<Token_Subtype> subtypes{};
+	std::vector<uint32_t> offsets{};
+	std::vector<uint32_t> lengths{};
+	std::vector<uint32_t> statementEnds{};
+
+
+	// Gets the number of tokens.
+	//
+	// Error Handling:
+	//	+ Never throws.
+	size_t size() const noexcept {
+		return types.size();
+	}
+
+
+	// Gets the number of finished statements.
+	//
+	// Error Handling:
+	//	+ Never throws.
+	size_t statement_count() const noexcept {
+		return statementEnds.size();
+	}
+
+
+	// Gets the first token of a statement. A statement index equal to
+	// statement_count() gives the first token of the open statement.
+	//
+	// Error Handling:
+	//	+ Never throws.
+	uint32_t statement_begin(size_t statement) const noexcept {
+		return (statement == 0) ? 0 : statementEnds[statement - 1];
+	}
+
+
+	// Gets the number of tokens in the open statement.
+	//
+	// Error Handling:
+	//	+ Never throws.
+	size_t open_count() const noexcept {
+		return size() - statement_begin(statementEnds.size());
+	}
+
+
+	// Gets a token.
+	//
+	// Error Handling:
+	//	+ Never throws. The index must be less than size().
+	Token get(size_t i) const noexcept {
+		return { offsets[i], lengths[i], types[i], subtypes[i] };
+	}
+
+
+	// Adds a token to the open statement.
+	void push_back(const Token& tok);
+
+
+	// Removes the last token.
+	//
+	// Error Handling:
+	//	+ Never throws. The table must not be empty.
+	void pop_back() noexcept;
+
+
+	// Ends the open statement after its last token.
+	void end_statement();
+
+
+	// Adds the tokens of another table, starting at one of its statements.
+	// The open statement of this table continues into the added tokens.
+	void append(const Token_Table& other, size_t firstStatement = 0);
+
+
+	// Removes every token and statement, keeping the memory.
+	//
+	// Error Handling:
+	//	+ Never throws.
+	void clear() noexcept;
+
+
+	// Reserves space for a number of tokens.
+	void reserve(size_t tokens);
 };
 
 
-// Line of code from a file.
-struct Line {
+// Matching brackets of a token table: (), [], {} and [[ ]]. Built after the
+// tokens with a stack of the brackets still open, so a parser can skip from
+// an opening bracket to its closing bracket (or back) without looking at the
+// tokens between them.
+//
+// Fields:
+//	+ partners: For every token, the index of its matching bracket, or
+//		NO_PARTNER if the token is not a matched bracket.
+//	+ unmatched: Brackets that were not fully matched, in token order.
+//		Opening brackets were never closed, closing brackets had nothing (or
+//		for ]], only one [) to close.
+struct Bracket_Index {
+	static constexpr uint32_t NO_PARTNER = UINT32_MAX;
+	std::vector<uint32_t> partners{};
+	std::vector<uint32_t> unmatched{};
+
+
+	// Gets the index of the bracket matching a token, or NO_PARTNER.
+	//
+	// Error Handling:
+	//	+ Never throws. The index must be less than the number of tokens.
+	uint32_t partner(size_t token) const noexcept {
+		return partners[token];
+	}
+};
+
+
+// Scanner state carried from the end of one line to the start of the next.
+enum class Line_State : uint8_t {
+	NORMAL,
+	MULTILINE_COMMENT,			// Inside /* */
+	COMMENT_CONTINUATION,		// // comment ending with a backslash
+	DOUBLE_CONTINUATION,		// " string ending with a backslash
+	SINGLE_CONTINUATION			// ' string ending with a backslash
+};
+
+
+// String literal continued across lines, carried with the Line_State. The
+// pieces are decoded and joined until the literal ends, then the token of
+// every piece gets the index of the whole literal.
+//
+// Fields:
+//	+ text: Decoded text of the pieces so far.
+//	+ pieces: Number of tokens of the literal so far, 0 if none is open.
+//	+ type: Quote type of the literal.
+struct Open_Literal {
 	std::string text{};
-	std::vector<Lexeme> lexemes{};
+	uint32_t pieces = 0;
+	String_Type type = String_Type::DOUBLE;
 };
 
 
+// Lexemes of a line of code. The lexemes are stored with those of every other
+// line in Scanner_Results, the text itself stays in the Source_Buffer.
+//
+// Fields:
+//	+ firstLexeme: Index of the first lexeme of the line in Scanner_Results.
+//	+ lexemeCount: Number of lexemes in the line.
+//	+ state: Scanner state at the end of the line.
+//	+ openStatement: The last statement of the line continues onto the next.
+struct Line {
+	uint32_t firstLexeme = 0;
+	uint32_t lexemeCount = 0;
+	Line_State state = Line_State::NORMAL;
+	bool openStatement = false;
+};
+
+
+struct Scanner_View;
+
+
 // Output of the scanner.
+//
+// Fields:
+//	+ lines: Every line of the source.
+//	+ lexemes: Lexemes of all lines, one line after another.
+//	+ tokens: Tokens of all lines.
+//	+ brackets: Matching brackets of the tokens.
+//	+ diagnostics: Problems found by the scanner, in offset order.
+//	+ sourceLength: Length of the scanned text, used to move the offsets of
+//		tokens that follow an edit.
 struct Scanner_Results {
 	std::vector<Line> lines{};
-	std::vector<std::vector<Token>> tokens{};
+	std::vector<Lexeme> lexemes{};
+	Token_Table tokens{};
+	Bracket_Index brackets{};
+	Diagnostics diagnostics{};
+	uint32_t sourceLength = 0;
+
+
+	// Gets a lexeme of a line.
+	//
+	// Error Handling:
+	//	+ Never throws. The index must be less than the line's lexemeCount.
+	const Lexeme& lexeme(size_t line, uint32_t index) const noexcept {
+		return lexemes[lines[line].firstLexeme + index];
+	}
+
+
+	// Gets a view of the results. The view is valid until the results change.
+	//
+	// Error Handling:
+	//	+ Never throws.
+	Scanner_View view() const noexcept;
+};
+
+
+// Read-only view of scanner output. The arrays belong either to
+// Scanner_Results or to a mapped token cache (see Token_Cache.h), where they
+// are used in place, so code that only reads the output works with both.
+//
+// Fields:
+//	+ lines, lexemes: As in Scanner_Results.
+//	+ types, subtypes, offsets, lengths, statementEnds: As in Token_Table.
+//	+ partners, unmatched: As in Bracket_Index.
+//	+ *Count: Number of items in each array. The token arrays and partners
+//		all have tokenCount items.
+struct Scanner_View {
+	const Line* lines = nullptr;
+	const Lexeme* lexemes = nullptr;
+	const Token_Type* types = nullptr;
+	const Token_Subtype* subtypes = nullptr;
+	const uint32_t* offsets = nullptr;
+	const uint32_t* lengths = nullptr;
+	const uint32_t* statementEnds = nullptr;
+	const uint32_t* partners = nullptr;
+	const uint32_t* unmatched = nullptr;
+	uint32_t lineCount = 0;
+	uint32_t lexemeCount = 0;
+	uint32_t tokenCount = 0;
+	uint32_t statementCount = 0;
+	uint32_t unmatchedCount = 0;
+
+
+	// Gets a token.
+	//
+	// Error Handling:
+	//	+ Never throws. The index must be less than tokenCount.
+	Token token(size_t i) const noexcept {
+		return { offsets[i], lengths[i], types[i], subtypes[i] };
+	}
+
+
+	// Gets a lexeme of a line.
+	//
+	// Error Handling:
+	//	+ Never throws. The index must be less than the line's lexemeCount.
+	const Lexeme& lexeme(size_t line, uint32_t index) const noexcept {
+		return lexemes[lines[line].firstLexeme + index];
+	}
 };
 
 
-// Scans input text to produce lexemes and tokens.
-Scanner_Results scan(const std::vector<std::string>& code);
+// Scans input text to produce lexemes and tokens. Words are interned in the
+// symbol table, numbers are decoded into the constant pool and string
+// literals into the string pool the scanner is bound to. The operator and
+// keyword tables are built at compile time and the scanner keeps no state
+// between calls, so one scanner may be shared by any number of threads.
+// Results are cleared and refilled in place, scanning into the same results
+// again reuses their memory.
+class Scanner {
+public:
+	// Fewest bytes scan() puts in a chunk unless set otherwise, so small
+	// inputs are not split into chunks that cost more to join than to scan.
+	static constexpr uint32_t DEFAULT_MIN_CHUNK_BYTES = 64 * 1024;
+
+
+	// Binds the scanner to the pools it adds to. The pools must outlive it.
+	//
+	// Error Handling:
+	//	+ Never throws.
+	Scanner(Symbol_Table& symbols, Constant_Pool& constants, String_Pool& strings) noexcept :
+		symbols(&symbols), constants(&constants), strings(&strings) {
+	}
+
+
+	// Scans input text into results, reusing their memory. Literals without
+	// escapes stay views into the source, see String_Pool::detach. Given a
+	// thread pool, large inputs are split into line aligned chunks that are
+	// scanned in parallel. The results are identical to a serial scan, apart
+	// from the order new symbols, constants and literals are numbered in.
+	// Brackets are matched once every token is known.
+	//
+	// Error Handling:
+	//	+ Unrecognized characters and bytes that are not UTF-8 become ERROR
+	//	  tokens and scanning carries on. They are reported in
+	//	  results.diagnostics with unmatched brackets, string literals and
+	//	  block comments never closed and numbers too large for their type.
+	//	+ Throws std::length_error if a pool is full. The results are left
+	//	  partly filled in that case.
+	void scan(const Source_Buffer& source, Scanner_Results& results, Thread_Pool* pool = nullptr) const;
+
+
+	// Scans a batch of inputs, results[i] gets the results of sources[i].
+	// Given a thread pool, each thread scans whole inputs, which suits many
+	// small inputs better than splitting each into chunks. results is resized
+	// to the number of inputs, the memory of entries already present is
+	// reused.
+	//
+	// Error Handling:
+	//	+ Problems in an input are reported in the diagnostics of its results,
+	//	  see scan().
+	//	+ Throws std::length_error if a pool is full. Every input is scanned
+	//	  first, then the error of the first failed input is thrown. The results
+	//	  of the other inputs are complete.
+	void scan_batch(const std::vector<Source_Buffer>& sources, std::vector<Scanner_Results>& results,
+		Thread_Pool* pool = nullptr) const;
+
+
+	// Updates the results of scan() after lines [first, first + removed) were
+	// replaced by inserted lines (see Source_Buffer::replace_lines). Scanning
+	// starts at the statement open before the edit and stops at the first
+	// line after the edit where the scanner state matches the previous
+	// results. The new lines and statements are spliced into results. Brackets
+	// are matched again only up to where the brackets left open agree with the
+	// previous results, and only the problems up to there are reported again.
+	//
+	// Error Handling:
+	//	+ Problems are reported in results.diagnostics, see scan().
+	//	+ Throws std::length_error if a pool is full. The results are left
+	//	  unchanged in that case.
+	void rescan(const Source_Buffer& source, size_t first, size_t removed, size_t inserted,
+		Scanner_Results& results) const;
+
+
+	// Sets the fewest bytes scan() puts in a chunk. Lowering it splits small
+	// inputs into one chunk per thread, which tests use to put chunk
+	// boundaries anywhere in a file.
+	//
+	// Error Handling:
+	//	+ Never throws. A size of 0 is taken as 1.
+	void set_min_chunk_bytes(uint32_t bytes) noexcept {
+		minChunkBytes = std::max<uint32_t>(bytes, 1);
+	}
+
+private:
+	Symbol_Table* symbols = nullptr;
+	Constant_Pool* constants = nullptr;
+	String_Pool* strings = nullptr;
+	uint32_t minChunkBytes = DEFAULT_MIN_CHUNK_BYTES;
+};
 
 #endif
 
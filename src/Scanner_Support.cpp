@@ -6,483 +6,574 @@
 // Header
 #include "Scanner_Support.h"
 
+// STL
+#include <cstring>
 
-// Treat all low value ASCII characters as whitespace (space == 32).
-bool is_whitespace(char c) {
-	return c <= 32;
-}
+// Internal
+#include "CPU_Features.h"
+#include "Text_Search.h"
+#include "Unicode.h"
 
 
-// Checks if the character is a binary number (0, 1).
-bool is_binary_number(char c) {
-	return c == '0' || c == '1';
+// Scans for whitespace. Returns the stopping index (if the result is the same
+// as index then no whitespace was found). Whitespace above ASCII is
+// Pattern_White_Space.
+uint32_t scan_whitespace(std::string_view s, uint32_t index) {
+	const uint32_t length = (uint32_t)s.length();
+	uint32_t end = span_class(s.data(), index, length, CHAR_WHITESPACE, whitespace_lut);
+
+	// Whitespace above ASCII is decoded one character at a time
+	while (end < length && static_cast<uint8_t>(s[end]) >= 0x80) {
+		uint32_t cp = 0;
+		uint32_t count = decode_utf8(s.data() + end, length - end, cp);
+		if (count == 0 || !is_pattern_whitespace(cp)) {
+			break;
+		}
+		end = span_class(s.data(), end + count, length, CHAR_WHITESPACE, whitespace_lut);
+	}
+	return end;
 }
 
 
-// Checks if the character is a decimal number (0-9).
-bool is_decimal_number(char c) {
-	return c >= '0' && c <= '9';
-}
+// Bytes of a word, used to build a mask of the bytes in a character class.
+// A mask has the high bit of each byte in the class set.
+static constexpr uint64_t BYTE_ONES = 0x0101010101010101;
+static constexpr uint64_t BYTE_HIGHS = 0x8080808080808080;
 
 
-// Checks if the character is a hexadecimal number (0-9), (a-f), (A-F).
-bool is_hex_number(char c) {
-	return is_decimal_number(c) || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F');
+// Masks the bytes of v in [lo, hi]. Bytes above 127 are never in range. Each
+// byte is compared with its high bit set so no borrow crosses into the next.
+static uint64_t bytes_in_range(uint64_t v, uint8_t lo, uint8_t hi) noexcept {
+	uint64_t x = v | BYTE_HIGHS;
+	return (x - BYTE_ONES * lo) & ~(x - BYTE_ONES * (hi + 1)) & ~v & BYTE_HIGHS;
 }
 
 
-// Scans for whitespace. Returns the stopping index (if the result is the same
-// as index then no whitespace was found).
-uint32_t scan_whitespace(const std::string& s, uint32_t index) {
-	for (uint32_t i = index; i < s.length(); ++i) {
-		if (!is_whitespace(s[i])) {
-			return i;
-		}
-	}
-	return (uint32_t)s.length();
+// Masks the bytes of v equal to c.
+static uint64_t bytes_equal(uint64_t v, uint8_t c) noexcept {
+	uint64_t x = v ^ (BYTE_ONES * c);
+	return ~(((x & ~BYTE_HIGHS) + ~BYTE_HIGHS) | x) & BYTE_HIGHS;
 }
 
 
-// Scans for binary constants 0b(0,1)*.
-uint32_t scan_binary(const std::string& s, uint32_t index) {
-	// Verify first value is a binary value.
-	if (!is_binary_number(s[index])) {
-		return index;
-	}
-	else index += 1;
+// Masks the binary digits (0, 1) of v.
+static uint64_t binary_digits(uint64_t v) noexcept {
+	return bytes_in_range(v, '0', '1');
+}
 
-	// Loop until end of the lexeme is found or no more characters present
-	for (uint32_t i = index; i < s.length(); ++i) {
-		// Binary number
-		if (is_binary_number(s[i])) {
-			continue;
-		}
 
-		// Seperator
-		else if (s[i] == '_') {
-			// Must be a 0 or 1 next
-			if (++i < s.length()) {
-				if (!is_binary_number(s[i])) {
-					return i - 1;
-				}
-			}
-		}
-		// Non-binary character
-		else {
-			return i;
-		}
-	}
-	return (uint32_t)s.length();
+// Masks the decimal digits (0-9) of v.
+static uint64_t decimal_digits(uint64_t v) noexcept {
+	return bytes_in_range(v, '0', '9');
 }
 
 
-// Scans for hex constants 0x(0-9, a-f, A-F)*.
-uint32_t scan_hex(const std::string& s, uint32_t index) {
-	// Verify first value is a hex value.
-	if (!is_hex_number(s[index])) {
-		return index;
-	}
-	else index += 1;
+// Masks the hex digits (0-9, a-f, A-F) of v. Setting bit 5 folds A-F onto
+// a-f without moving any other byte into that range.
+static uint64_t hex_digits(uint64_t v) noexcept {
+	return bytes_in_range(v, '0', '9') | bytes_in_range(v | (BYTE_ONES * 0x20), 'a', 'f');
+}
 
-	// Loop until end of the lexeme is found or no more characters present
-	for (uint32_t i = index; i < s.length(); ++i) {
-		// Hex number
-		if (is_hex_number(s[i])) {
-			continue;
-		}
 
-		// Seperator
-		else if (s[i] == '_') {
-			// Must be a hex next
-			if (++i < s.length()) {
-				if (!is_hex_number(s[i])) {
-					return i - 1;
-				}
+// Scans a run of digits and _ separators starting at index. A separator is
+// part of the run if it is followed by a digit or ends the line. Eight
+// characters are classified per step and the end of the run is the lowest
+// byte that is neither, found by counting trailing zeros.
+template <uint64_t (*Digits)(uint64_t)>
+static uint32_t scan_digits(std::string_view s, uint32_t index) noexcept {
+	uint32_t length = (uint32_t)s.length();
+	for (uint32_t i = index; i < length; i += 8) {
+		// Characters past the end of the line load as 0, outside any class.
+		// The last word of a long line is loaded from the end and shifted.
+		uint32_t left = length - i;
+		uint64_t v = 0;
+		if (left >= 8) {
+			std::memcpy(&v, s.data() + i, 8);
+		}
+		else if (length >= 8) {
+			std::memcpy(&v, s.data() + length - 8, 8);
+			v >>= 8 * (8 - left);
+		}
+		else {
+			// Lines shorter than a word are loaded in 4, 2 and 1 byte parts
+			const char* p = s.data() + i;
+			uint32_t shift = 0;
+			if (left & 4) {
+				uint32_t part = 0;
+				std::memcpy(&part, p, 4);
+				v = part;
+				p += 4;
+				shift = 32;
+			}
+			if (left & 2) {
+				uint16_t part = 0;
+				std::memcpy(&part, p, 2);
+				v |= uint64_t(part) << shift;
+				p += 2;
+				shift += 16;
+			}
+			if (left & 1) {
+				v |= uint64_t(static_cast<uint8_t>(*p)) << shift;
 			}
 		}
-		// Non-hex character
+		uint64_t digits = Digits(v);
+
+		// Whether the character after each byte is a digit or the line end
+		uint64_t next = digits >> 8;
+		if (left > 8) {
+			next |= (Digits(static_cast<uint8_t>(s[i + 8])) & 0x80) << 56;
+		}
 		else {
-			return i;
+			next |= uint64_t(0x80) << (8 * (left - 1));
+		}
+
+		uint64_t stop = ~(digits | (bytes_equal(v, '_') & next)) & BYTE_HIGHS;
+		if (stop) {
+			return i + count_trailing_zeros(stop) / 8;
 		}
 	}
-	return (uint32_t)s.length();
+	return length;
+}
+
+
+// Digit scanners of the number states, indexed by Digit_Span. Called
+// through the table so the automaton loop stays small.
+static uint32_t(* const digit_spans[])(std::string_view, uint32_t) noexcept = {
+	nullptr,
+	scan_digits<binary_digits>,
+	scan_digits<decimal_digits>,
+	scan_digits<hex_digits>
+};
+
+
+// Scans a run of digits of a span's class and _ separators starting at index.
+// A separator is part of the run if it is followed by a digit or ends the
+// line. Returns the end of the run.
+//
+// Error Handling:
+//	+ Never throws. The span must not be Digit_Span::NONE.
+uint32_t scan_digit_span(std::string_view s, uint32_t index, Digit_Span span) noexcept {
+	return digit_spans[static_cast<uint32_t>(span)](s, index);
 }
 
 
-// Scans for integer constants (0-9)*.
-uint32_t scan_integer(const std::string& s, uint32_t index) {
-	// Loop until end of the lexeme is found or no more characters present
-	for (uint32_t i = index; i < s.length(); ++i) {
-		// Decimal number
-		if (is_decimal_number(s[i])) {
-			continue;
+// Longest lexeme the lexer automaton matches at an index.
+//
+// Fields:
+//	+ rule: Rule of the lexeme, NONE if no lexeme starts at the index.
+//	+ subtype: The Number_Type or Operator_Type of the lexeme.
+//	+ end: End of the match. Rules other than NUMBER and OPERATOR only match
+//		the start of their lexeme.
+struct Lexer_Match {
+	Lexeme_Rule rule = Lexeme_Rule::NONE;
+	uint8_t subtype = 0;
+	uint32_t end = 0;
+};
+
+
+// Runs the lexer automaton from index and returns the longest match. The end
+// of the line is read as LEXER_EOL.
+static Lexer_Match match_lexeme(std::string_view s, uint32_t index) noexcept {
+	const uint32_t length = (uint32_t)s.length();
+	Lexer_Match match{ Lexeme_Rule::NONE, 0, index };
+	uint32_t state = 0;
+	uint32_t i = index;
+
+	// Runs until a byte has no transition, even for lexemes decided by their
+	// first byte. Stopping early is a branch that mispredicts on mixed operators.
+	while (i < length) {
+		uint32_t to = lexer_table.next[state][static_cast<uint8_t>(s[i])];
+		if (to == 0) {
+			return match;
 		}
+		state = to;
+		i += 1;
+		const Lexer_State& info = lexer_table.states[state];
 
-		// Seperator
-		else if (s[i] == '_') {
-			// Must be a decimal next
-			if (++i < s.length()) {
-				if (!is_decimal_number(s[i])) {
-					return i - 1;
-				}
-			}
+		// Digits that loop on the state are skipped together
+		if (info.span != Digit_Span::NONE) {
+			i = digit_spans[static_cast<uint32_t>(info.span)](s, i);
 		}
-		// Non-decimal character
-		else {
-			return i;
+		if (info.rule != Lexeme_Rule::NONE) {
+			match = { info.rule, info.subtype, i };
 		}
 	}
-	return (uint32_t)s.length();
+
+	// The end of the line can complete a match without consuming anything
+	state = lexer_table.next[state][LEXER_EOL];
+	if (state != 0 && lexer_table.states[state].rule != Lexeme_Rule::NONE) {
+		match = { lexer_table.states[state].rule, lexer_table.states[state].subtype, length };
+	}
+	return match;
 }
 
 
-// Scans for decimal constants (0-9)*.(0-9)*(e, E)(+, -)(0-9)*.
-uint32_t scan_decimal(const std::string& s, uint32_t index) {
-	// Get numbers after a decimal place
-	uint32_t newIndex = scan_integer(s, index);
-
-	// Check for (e, E)
-	if ((newIndex + 1) != s.length()) {
-		if (s[newIndex] == 'e' || s[newIndex] == 'E') {
-			if (s[newIndex + 1] == '+' || s[newIndex + 1] == '-') {
-				uint32_t nextIndex = scan_integer(s, newIndex + 2);
-				if (newIndex + 2 != nextIndex) {
-					return nextIndex;
-				}
-				else {
-					return newIndex;
-				}
-			}
-			else {
-				uint32_t nextIndex = scan_integer(s, newIndex + 1);
-				if (newIndex + 1 != nextIndex) {
-					return nextIndex;
-				}
-				else {
-					return newIndex;
-				}
-			}
-		}
+// Checks if a line ends with a line continuation mark, a backslash that is
+// not escaped. Only the backslashes from begin on are counted, a run of them
+// ends in an escaping backslash if it is odd.
+static bool ends_with_continuation(std::string_view s, uint32_t begin) {
+	uint32_t i = (uint32_t)s.length();
+	while (i > begin && s[i - 1] == '\\') {
+		i -= 1;
 	}
+	return (s.length() - i) % 2 == 1;
+}
+
 
-	// Fallback
-	return newIndex;
+// Scans for the closing quote of a string continued from the previous line.
+// The line continuation mark ended that line, so the first character is not
+// escaped. Returns the index of the quote, or the length of the line if the
+// string does not end on it.
+uint32_t scan_string_end_quote(std::string_view s, char q, bool& nextLine) {
+	uint32_t i = find_string_end(s.data(), 0, (uint32_t)s.length(), q);
+	nextLine = i == s.length() && ends_with_continuation(s, 0);
+	return i;
 }
 
 
-// Scans for numeric constants.
-uint32_t scan_number(const std::string& s, uint32_t index, Number_Type& type) {
-	// Check for number
-	if (!is_decimal_number(s[index])) {
-		return index;
+// Adds a piece of a string literal, the text between its quotes on one line.
+// A literal that continues on the next line is kept open in literal and 0 is
+// returned. A literal on a single line is added to strings and its index is
+// returned, as a view of the text if it has no escapes.
+uint32_t add_string_piece(std::string_view text, bool nextLine, String_Type type, Open_Literal& literal,
+	String_Pool& strings) {
+	// Drop the line continuation mark
+	if (nextLine) {
+		text.remove_suffix(1);
 	}
 
-	// Binary or hexadecimal numbers
-	if (s[index] == '0') {
-		if (index + 2 < s.length()) {
-			// Binary constant
-			if (s[index + 1] == 'b') {
-				uint32_t newIndex = scan_binary(s, index + 2);
-				if (newIndex != index + 2) {
-					type = Number_Type::BINARY;
-					return newIndex;
-				}
-			}
-			// Hexadecimal constant
-			else if (s[index + 1] == 'x') {
-				uint32_t newIndex = scan_hex(s, index + 2);
-				if (newIndex != index + 2) {
-					type = Number_Type::HEX;
-					return newIndex;
-				}
-			}
+	// Literal on a single line
+	if (literal.pieces == 0 && !nextLine) {
+		if (text.find('\\') == std::string_view::npos) {
+			return strings.add_view(text, type);
 		}
+		literal.text.clear();
+		decode_string(text, literal.text);
+		return strings.add(literal.text, type);
 	}
 
-	// Decmial number
-	uint32_t newIndex = scan_integer(s, index + 1);
-	if (newIndex < s.length()) {
-		if (s[newIndex] == '.') {
-			type = Number_Type::DECIMAL;
-			return scan_decimal(s, newIndex + 1);
-		}
+	// Piece of a continued literal
+	if (literal.pieces == 0) {
+		literal.text.clear();
+		literal.type = type;
 	}
-	type = Number_Type::INTEGER;
-	return newIndex;
+	literal.pieces += 1;
+	decode_string(text, literal.text);
+	return 0;
 }
 
 
-// Scans for comments.
-uint32_t scan_comment(const std::string& s, uint32_t index, Comment_Case& cc) {
-	// Check for start of a comment
-	if (s[index] != '/') {
-		return index;
-	}
-
-	// Check for comment
-	if ((index + 1) < s.length()) {
-		// Single line comment
-		if (s[index + 1] == '/') {
-			// Check for line continuation
-			if (s.back() == '\\') {
-				cc = Comment_Case::SINGLE_LINE_CONTINUATION;
-			}
-			return (uint32_t)s.length();
-		}
-		// Multiline comment
-		else if (s[index + 1] == '*') {
-			size_t findPos = s.find("*/", index + 2);
-			if (findPos == std::string::npos) {
-				cc = Comment_Case::MULTILINE;
-				return (uint32_t)s.length();
-			}
-			else {
-				return (uint32_t)findPos + 2;
-			}
-		}
-		// Divide equals
-		else if (s[index + 1] == '=') {
-			cc = Comment_Case::DIVISION_EQUALS;
-			return index + 2;
+// Scans for words, stops when an illegal word symbol is detected or no more characters.
+// Characters above ASCII must be XID_Start at the start of the word and
+// XID_Continue after it.
+uint32_t scan_word(std::string_view s, uint32_t index) {
+	const uint32_t length = (uint32_t)s.length();
+	uint32_t end = span_class(s.data(), index, length, CHAR_WORD, word_lut);
+
+	// Characters above ASCII are decoded one at a time
+	while (end < length && static_cast<uint8_t>(s[end]) >= 0x80) {
+		uint32_t cp = 0;
+		uint32_t count = decode_utf8(s.data() + end, length - end, cp);
+		if (count == 0 || !(end == index ? is_xid_start(cp) : is_xid_continue(cp))) {
+			break;
 		}
+		end = span_class(s.data(), end + count, length, CHAR_WORD, word_lut);
 	}
+	return end;
+}
+
 
-	// Single slash found
-	cc = Comment_Case::DIVISION;
-	return index + 1;
+// Computes the hash of a lexeme. The lexeme must be from the input string.
+uint32_t hash_text(std::string_view s, Lexeme l) {
+	return crc32c(0, s.data() + l.begin, l.end - l.begin);
 }
 
 
-// Scans for double quote string literal, does not validate quote correctness.
-uint32_t scan_string_double_quote(const std::string& s, uint32_t index, bool& nextLine) {
-	if (s[index] == '"') {
-		for (uint32_t i = index + 1; i < s.length(); ++i) {
-			if (s[i] == '"') {
-				if (s[i - 1] != '\\') {
-					return i + 1;
-				}
-			}
-		}
-		nextLine = s.back() == '\\';
-		return (uint32_t)s.length();
-	}
-	return index;
+// Comptues the hash of an entire string.
+uint32_t hash_text(const char* s) {
+	return crc32c(0, s, std::strlen(s));
 }
 
 
-// Scans for single quote string literal, does not validate quote correctness.
-uint32_t scan_string_single_quote(const std::string& s, uint32_t index, bool& nextLine) {
-	if (s[index] == '\'') {
-		for (uint32_t i = index + 1; i < s.length(); ++i) {
-			if (s[i] == '\'') {
-				if (s[i - 1] != '\\') {
-					return i + 1;
-				}
-			}
-		}
-		nextLine = s.back() == '\\';
-		return (uint32_t)s.length();
+// Checks if a word is a keyword. The type is only set if a keyword is found.
+bool find_keyword(const char* text, uint32_t length, const Keyword_Table& table, Keyword_Type& type) {
+	const auto& slot = table.slots[keyword_slot(keyword_key(text[0], text[length - 1], length), table.multiplier)];
+	if (slot.length != length || std::memcmp(slot.text, text, length) != 0) {
+		return false;
 	}
-	return index;
+	type = slot.type;
+	return true;
 }
 
 
-// Scans for the end of a quote when a line continuation mark was detected.
-uint32_t scan_string_end_quote(const std::string& s, char q, bool& nextLine) {
-	for (uint32_t i = 0; i < s.length(); ++i) {
-		if (s[i] == q) {
-			if (i != 0) {
-				if (s[i - 1] != '\\') {
-					nextLine = false;
-					return i;
-				}
-			}
-		}
+// Checks if a lexeme can start at index.
+static bool starts_lexeme(std::string_view s, uint32_t index) {
+	const uint8_t c = static_cast<uint8_t>(s[index]);
+	if (c < 0x80) {
+		return lexer_table.next[0][c] != 0;
 	}
-	nextLine = s.back() == '\\';
-	return (uint32_t)s.length();
+	return scan_whitespace(s, index) != index || scan_word(s, index) != index;
 }
 
 
-// Creates the operator hierarchy for scanning. Later versions can be converted
-// to a finite automata instead of using pointers. This version allows new
-// operators to be added easily.
-std::vector<Operator> build_operator_hierarchy() {
-	return std::vector<Operator>{
-		{ Operator_Type::ACCESSOR, '.', {} },
-		{ Operator_Type::ASTERISK, '*', {
-			{ Operator_Type::MULTIPLY_EQUAL, '=', {} },
-		} },
-		{ Operator_Type::BACK_SLASH, '\\', {} },
-		{ Operator_Type::BITWISE_AND, '&', {
-			{ Operator_Type::BITWISE_AND_EQUAL, '=', {} },
-			{ Operator_Type::LOGICAL_AND, '&', {} }
-		} },
-		{ Operator_Type::BITWISE_NOT, '~', {} },
-		{ Operator_Type::BITWISE_OR, '|', {
-			{ Operator_Type::BITWISE_OR_EQUAL, '=', {} },
-			{ Operator_Type::LOGICAL_OR, '|', {} }
-		} },
-		{ Operator_Type::BITWISE_XOR, '^', {
-			{ Operator_Type::BITWISE_XOR_EQUAL, '=', {} },
-			{ Operator_Type::LOGICAL_XOR, '^', {} }
-		} },
-		{ Operator_Type::CLOSED_CURLY, '}', {} },
-		{ Operator_Type::CLOSED_PAREN, ')', {} },
-		{ Operator_Type::CLOSED_SQUARE, ']', {
-			{ Operator_Type::CLOSED_ATTRIBUTE, ']', {} }
-		} },
-		{ Operator_Type::COLON, ':', {
-			{ Operator_Type::SCOPE, ':', {} }
-		} },
-		{ Operator_Type::COMMA, ',', {} },
-		{ Operator_Type::EQUALS, '=', {
-			{ Operator_Type::EQUALS_TO, '=', {} },
-			{ Operator_Type::MATCH_CASE, '>', {} }
-		} },
-		{ Operator_Type::GREATER, '>', {
-			{ Operator_Type::GREATER_EQUAL, '=', {} },
-			{ Operator_Type::RIGHT_SHIFT, '>', {
-				{ Operator_Type::RIGHT_SHIFT_EQUAL, '=', {} }
-			} }
-		} },
-		{ Operator_Type::LESS, '<', {
-			{ Operator_Type::LESS_EQUAL, '=', {
-				{ Operator_Type::THREE_WAY_COMP, '>', {} }
-			} },
-			{ Operator_Type::LEFT_SHIFT, '<', {
-					{ Operator_Type::LEFT_SHIFT_EQUAL, '=', {} }
-			} }
-		} },
-		{ Operator_Type::LOGICAL_NOT, '!', {
-			{ Operator_Type::NOT_EQUAL, '=', {} }
-		} },
-		{ Operator_Type::MACRO, '#', {} },
-		{ Operator_Type::MINUS, '-', {
-			{ Operator_Type::ARROW, '>', {} },
-			{ Operator_Type::DECREMENT, '-', {} },
-			{ Operator_Type::MINUS_EQUAL, '=', {} }
-		} },
-		{ Operator_Type::MODULO, '%', {
-			{ Operator_Type::MODULO_EQUAL, '=', {} }
-		} },
-		{ Operator_Type::OPEN_CURLY, '{', {} },
-		{ Operator_Type::OPEN_PAREN, '(', {} },
-		{ Operator_Type::OPEN_SQUARE, '[', {
-			{ Operator_Type::OPEN_ATTRIBUTE, '[', {} }
-		} },
-		{ Operator_Type::PLUS, '+', {
-			{ Operator_Type::INCREMENT, '+', {} },
-			{ Operator_Type::PLUS_EQUAL, '=', {} }
-		} },
-		{ Operator_Type::SEMICOLON, ';', {} },
-		{ Operator_Type::TERNARY, '?', {} },
-
-		// Operators that are not yet supported
-		{ Operator_Type::UNSUPPORTED_OPERATOR, '`', {} },
-		{ Operator_Type::UNSUPPORTED_OPERATOR, '@', {} }
-	};
+// Skips a run of characters that can not start a lexeme and returns its end.
+// At least one character is skipped, whole characters are skipped so the run
+// never ends inside a UTF-8 sequence. The run is either all characters or all
+// bytes that are not UTF-8, a run of one kind ends where the other starts.
+static uint32_t skip_unrecognized(std::string_view s, uint32_t index) {
+	const uint32_t length = (uint32_t)s.length();
+	uint32_t i = index;
+	uint32_t cp = 0;
+	uint32_t count = decode_utf8(s.data() + i, length - i, cp);
+	const bool valid = count != 0;
+	do {
+		i += valid ? count : 1;
+		count = (i < length) ? decode_utf8(s.data() + i, length - i, cp) : 0;
+	} while (i < length && (count != 0) == valid && !starts_lexeme(s, i));
+	return i;
 }
 
 
-// Scans for operators.
-uint32_t scan_operator(const std::string& s, uint32_t index, const std::vector<Operator>& ops, Operator_Type& type) {
-	for (const auto& op : ops) {
-		if (op.symbol == s[index]) {
-			type = op.type;
-			uint32_t newIndex = index + 1;
-			if (op.ops.size() && newIndex < s.length()) {
-				return scan_operator(s, newIndex, op.ops, type);
-			}
-			else {
-				return newIndex;
-			}
+// Scans the next lexeme of a line, starting at index. A multiline construct
+// given by state (comment, continued comment or string) is continued first.
+// Advances index past the lexeme and updates state. Returns true if the lexeme
+// is also a token, in which case the type and subtype of tok are set. Words
+// are interned in symbols, numbers are added to constants and string literals
+// to strings. A piece of a literal continued across lines is added to literal
+// instead, the caller adds the literal to strings once state is NORMAL.
+//
+// Characters that can not start a lexeme are returned as a single ERROR token
+// covering the run of them. Bytes that are not UTF-8 get ERROR tokens of their
+// own.
+//
+// Error Handling:
+//	+ Throws std::length_error if a pool is full.
+bool scan_lexeme(std::string_view s, uint32_t& index, Line_State& state, Open_Literal& literal, Lexeme& lex,
+	Token& tok, Symbol_Table& symbols, Constant_Pool& constants, String_Pool& strings) {
+	const uint32_t begin = index;
+	uint32_t end = index;
+
+	// Continue a construct from a previous line
+	switch (state) {
+	case Line_State::MULTILINE_COMMENT: {
+		uint32_t pos = find_comment_end(s.data(), index, (uint32_t)s.length());
+		if (pos == s.length()) {
+			end = pos;
 		}
+		else {
+			end = pos + 2;
+			state = Line_State::NORMAL;
+		}
+		lex = { begin, end };
+		index = end;
+		return false;
+	}
+	case Line_State::COMMENT_CONTINUATION:
+		if (s.back() != '\\') {
+			state = Line_State::NORMAL;
+		}
+		lex = { begin, (uint32_t)s.length() };
+		index = lex.end;
+		return false;
+	case Line_State::DOUBLE_CONTINUATION:
+	case Line_State::SINGLE_CONTINUATION: {
+		bool nextLine = false;
+		bool dq = state == Line_State::DOUBLE_CONTINUATION;
+		uint32_t quote = scan_string_end_quote(s, dq ? '"' : '\'', nextLine);
+		end = (quote != s.length()) ? quote + 1 : quote;
+		if (!nextLine) {
+			state = Line_State::NORMAL;
+		}
+		tok.type = Token_Type::STRING;
+		tok.subtype.literal = add_string_piece(s.substr(0, quote), nextLine,
+			dq ? String_Type::DOUBLE : String_Type::SINGLE, literal, strings);
+		lex = { begin, end };
+		index = end;
+		return true;
+	}
+	case Line_State::NORMAL:
+		break;
 	}
-	return index;
-}
 
+	// Whitespace is the most common lexeme and is known from its first byte,
+	// checking it before the automaton runs saves a mispredicted branch
+	const uint32_t length = (uint32_t)s.length();
+	const uint8_t start = lexer_table.next[0][static_cast<uint8_t>(s[index])];
+	if (lexer_table.states[start].rule == Lexeme_Rule::WHITESPACE) {
+		end = scan_whitespace(s, index);
+		lex = { begin, end };
+		index = end;
+		return false;
+	}
 
-// Scans for words, stops when an illegal word symbol is detected or no more characters.
-uint32_t scan_word(const std::string& s, uint32_t index) {
-	for (uint32_t i = index; i < s.length(); ++i) {
-		if (s[i] < 48 || (s[i] > 57 && s[i] < 65) || (s[i] > 90 && s[i] < 95)
-			|| s[i] == 96 || (s[i] > 122 && s[i] < 127)) {
-			return i;
+	// The lexer automaton picks the rule, the rule finishes the lexeme
+	Lexer_Match match = match_lexeme(s, index);
+	switch (match.rule) {
+	case Lexeme_Rule::NONE:
+		break;
+
+	// Whitespace is spanned above, before the automaton runs
+	case Lexeme_Rule::WHITESPACE:
+		break;
+
+	// Whitespace above ASCII is checked before words
+	case Lexeme_Rule::NON_ASCII:
+		end = scan_whitespace(s, index);
+		if (end != index) {
+			lex = { begin, end };
+			index = end;
+			return false;
+		}
+		[[fallthrough]];
+	case Lexeme_Rule::WORD:
+		end = scan_word(s, index);
+		if (end == index) {
+			break;
+		}
+		lex = { begin, end };
+		if (find_keyword(s.data() + begin, end - begin, keyword_table, tok.subtype.key)) {
+			tok.type = Token_Type::KEYWORD;
 		}
+		else {
+			tok.type = Token_Type::WORD;
+			tok.subtype.symbol = symbols.intern(s.substr(begin, end - begin), hash_text(s, lex));
+		}
+		index = end;
+		return true;
+
+	case Lexeme_Rule::NUMBER:
+		tok.type = Token_Type::NUMBER;
+		tok.subtype.constant = constants.add(s.substr(begin, match.end - begin),
+			static_cast<Number_Type>(match.subtype));
+		lex = { begin, match.end };
+		index = match.end;
+		return true;
+
+	case Lexeme_Rule::OPERATOR:
+		tok.type = Token_Type::OPERATOR;
+		tok.subtype.op = static_cast<Operator_Type>(match.subtype);
+		lex = { begin, match.end };
+		index = match.end;
+		return true;
+
+	// Comments, possibly continued on the next line
+	case Lexeme_Rule::LINE_COMMENT:
+		if (s.back() == '\\') {
+			state = Line_State::COMMENT_CONTINUATION;
+		}
+		lex = { begin, length };
+		index = length;
+		return false;
+	case Lexeme_Rule::BLOCK_COMMENT: {
+		uint32_t pos = find_comment_end(s.data(), match.end, length);
+		if (pos == length) {
+			state = Line_State::MULTILINE_COMMENT;
+			end = length;
+		}
+		else {
+			end = pos + 2;
+		}
+		lex = { begin, end };
+		index = end;
+		return false;
 	}
-	return (uint32_t)s.length();
-}
-
 
-// Computes the hash of a lexeme. The lexeme must be from the input string.
-uint32_t hash_text(const std::string& s, Lexeme l) {
-	uint32_t crc = 0;
-	for (uint32_t i = l.begin; i < l.end; ++i) {
-		crc = _mm_crc32_u8(crc, (uint8_t)s[i]);
+	// String literals, possibly continued on the next line
+	case Lexeme_Rule::DOUBLE_QUOTE:
+	case Lexeme_Rule::SINGLE_QUOTE: {
+		bool dq = match.rule == Lexeme_Rule::DOUBLE_QUOTE;
+		char q = dq ? '"' : '\'';
+		uint32_t quote = find_string_end(s.data(), match.end, length, q);
+		end = (quote != length) ? quote + 1 : length;
+		bool nextLine = quote == length && ends_with_continuation(s, match.end);
+		tok.type = Token_Type::STRING;
+		tok.subtype.literal = add_string_piece(s.substr(match.end, quote - match.end), nextLine,
+			dq ? String_Type::DOUBLE : String_Type::SINGLE, literal, strings);
+		if (nextLine) {
+			state = dq ? Line_State::DOUBLE_CONTINUATION : Line_State::SINGLE_CONTINUATION;
+		}
+		lex = { begin, end };
+		index = end;
+		return true;
+	}
 	}
-	return crc;
+
+	// Characters the lexer does not recognize become one ERROR token and
+	// scanning resumes after them
+	end = skip_unrecognized(s, index);
+	tok.type = Token_Type::ERROR;
+	tok.subtype.symbol = 0;
+	lex = { begin, end };
+	index = end;
+	return true;
 }
 
 
-// Comptues the hash of an entire string.
-uint32_t hash_text(const char* s) {
-	uint32_t crc = 0;
-	int64_t i = 0;
-	while (s[i] != '\0') {
-		crc = _mm_crc32_u8(crc, (uint8_t)s[i++]);
+// Finds the first run of bytes in text[index, end) that are not part of a
+// well formed UTF-8 sequence. Returns the start of the run, or end if there
+// is none, and sets runEnd to the end of the run.
+//
+// Error Handling:
+//	+ Never throws.
+uint32_t find_invalid_utf8(std::string_view text, uint32_t index, uint32_t end, uint32_t& runEnd) noexcept {
+	const uint32_t run = index + validate_utf8(text.data() + index, end - index);
+	uint32_t cp = 0;
+	runEnd = run;
+	while (runEnd < end && decode_utf8(text.data() + runEnd, end - runEnd, cp) == 0) {
+		runEnd += 1;
 	}
-	return crc;
+	return run;
 }
 
 
-// Matches a word to the text of a lexeme.
-bool match_text(const std::string txt, Lexeme l, const std::string word) {
-	// Must be the same length
-	if ((l.end - l.begin) != word.length()) {
-		return false;
+// Gets the problem of a token that is found from the token alone: characters
+// the scanner does not recognize, a string literal that is never closed or a
+// number too large for its type. next is the token after tok, or nullptr at
+// the end of the tokens. quote carries the quote of a literal from a piece
+// that continues on the next line to the piece that continues it, it must be
+// 0 at the start of a statement. Returns nullptr if the token has no such
+// problem. ERROR tokens of bytes that are not UTF-8 are left to
+// find_invalid_utf8().
+//
+// Error Handling:
+//	+ Never throws.
+const char* token_problem(std::string_view text, const Token& tok, const Token* next, char& quote,
+	const Constant_Pool& constants) noexcept {
+	switch (tok.type) {
+	case Token_Type::ERROR: {
+		uint32_t cp = 0;
+		return decode_utf8(text.data() + tok.offset, tok.length, cp) ? "Unrecognized character." : nullptr;
 	}
-	// Match text
-	else {
-		return 0 == std::memcmp(txt.data() + l.begin, word.data(), word.length());
-	}
-}
-
+	case Token_Type::NUMBER:
+		return constants.get(tok.subtype.constant).overflow ? "Number is too large." : nullptr;
+	case Token_Type::STRING: {
+		// A piece continued from the previous line has no opening quote
+		std::string_view piece = text.substr(tok.offset, tok.length);
+		char q = quote;
+		if (q == 0) {
+			q = piece[0];
+			piece.remove_prefix(1);
+		}
+		quote = 0;
+		if (!piece.empty() && piece.back() == q && !ends_with_continuation(piece.substr(0, piece.length() - 1), 0)) {
+			return nullptr;
+		}
 
-// Creates the set of all supported keywords for scanning. Designed for easy
-// addition of new keywords.
-std::map<uint32_t, Keyword> build_keywords() {
-	return std::map<uint32_t, Keyword>{
-		// Types
-		{ hash_text("i8"), { "i8", Keyword_Type::I8 } },
-		{ hash_text("i16"), { "i16", Keyword_Type::I16 } },
-		{ hash_text("i32"), { "i32", Keyword_Type::I32 } },
-		{ hash_text("i64"), { "i64", Keyword_Type::I64 } },
-		{ hash_text("u8"), { "u8", Keyword_Type::U8 } },
-		{ hash_text("u16"), { "u16", Keyword_Type::U16 } },
-		{ hash_text("u32"), { "u32", Keyword_Type::U32 } },
-		{ hash_text("u64"), { "u64", Keyword_Type::U64 } },
-		{ hash_text("f16"), { "f16", Keyword_Type::F16 } },
-		{ hash_text("f32"), { "f32", Keyword_Type::F32 } },
-		{ hash_text("f64"), { "f64", Keyword_Type::F64 } },
-
-		// Data
-		{ hash_text("class"), { "class", Keyword_Type::CLASS } },
-		{ hash_text("let"), { "let", Keyword_Type::LET } },
-		{ hash_text("self"), { "self", Keyword_Type::SELF } },
-		{ hash_text("struct"), { "struct", Keyword_Type::STRUCT } },
-		{ hash_text("var"), { "var", Keyword_Type::VAR } },
-
-		// Functional
-		{ hash_text("cref"), { "cref", Keyword_Type::CREF } },
-		{ hash_text("fn"), { "fn", Keyword_Type::FN } },
-		{ hash_text("move"), { "move", Keyword_Type::MOVE } },
-		{ hash_text("ref"), { "ref", Keyword_Type::REF } },
-		{ hash_text("return"), { "return", Keyword_Type::RETURN } },
-
-		// Other
-		{ hash_text("namespace"), { "namespace", Keyword_Type::NAMESPACE } }
-	};
+		// A piece ending in a line continuation mark is continued by a piece
+		// at the start of the next line, unless the literal ended first
+		if (next && next->type == Token_Type::STRING && ends_with_continuation(piece, 0)) {
+			uint32_t lineEnd = tok.offset + tok.length;
+			lineEnd += (lineEnd < text.length() && text[lineEnd] == '\r') ? 1 : 0;
+			if (lineEnd < text.length() && text[lineEnd] == '\n' && next->offset == lineEnd + 1) {
+				quote = q;
+				return nullptr;
+			}
+		}
+		return "String literal is never closed.";
+	}
+	default:
+		return nullptr;
+	}
 }
 
 
@@ -7,132 +7,109 @@
 #define SCANNER_SUPPORT_H
 
 // STL
-#include <intrin.h>
-#include <map>
 #include <memory>
+#include <stdexcept>
 #include <string>
+#include <string_view>
 #include <vector>
 
 // Internal
+#include "Char_Class.h"
+#include "Constant_Pool.h"
+#include "Hash.h"
+#include "Lexer_Spec.h"
 #include "Scanner.h"
-
-
-// Treat all low value ASCII characters as whitespace (space == 32).
-inline bool is_whitespace(char c);
-
-
-// Checks if the character is a hexadecimal number (0-9), (a-f), (A-F).
-inline bool is_hex_number(char c);
-
-
-// Checks if the character is a decimal number (0-9).
-inline bool is_decimal_number(char c);
-
-
-// Checks if the character is a binary number (0, 1).
-inline bool is_binary_number(char c);
+#include "String_Pool.h"
+#include "Symbol_Table.h"
 
 
 // Scans for whitespace. Returns the stopping index (if the result is the same
-// as index then no whitespace was found).
-uint32_t scan_whitespace(const std::string& s, uint32_t index);
-
-
-// Scans for binary constants 0b(0,1)*.
-uint32_t scan_binary(const std::string& s, uint32_t index);
-
-
-// Scans for hex constants 0x(0-9, a-f, A-F)*.
-uint32_t scan_hex(const std::string& s, uint32_t index);
-
-
-// Scans for integer constants (0-9)*.
-uint32_t scan_integer(const std::string& s, uint32_t index);
-
-
-// Scans for decimal constants (0-9)*.(0-9)*(e, E)(+, -)(0-9)*.
-uint32_t scan_decimal(const std::string& s, uint32_t index);
-
+// as index then no whitespace was found). Whitespace above ASCII is
+// Pattern_White_Space.
+uint32_t scan_whitespace(std::string_view s, uint32_t index);
 
-// Scans for numeric constants.
-uint32_t scan_number(const std::string& s, uint32_t index, Number_Type& tok);
 
-
-// Defines the multiline comment cases that may occur, or if division is found.
-enum class Comment_Case {
-	NONE,
-	DIVISION,
-	DIVISION_EQUALS,
-	MULTILINE,
-	SINGLE_LINE_CONTINUATION
-};
-
-
-// Scans for comments.
-uint32_t scan_comment(const std::string& s, uint32_t index, Comment_Case& cc);
-
-
-// Scans for double quote string literal, does not validate quote correctness.
-uint32_t scan_string_double_quote(const std::string& s, uint32_t index, bool& nextLine);
-
-
-// Scans for single quote string literal, does not validate quote correctness.
-uint32_t scan_string_single_quote(const std::string& s, uint32_t index, bool& nextLine);
-
-
-// Scans for the end of a quote when a line continuation mark was detected.
-uint32_t scan_string_end_quote(const std::string& s, char q, bool& nextLine);
-
-
-// Defines an operator and dependent operators.
+// Scans a run of digits of a span's class and _ separators starting at index.
+// A separator is part of the run if it is followed by a digit or ends the
+// line. Returns the end of the run.
 //
-// Fields:
-//	+ type: The operator type if a dependent operator is not found.
-//	+ symbol: The character to match on.
-//	+ ops: Dependent operators that contain this operator. Ex. += containts +.
-struct Operator {
-	Operator_Type type;
-	char symbol = '\0';
-	std::vector<Operator> ops{};
-};
+// Error Handling:
+//	+ Never throws. The span must not be Digit_Span::NONE.
+uint32_t scan_digit_span(std::string_view s, uint32_t index, Digit_Span span) noexcept;
 
 
-// Creates the operator hierarchy for scanning. Later versions can be converted
-// to a finite automata instead of using pointers. This version allows new
-// operators to be added easily.
-std::vector<Operator> build_operator_hierarchy();
+// Scans for the closing quote of a string continued from the previous line.
+// The line continuation mark ended that line, so the first character is not
+// escaped. Returns the index of the quote, or the length of the line if the
+// string does not end on it.
+uint32_t scan_string_end_quote(std::string_view s, char q, bool& nextLine);
 
 
-// Scans for operators.
-uint32_t scan_operator(const std::string& s, uint32_t index, const std::vector<Operator>& ops, Operator_Type& type);
+// Adds a piece of a string literal, the text between its quotes on one line.
+// A literal that continues on the next line is kept open in literal and 0 is
+// returned. A literal on a single line is added to strings and its index is
+// returned, as a view of the text if it has no escapes.
+uint32_t add_string_piece(std::string_view text, bool nextLine, String_Type type, Open_Literal& literal,
+	String_Pool& strings);
 
 
 // Scans for words, stops when an illegal word symbol is detected or no more characters.
-uint32_t scan_word(const std::string& s, uint32_t index);
+// Characters above ASCII must be XID_Start at the start of the word and
+// XID_Continue after it.
+uint32_t scan_word(std::string_view s, uint32_t index);
 
 
 // Computes the hash of a lexeme. The lexeme must be from the input string.
-uint32_t hash_text(const std::string& s, Lexeme l);
+uint32_t hash_text(std::string_view s, Lexeme l);
 
 
 // Comptues the hash of an entire string.
 uint32_t hash_text(const char* s);
 
 
-// Matches a word to the text of a lexeme.
-bool match_text(const std::string txt, Lexeme l, const std::string word);
-
+// Checks if a word is a keyword. The type is only set if a keyword is found.
+bool find_keyword(const char* text, uint32_t length, const Keyword_Table& table, Keyword_Type& type);
 
-// Defines a keyword for word comparison.
-struct Keyword {
-	std::string text{};
-	Keyword_Type type;
-};
+// Scans the next lexeme of a line, starting at index. A multiline construct
+// given by state (comment, continued comment or string) is continued first.
+// Advances index past the lexeme and updates state. Returns true if the lexeme
+// is also a token, in which case the type and subtype of tok are set. Words
+// are interned in symbols, numbers are added to constants and string literals
+// to strings. A piece of a literal continued across lines is added to literal
+// instead, the caller adds the literal to strings once state is NORMAL.
+//
+// Characters that can not start a lexeme are returned as a single ERROR token
+// covering the run of them. Bytes that are not UTF-8 get ERROR tokens of their
+// own.
+//
+// Error Handling:
+//	+ Throws std::length_error if a pool is full.
+bool scan_lexeme(std::string_view s, uint32_t& index, Line_State& state, Open_Literal& literal, Lexeme& lex,
+	Token& tok, Symbol_Table& symbols, Constant_Pool& constants, String_Pool& strings);
 
 
-// Creates the set of all supported keywords for scanning. Designed for easy
-// addition of new keywords.
-std::map<uint32_t, Keyword> build_keywords();
+// Finds the first run of bytes in text[index, end) that are not part of a
+// well formed UTF-8 sequence. Returns the start of the run, or end if there
+// is none, and sets runEnd to the end of the run.
+//
+// Error Handling:
+//	+ Never throws.
+uint32_t find_invalid_utf8(std::string_view text, uint32_t index, uint32_t end, uint32_t& runEnd) noexcept;
+
+
+// Gets the problem of a token that is found from the token alone: characters
+// the scanner does not recognize, a string literal that is never closed or a
+// number too large for its type. next is the token after tok, or nullptr at
+// the end of the tokens. quote carries the quote of a literal from a piece
+// that continues on the next line to the piece that continues it, it must be
+// 0 at the start of a statement. Returns nullptr if the token has no such
+// problem. ERROR tokens of bytes that are not UTF-8 are left to
+// find_invalid_utf8().
+//
+// Error Handling:
+//	+ Never throws.
+const char* token_problem(std::string_view text, const Token& tok, const Token* next, char& quote,
+	const Constant_Pool& constants) noexcept;
 
 #endif
 
@@ -0,0 +1,410 @@
+// File:		Source_Buffer.cpp
+// Language:	C++17
+// Purpose:		Contiguous source text with a line offset index.
+// License:		At bottom of document.
+
+// Header
+#include "Source_Buffer.h"
+
+// STL
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+// Internal
+#include "CPU_Features.h"
+
+// Platform
+#if defined(_WIN32)
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#if SIMD_X86
+#include <immintrin.h>
+#endif
+
+
+Source_Buffer::Source_Buffer(Source_Buffer&& other) noexcept {
+	*this = std::move(other);
+}
+
+
+Source_Buffer& Source_Buffer::operator=(Source_Buffer&& other) noexcept {
+	if (this != &other) {
+		unmap();
+		owned = std::move(other.owned);
+		mapBase = other.mapBase;
+		base = mapBase ? mapBase : owned.data();
+		size = other.size;
+		lineStarts = std::move(other.lineStarts);
+
+		// Leave the other buffer empty
+		other.mapBase = nullptr;
+		other.owned.clear();
+		other.base = other.owned.data();
+		other.size = 0;
+		other.lineStarts = { 0, 1 };
+	}
+	return *this;
+}
+
+
+Source_Buffer::~Source_Buffer() {
+	unmap();
+}
+
+
+// Takes ownership of the text and indexes its lines. A leading UTF-8 byte
+// order mark is skipped. Text that is not valid UTF-8 is kept, the scanner
+// reports it.
+//
+// Error Handling:
+//	+ Throws std::length_error if the text does not fit 32 bit offsets.
+void Source_Buffer::assign(std::string text) {
+	if (text.size() >= std::numeric_limits<uint32_t>::max()) {
+		throw std::length_error("Source file exceeds 4 GB.");
+	}
+	unmap();
+	owned = std::move(text);
+	base = owned.data();
+	size = static_cast<uint32_t>(owned.size());
+	index_lines();
+}
+
+
+// Loads a file and indexes its lines. Regular files are memory mapped
+// read-only when allowMap is set, pipes and other special files (or a
+// failed map) fall back to reading the file into owned memory.
+//
+// Error Handling:
+//	+ Throws std::runtime_error if the file cannot be opened or read.
+//	+ Throws std::length_error if the file does not fit 32 bit offsets.
+void Source_Buffer::load(const std::filesystem::path& path, bool allowMap) {
+	const std::string name = path.filename().generic_string();
+#if defined(_WIN32)
+	HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+		OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if (file == INVALID_HANDLE_VALUE) {
+		throw std::runtime_error("Could not open file: " + name);
+	}
+
+	// Map regular files
+	LARGE_INTEGER fileSize{};
+	if (allowMap && GetFileType(file) == FILE_TYPE_DISK && GetFileSizeEx(file, &fileSize)
+		&& fileSize.QuadPart > 0) {
+		if (static_cast<uint64_t>(fileSize.QuadPart) >= std::numeric_limits<uint32_t>::max()) {
+			CloseHandle(file);
+			throw std::length_error("Source file exceeds 4 GB.");
+		}
+		HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (mapping != nullptr) {
+			const void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+			CloseHandle(mapping);
+			if (view != nullptr) {
+				CloseHandle(file);
+				unmap();
+				owned.clear();
+				mapBase = static_cast<const char*>(view);
+				base = mapBase;
+				size = static_cast<uint32_t>(fileSize.QuadPart);
+				index_lines();
+				return;
+			}
+		}
+	}
+
+	// Read everything else
+	std::string text{};
+	char chunk[1 << 16];
+	DWORD count = 0;
+	while (ReadFile(file, chunk, sizeof(chunk), &count, nullptr) && count != 0) {
+		text.append(chunk, count);
+	}
+	CloseHandle(file);
+#else
+	int file = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+	if (file < 0) {
+		throw std::runtime_error("Could not open file: " + name);
+	}
+
+	// Map regular files
+	struct stat info {};
+	bool regular = fstat(file, &info) == 0 && S_ISREG(info.st_mode);
+	if (regular && static_cast<uint64_t>(info.st_size) >= std::numeric_limits<uint32_t>::max()) {
+		close(file);
+		throw std::length_error("Source file exceeds 4 GB.");
+	}
+	if (allowMap && regular && info.st_size > 0) {
+		size_t length = static_cast<size_t>(info.st_size);
+		void* view = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, file, 0);
+		if (view != MAP_FAILED) {
+			close(file);
+			madvise(view, length, MADV_SEQUENTIAL);
+			madvise(view, length, MADV_WILLNEED);
+			unmap();
+			owned.clear();
+			mapBase = static_cast<const char*>(view);
+			base = mapBase;
+			size = static_cast<uint32_t>(length);
+			index_lines();
+			return;
+		}
+	}
+
+	// Read everything else
+	std::string text{};
+	if (regular) {
+		text.reserve(static_cast<size_t>(info.st_size));
+	}
+	char chunk[1 << 16];
+	for (;;) {
+		ssize_t count = read(file, chunk, sizeof(chunk));
+		if (count < 0 && errno == EINTR) {
+			continue;
+		}
+		if (count < 0) {
+			close(file);
+			throw std::runtime_error("Could not read file: " + name);
+		}
+		if (count == 0) {
+			break;
+		}
+		text.append(chunk, static_cast<size_t>(count));
+	}
+	close(file);
+#endif
+	assign(std::move(text));
+}
+
+
+// Replaces the text from the start of line first to the end of line
+// last - 1 with text. The line terminator of line last - 1 is kept, the
+// replacement may hold any number of newlines. A mapped buffer is copied
+// into owned memory first. Returns the number of lines replacing
+// [first, last), which is always at least one.
+//
+// Error Handling:
+//	+ Throws std::out_of_range if the lines are not 0 <= first < last <= line_count().
+//	+ Throws std::length_error if the edited text does not fit 32 bit offsets.
+size_t Source_Buffer::replace_lines(size_t first, size_t last, std::string_view text) {
+	if (first >= last || last > line_count()) {
+		throw std::out_of_range("Edited lines are outside of the source.");
+	}
+	const uint32_t begin = lineStarts[first];
+	std::string_view lastLine = line(last - 1);
+	const uint32_t end = static_cast<uint32_t>(lastLine.data() + lastLine.length() - base);
+	if (static_cast<uint64_t>(size) - (end - begin) + text.size() >= std::numeric_limits<uint32_t>::max()) {
+		throw std::length_error("Source file exceeds 4 GB.");
+	}
+
+	// Edits always go to owned memory
+	if (mapBase) {
+		owned.assign(base, size);
+		unmap();
+	}
+	owned.replace(begin, end - begin, text.data(), text.size());
+	base = owned.data();
+	size = static_cast<uint32_t>(owned.size());
+
+	// Index the replacement and move the following lines
+	std::vector<uint32_t> starts{};
+	index_newlines(base, begin, begin + static_cast<uint32_t>(text.size()), starts);
+	const uint32_t shift = static_cast<uint32_t>(text.size()) - (end - begin);
+	if (shift != 0) {
+		for (size_t i = last; i < lineStarts.size(); ++i) {
+			lineStarts[i] += shift;
+		}
+	}
+	const size_t removed = last - first - 1;
+	const size_t common = std::min(removed, starts.size());
+	std::copy(starts.begin(), starts.begin() + common, lineStarts.begin() + first + 1);
+	if (removed > common) {
+		lineStarts.erase(lineStarts.begin() + first + 1 + common, lineStarts.begin() + last);
+	}
+	else {
+		lineStarts.insert(lineStarts.begin() + first + 1 + common, starts.begin() + common, starts.end());
+	}
+	return starts.size() + 1;
+}
+
+
+// Gets the line containing an offset in the buffer. Offsets past the end
+// give the last line.
+//
+// Error Handling:
+//	+ Never throws.
+size_t Source_Buffer::line_of(uint32_t offset) const noexcept {
+	auto it = std::upper_bound(lineStarts.begin(), lineStarts.end() - 1, offset);
+	return (it == lineStarts.begin()) ? 0 : static_cast<size_t>(it - lineStarts.begin()) - 1;
+}
+
+
+// Gets the line and column of an offset in the buffer by a binary search
+// of the line starts. Offsets past the end are placed on the last line.
+//
+// Error Handling:
+//	+ Never throws.
+Source_Location Source_Buffer::location(uint32_t offset) const noexcept {
+	size_t line = line_of(offset);
+	uint32_t begin = lineStarts[line];
+	return { line, (offset > begin) ? offset - begin : 0 };
+}
+
+
+// Releases a memory map, if any.
+void Source_Buffer::unmap() noexcept {
+	if (mapBase) {
+#if defined(_WIN32)
+		UnmapViewOfFile(mapBase);
+#else
+		munmap(const_cast<char*>(mapBase), size);
+#endif
+		mapBase = nullptr;
+		base = owned.data();
+	}
+}
+
+
+// Builds lineStarts for the current text.
+void Source_Buffer::index_lines() {
+	// Skip the byte order mark
+	uint32_t begin = 0;
+	if (size >= 3 && std::memcmp(base, "\xEF\xBB\xBF", 3) == 0) {
+		begin = 3;
+	}
+
+	lineStarts.clear();
+	lineStarts.reserve(size / 32 + 2);
+	lineStarts.push_back(begin);
+	index_newlines(base, begin, size, lineStarts);
+	lineStarts.push_back(size + 1);
+}
+
+
+// Finds newlines one character at a time.
+static void index_newlines_scalar(const char* data, uint32_t begin, uint32_t end, std::vector<uint32_t>& starts) {
+	const char* p = data + begin;
+	const char* last = data + end;
+	while ((p = static_cast<const char*>(std::memchr(p, '\n', last - p))) != nullptr) {
+		p += 1;
+		starts.push_back(static_cast<uint32_t>(p - data));
+	}
+}
+
+
+#if SIMD_X86
+// Finds newlines 16 characters at a time. SSE2 is part of x86-64.
+static void index_newlines_sse2(const char* data, uint32_t begin, uint32_t end, std::vector<uint32_t>& starts) {
+	const __m128i newline = _mm_set1_epi8('\n');
+	uint32_t i = begin;
+	for (; i + 16 <= end; i += 16) {
+		__m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+		uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(v, newline)));
+		while (mask != 0) {
+			starts.push_back(i + count_trailing_zeros(mask) + 1);
+			mask &= mask - 1;
+		}
+	}
+	index_newlines_scalar(data, i, end, starts);
+}
+
+
+// Finds newlines 32 characters at a time.
+TARGET_AVX2 static void index_newlines_avx2(const char* data, uint32_t begin, uint32_t end, std::vector<uint32_t>& starts) {
+	const __m256i newline = _mm256_set1_epi8('\n');
+	uint32_t i = begin;
+	for (; i + 32 <= end; i += 32) {
+		__m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+		uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, newline)));
+		while (mask != 0) {
+			starts.push_back(i + count_trailing_zeros(mask) + 1);
+			mask &= mask - 1;
+		}
+	}
+	index_newlines_scalar(data, i, end, starts);
+}
+#endif
+
+
+// Signature shared by every implementation.
+using Index_Function = void(*)(const char*, uint32_t, uint32_t, std::vector<uint32_t>&);
+
+
+// Picks the widest implementation the processor supports.
+static Index_Function select_index_newlines() {
+#if SIMD_X86
+	if (cpu_features().avx2) {
+		return index_newlines_avx2;
+	}
+	return index_newlines_sse2;
+#else
+	return index_newlines_scalar;
+#endif
+}
+
+
+// Selected once at startup.
+static const Index_Function index_newlines_impl = select_index_newlines();
+
+
+// Appends the offset following every newline in data[begin, end) to starts.
+// Uses AVX2 or SSE2 when available, selected once at startup.
+void index_newlines(const char* data, uint32_t begin, uint32_t end, std::vector<uint32_t>& starts) {
+	index_newlines_impl(data, begin, end, starts);
+}
+
+
+/******************************************************************************
+
+This software is provided under two licenses. Choose whichever you prefer.
+
+
+============================= Apache License V2.0 =============================
+
+Copyright 2020 Matthew Roever
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+	http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+
+================================= MIT License =================================
+
+Copyright (c) 2020 Matthew Roever
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+******************************************************************************/
\ No newline at end of file
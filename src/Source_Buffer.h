@@ -0,0 +1,213 @@
+// File:		Source_Buffer.h
+// Language:	C++17
+// Purpose:		Contiguous source text with a line offset index.
+// License:		At bottom of document.
+
+#ifndef SOURCE_BUFFER_H
+#define SOURCE_BUFFER_H
+
+// STL
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <vector>
+
+
+// How the text of a Source_Buffer is held.
+enum class Load_Mode {
+	OWNED,		// Copied into memory owned by the buffer
+	MAPPED		// Read-only memory map of the file
+};
+
+
+// Line and column of an offset in a Source_Buffer, both counted from 0. The
+// column is in bytes.
+struct Source_Location {
+	size_t line = 0;
+	uint32_t column = 0;
+};
+
+
+// Source text held in a single buffer. Lines are located through an index of
+// line start offsets instead of being copied into their own strings.
+class Source_Buffer {
+public:
+	Source_Buffer() = default;
+	Source_Buffer(const Source_Buffer&) = delete;
+	Source_Buffer(Source_Buffer&& other) noexcept;
+	Source_Buffer& operator=(const Source_Buffer&) = delete;
+	Source_Buffer& operator=(Source_Buffer&& other) noexcept;
+	~Source_Buffer();
+
+
+	// Takes ownership of the text and indexes its lines. A leading UTF-8 byte
+	// order mark is skipped. Text that is not valid UTF-8 is kept, the scanner
+	// reports it.
+	//
+	// Error Handling:
+	//	+ Throws std::length_error if the text does not fit 32 bit offsets.
+	void assign(std::string text);
+
+
+	// Loads a file and indexes its lines. Regular files are memory mapped
+	// read-only when allowMap is set, pipes and other special files (or a
+	// failed map) fall back to reading the file into owned memory.
+	//
+	// Error Handling:
+	//	+ Throws std::runtime_error if the file cannot be opened or read.
+	//	+ Throws std::length_error if the file does not fit 32 bit offsets.
+	void load(const std::filesystem::path& path, bool allowMap = true);
+
+
+	// Replaces the text from the start of line first to the end of line
+	// last - 1 with text. The line terminator of line last - 1 is kept, the
+	// replacement may hold any number of newlines. A mapped buffer is copied
+	// into owned memory first. Returns the number of lines replacing
+	// [first, last), which is always at least one.
+	//
+	// Error Handling:
+	//	+ Throws std::out_of_range if the lines are not 0 <= first < last <= line_count().
+	//	+ Throws std::length_error if the edited text does not fit 32 bit offsets.
+	size_t replace_lines(size_t first, size_t last, std::string_view text);
+
+
+	// Gets how the text is held.
+	//
+	// Error Handling:
+	//	+ Never throws.
+	Load_Mode mode() const noexcept {
+		return mapBase ? Load_Mode::MAPPED : Load_Mode::OWNED;
+	}
+
+
+	// Gets the number of lines. There is always at least one line, a trailing
+	// newline starts an empty last line.
+	//
+	// Error Handling:
+	//	+ Never throws.
+	size_t line_count() const noexcept {
+		return lineStarts.size() - 1;
+	}
+
+
+	// Gets a line without its line terminator (\n or \r\n). The view is valid
+	// until the buffer is modified.
+	//
+	// Error Handling:
+	//	+ Never throws. The line must be less than line_count().
+	std::string_view line(size_t i) const noexcept {
+		uint32_t begin = lineStarts[i];
+		uint32_t end = lineStarts[i + 1] - 1;
+		if (end > begin && base[end - 1] == '\r') {
+			end -= 1;
+		}
+		return std::string_view(base + begin, end - begin);
+	}
+
+
+	// Gets the offset of the first character of a line in the buffer.
+	//
+	// Error Handling:
+	//	+ Never throws. The line must be less than line_count().
+	uint32_t line_begin(size_t i) const noexcept {
+		return lineStarts[i];
+	}
+
+
+	// Gets the line containing an offset in the buffer. Offsets past the end
+	// give the last line.
+	//
+	// Error Handling:
+	//	+ Never throws.
+	size_t line_of(uint32_t offset) const noexcept;
+
+
+	// Gets the line and column of an offset in the buffer by a binary search
+	// of the line starts. Offsets past the end are placed on the last line.
+	//
+	// Error Handling:
+	//	+ Never throws.
+	Source_Location location(uint32_t offset) const noexcept;
+
+
+	// Gets the entire buffer, including line terminators.
+	//
+	// Error Handling:
+	//	+ Never throws.
+	std::string_view text() const noexcept {
+		return std::string_view(base, size);
+	}
+
+private:
+	// Releases a memory map, if any.
+	void unmap() noexcept;
+
+
+	// Builds lineStarts for the current text.
+	void index_lines();
+
+
+	std::string owned{};
+	const char* mapBase = nullptr;
+	const char* base = owned.data();
+	uint32_t size = 0;
+
+	// Start offset of every line, followed by one past the end of the buffer
+	// so the end of line i is always lineStarts[i + 1] - 1.
+	std::vector<uint32_t> lineStarts{ 0, 1 };
+};
+
+
+// Appends the offset following every newline in data[begin, end) to starts.
+// Uses AVX2 or SSE2 when available, selected once at startup.
+void index_newlines(const char* data, uint32_t begin, uint32_t end, std::vector<uint32_t>& starts);
+
+#endif
+
+
+/******************************************************************************
+
+This software is provided under two licenses. Choose whichever you prefer.
+
+
+============================= Apache License V2.0 =============================
+
+Copyright 2020 Matthew Roever
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+	http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+
+================================= MIT License =================================
+
+Copyright (c) 2020 Matthew Roever
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+******************************************************************************/
\ No newline at end of file
@@ -7,9 +7,17 @@
 // Header
 #include "Source_Code.h"
 
+// STL
+#include <stdexcept>
+#include <utility>
+
 // Internal
+#include "Hash.h"
 #include "IO_Functions.h"
+#include "Memory_Stats.h"
+#include "Scanner_Support.h"
 #include "Timer.h"
+#include "Token_Stream.h"
 
 
 /**************************************************************************
@@ -18,42 +26,202 @@
 *
 *************************************************************************/
 
-// Loads an ascii file for compiling.
-Source_Code::Source_Code(const std::filesystem::path path) {
-	load_code(path);
+// Loads a UTF-8 file for compiling. The file is memory mapped unless
+// allowMap is false. Words are interned in symbols, numbers in constants
+// and string literals in strings. The pools may be shared with other files
+// and must outlive this one.
+Source_Code::Source_Code(const std::filesystem::path path, Symbol_Table& symbols, Constant_Pool& constants,
+	String_Pool& strings, bool allowMap) :
+	symbols(&symbols), constants(&constants), strings(&strings), scanner(symbols, constants, strings) {
+	load_code(path, allowMap);
+}
+
+
+// Copies the string literals that still view the code into the pool.
+Source_Code::~Source_Code() {
+	std::string_view text = code.text();
+	strings->detach(text.data(), text.data() + text.length());
 }
 
 
-// Loads an ascii file for compiling.
-void Source_Code::load_code(const std::filesystem::path path) {
+// Loads a UTF-8 file for compiling. The file is memory mapped unless
+// allowMap is false.
+void Source_Code::load_code(const std::filesystem::path path, bool allowMap) {
 	Timer t{};
 	t.start();
+	code.load(path, allowMap);
+
+	t.stop();
+	time_loadFile = static_cast<double>(t.duration()) / 1'000'000;
+}
+
+
+// Keeps the output of each phase in an artifact store, and uses the
+// output stored by an earlier run for the same code in place of running
+// the phase. flags are the options that change the output of any phase.
+// The store may be shared with other files and must outlive this one.
+void Source_Code::use_artifacts(Artifact_Cache& artifacts, std::string flags) {
+	this->artifacts = &artifacts;
+	artifactFlags = std::move(flags);
+}
+
+
+// Runs the scanner on the loaded code. More than one thread scans the code
+// in parallel chunks, the results are the same for any thread count. With
+// an artifact store the stored tokens are used if there are any, else the
+// tokens are stored once scanned.
+void Source_Code::run_scanner(uint32_t threads) {
+	std::string key{};
+	if (artifacts != nullptr) {
+		std::string_view text = code.text();
+		key = Artifact_Cache::key(xxhash64(text.data(), text.length()), "tokens", TOKEN_CACHE_VERSION,
+			artifactFlags);
+		std::filesystem::path found = artifacts->find(key);
+		if (!found.empty()) {
+			if (load_tokens(found)) {
+				return;
+			}
+			artifacts->reject();
+		}
+	}
 
-	// Open file
-	std::ifstream iFile{ path };
-	if (!iFile.is_open()) {
-		throw std::runtime_error("Could not open file: " + path.filename().generic_string());
+	Timer t{};
+	uint64_t allocations = allocation_count();
+	t.start();
+	cache.close();
+	streamed = false;
+	streamedTokens = 0;
+	if (threads > 1) {
+		Thread_Pool pool{ threads };
+		scanner.scan(code, scannerOutput, &pool);
 	}
+	else {
+		scanner.scan(code, scannerOutput);
+	}
+	output = scannerOutput.view();
+	t.stop();
+	scanAllocations = allocation_count() - allocations;
+	time_scanFile = static_cast<double>(t.duration()) / 1'000'000;
 
-	// Load lines individually.
-	std::string line{};
-	while (!iFile.eof()) {
-		std::getline(iFile, line);
-		code.push_back(std::move(line));
+	if (artifacts != nullptr) {
+		artifacts->store(key, [this](const std::filesystem::path& path) {
+			emit_tokens(path);
+		});
 	}
+}
 
+
+// Replaces lines [first, last) with text and rescans the lines affected by
+// the edit. See Source_Buffer::replace_lines for how the text is placed.
+void Source_Code::edit(size_t first, size_t last, std::string_view text) {
+	Timer t{};
+	t.start();
+	std::string_view old = code.text();
+	strings->detach(old.data(), old.data() + old.length());
+	size_t inserted = code.replace_lines(first, last, text);
+
+	// Only a full scan has the lines to update
+	if (streamed || cache.is_open() ||
+		scannerOutput.lines.size() + inserted != code.line_count() + (last - first)) {
+		cache.close();
+		streamed = false;
+		streamedTokens = 0;
+		scanner.scan(code, scannerOutput);
+	}
+	else {
+		scanner.rescan(code, first, last - first, inserted, scannerOutput);
+	}
+	output = scannerOutput.view();
 	t.stop();
-	time_loadFile = static_cast<double>(t.duration()) / 1'000'000;
+	time_edit = static_cast<double>(t.duration()) / 1'000'000;
+}
+
+
+// Runs the scanner as a token stream. Tokens are counted but lexemes and
+// tokens are not stored, print_tokens streams them again. Problems are
+// reported as by a full scan, apart from unmatched brackets.
+void Source_Code::stream_scanner() {
+	Timer t{};
+	uint64_t allocations = allocation_count();
+	t.start();
+	cache.close();
+	scannerOutput = Scanner_Results{};
+	output = scannerOutput.view();
+	Token_Stream stream{ code, *symbols, *constants, *strings };
+	Diagnostics& diagnostics = scannerOutput.diagnostics;
+
+	// Bytes that are not UTF-8 are reported before the problems after them
+	const std::string_view text = code.text();
+	const uint32_t textEnd = static_cast<uint32_t>(text.length());
+	uint32_t runEnd = 0;
+	uint32_t run = find_invalid_utf8(text, 0, textEnd, runEnd);
+	auto report_bytes = [&](uint32_t offset) {
+		while (run < offset && run < textEnd) {
+			diagnostics.report(Severity::ERROR, run, runEnd - run, "Invalid UTF-8.");
+			run = find_invalid_utf8(text, runEnd, textEnd, runEnd);
+		}
+	};
+
+	Token tok{};
+	Token next{};
+	char quote = 0;
+	size_t count = 0;
+	while (stream.next(tok)) {
+		count += 1;
+		const bool hasNext = tok.type == Token_Type::STRING && stream.peek(next);
+		const char* problem = token_problem(text, tok, hasNext ? &next : nullptr, quote, *constants);
+		if (problem) {
+			report_bytes(tok.offset);
+			diagnostics.report(Severity::ERROR, tok.offset, tok.length, problem);
+		}
+	}
+	uint32_t comment = 0;
+	if (stream.open_comment(comment)) {
+		report_bytes(comment);
+		diagnostics.report(Severity::ERROR, comment, 2, "Block comment is never closed.");
+	}
+	report_bytes(textEnd);
+	streamed = true;
+	streamedTokens = count;
+	t.stop();
+	scanAllocations = allocation_count() - allocations;
+	time_scanFile = static_cast<double>(t.duration()) / 1'000'000;
 }
 
 
-// Runs the scanner on the loaded code.
-void Source_Code::run_scanner() {
+// Uses the scanner output of a token cache file in place of running the
+// scanner, if the file was written for the loaded code. Returns false if
+// the file can not be used, the code must then be scanned.
+bool Source_Code::load_tokens(const std::filesystem::path& path) {
 	Timer t{};
+	uint64_t allocations = allocation_count();
 	t.start();
-	scannerOutput = scan(code);
+	streamed = false;
+	streamedTokens = 0;
+	scannerOutput = Scanner_Results{};
+	output = scannerOutput.view();
+	if (!cache.open(path, code, *symbols, *constants, *strings)) {
+		return false;
+	}
+	cache.restore(scannerOutput.diagnostics);
+	output = cache.view();
 	t.stop();
+	scanAllocations = allocation_count() - allocations;
 	time_scanFile = static_cast<double>(t.duration()) / 1'000'000;
+	return true;
+}
+
+
+// Writes the scanner output to a token cache file.
+//
+// Error Handling:
+//	+ Throws std::runtime_error if the tokens were streamed or the file can
+//	  not be written.
+void Source_Code::emit_tokens(const std::filesystem::path& path) const {
+	if (streamed) {
+		throw std::runtime_error("Tokens are not stored when streaming, they can not be written to a cache.");
+	}
+	write_token_cache(path, code, output, scannerOutput.diagnostics, *symbols, *constants, *strings);
 }
 
 
@@ -66,10 +234,10 @@ void Source_Code::run_scanner() {
 // Prints the code loaded from a file.
 void Source_Code::print_file() const {
 	std::cout << "==================== Source Code ====================\n";
-	size_t numPad = std::to_string(code.size()).length();
-	for (size_t i = 0; i < code.size(); ++i) {
+	size_t numPad = std::to_string(code.line_count()).length();
+	for (size_t i = 0; i < code.line_count(); ++i) {
 		print_number_pad(i + 1, numPad);
-		std::cout << ": " << code[i] << "\n";
+		std::cout << ": " << code.line(i) << "\n";
 	}
 	std::cout << "\n";
 }
@@ -78,8 +246,12 @@ void Source_Code::print_file() const {
 // Prints the time it took for various compiler components to run.
 void Source_Code::print_time() const {
 	std::cout << "==================== Compiler Timing ====================\n";
-	std::cout << "Load file (ms): " << time_loadFile << "\n";
-	std::cout << "Scan file (ms): " << time_scanFile << "\n";
+	std::cout << "Load file (ms): " << time_loadFile;
+	std::cout << (code.mode() == Load_Mode::MAPPED ? " (mapped)\n" : " (read)\n");
+	std::cout << "Scan file (ms): " << time_scanFile << (cache.is_open() ? " (token cache)\n" : "\n");
+	if (time_edit != 0) {
+		std::cout << "Last edit (ms): " << time_edit << "\n";
+	}
 	std::cout << "\n";
 }
 
@@ -87,17 +259,38 @@ void Source_Code::print_time() const {
 // Prints statistics from the compiler.
 void Source_Code::print_stats() const {
 	std::cout << "==================== Compiler Stats ====================\n";
-	std::cout << "Lines scanned: " << scannerOutput.lines.size() << "\n";
-	size_t lexemes = 0;
-	for (const auto& l : scannerOutput.lines) {
-		lexemes += l.lexemes.size();
+	if (artifacts != nullptr) {
+		std::cout << "Artifact cache: " << artifacts->hits() << " hits, " << artifacts->misses() << " misses, ";
+		std::cout << artifacts->stores() << " stored, " << artifacts->evictions() << " evicted\n";
+	}
+	if (streamed) {
+		std::cout << "Lines scanned: " << code.line_count() << "\n";
+		std::cout << "Tokens: " << streamedTokens << "\n";
+		std::cout << "Symbols: " << symbols->size() << "\n";
+		std::cout << "Constants: " << constants->size() << "\n";
+		std::cout << "String literals: " << strings->size() << " (" << strings->copied_bytes() << " bytes copied)\n";
+		std::cout << "Scan allocations: " << scanAllocations << "\n";
+		std::cout << "\n";
+		return;
 	}
-	std::cout << "Lexmes: " << lexemes << "\n";
-	size_t tokens = 0;
-	for (const auto& t : scannerOutput.tokens) {
-		tokens += t.size();
+	std::cout << "Lines scanned: " << output.lineCount << "\n";
+	std::cout << "Lexmes: " << output.lexemeCount << "\n";
+	std::cout << "Tokens: " << output.tokenCount << "\n";
+	std::cout << "Statements: " << output.statementCount << "\n";
+	std::cout << "Unmatched brackets: " << output.unmatchedCount << "\n";
+	std::cout << "Symbols: " << symbols->size() << "\n";
+	std::cout << "Constants: " << constants->size() << "\n";
+	std::cout << "String literals: " << strings->size() << " (" << strings->copied_bytes() << " bytes copied)\n";
+
+	// Estimate for a vector of lexemes per line, grown by doubling
+	uint64_t lineAllocations = 0;
+	for (uint32_t i = 0; i < output.lineCount; ++i) {
+		for (uint32_t capacity = 1; capacity / 2 < output.lines[i].lexemeCount; capacity *= 2) {
+			lineAllocations += 1;
+		}
 	}
-	std::cout << "Tokens: " << tokens << "\n";
+	std::cout << "Scan allocations: " << scanAllocations << "\n";
+	std::cout << "Scan allocations with a vector per line (estimate): " << scanAllocations + lineAllocations << "\n";
 	std::cout << "\n";
 }
 
@@ -105,19 +298,25 @@ void Source_Code::print_stats() const {
 // Prints the lexemes found by the scanner.
 void Source_Code::print_lexemes() const {
 	std::cout << "==================== Scanner Lexemes ====================\n";
-	size_t numPad = std::to_string(code.size()).length();
+	if (streamed) {
+		std::cout << "Lexemes are not stored when streaming tokens.\n\n";
+		return;
+	}
+	size_t numPad = std::to_string(code.line_count()).length();
 	size_t linePad = 11 - numPad;
-	for (size_t i = 0; i < scannerOutput.lines.size(); ++i) {
+	for (size_t i = 0; i < output.lineCount; ++i) {
 		print_number_pad(i + 1, numPad);
 		std::cout << ":";
 		print_symbol(linePad, '-');
-		std::cout << " " << scannerOutput.lines[i].text << "\n";
-		for (const auto& l : scannerOutput.lines[i].lexemes) {
+		std::string_view line = code.line(i);
+		std::cout << " " << line << "\n";
+		for (uint32_t j = 0; j < output.lines[i].lexemeCount; ++j) {
+			const Lexeme& l = output.lexeme(i, j);
 			std::cout << " [ ";
 			print_number_pad(l.begin, 3);
 			std::cout << ", ";
 			print_number_pad(l.end, 3);
-			std::cout << ") " << scannerOutput.lines[i].text.substr(l.begin, l.end - l.begin) << "\n";
+			std::cout << ") " << line.substr(l.begin, l.end - l.begin) << "\n";
 		}
 	}
 	std::cout << "\n";
@@ -127,43 +326,79 @@ void Source_Code::print_lexemes() const {
 // Prints the tokens produced by the scanner.
 void Source_Code::print_tokens() const {
 	std::cout << "==================== Scanner Tokens ====================\n";
-	size_t count = 0;
-	for (const auto& toks : scannerOutput.tokens) {
-		count += toks.size();
-	}
+	size_t count = streamedTokens + output.tokenCount;
 	size_t numPad = std::to_string(count).length();
 	count = 0;
-	for (const auto& toks : scannerOutput.tokens) {
-		for (const auto& tok : toks) {
-			print_number_pad(count++, numPad);
-			std::cout << ": " << tok.type;
-
-			// Subtype
-			switch (tok.type) {
-			case Token_Type::KEYWORD: std::cout << tok.subtype.key; break;
-			case Token_Type::NUMBER: {
-				std::cout << tok.subtype.num << " ";
-				Lexeme lex = scannerOutput.lines[tok.lineNumber].lexemes.at(tok.lexeme);
-				std::cout << scannerOutput.lines[tok.lineNumber].text.substr(lex.begin, lex.end - lex.begin);
-			} break;
-			case Token_Type::OPERATOR: std::cout << tok.subtype.op; break;
-			case Token_Type::STRING: {
-				std::cout << tok.subtype.str << " ";
-				Lexeme lex = scannerOutput.lines[tok.lineNumber].lexemes.at(tok.lexeme);
-				std::cout << scannerOutput.lines[tok.lineNumber].text.substr(lex.begin, lex.end - lex.begin);
-			} break;
-			case Token_Type::WORD: {
-				Lexeme lex = scannerOutput.lines[tok.lineNumber].lexemes.at(tok.lexeme);
-				std::cout << scannerOutput.lines[tok.lineNumber].text.substr(lex.begin, lex.end - lex.begin);
-			} break;
+	auto print = [&](const Token& tok) {
+		print_number_pad(count++, numPad);
+		std::cout << ": " << tok.type;
+
+		// Subtype
+		switch (tok.type) {
+		case Token_Type::EOL: break;
+		case Token_Type::ERROR: std::cout << token_text(code, tok); break;
+		case Token_Type::KEYWORD: std::cout << tok.subtype.key; break;
+		case Token_Type::NUMBER: {
+			Constant c = constants->get(tok.subtype.constant);
+			std::cout << c.type << " " << token_text(code, tok);
+			if (c.overflow) {
+				std::cout << " (overflow)";
 			}
-			std::cout << "\n";
+		} break;
+		case Token_Type::OPERATOR: std::cout << tok.subtype.op; break;
+		case Token_Type::STRING: {
+			std::cout << strings->type(tok.subtype.literal) << " " << token_text(code, tok);
+		} break;
+		case Token_Type::WORD: std::cout << symbols->text(tok.subtype.symbol); break;
+		}
+		std::cout << "\n";
+	};
+
+	// Tokens were not stored, scan them again
+	if (streamed) {
+		Token_Stream stream{ code, *symbols, *constants, *strings };
+		Token tok{};
+		while (stream.next(tok)) {
+			print(tok);
+		}
+	}
+	else {
+		for (size_t i = 0; i < output.tokenCount; ++i) {
+			print(output.token(i));
 		}
 	}
 	std::cout << "\n";
 }
 
 
+// Prints the problems found by the scanner, each with its line and the text
+// it refers to marked. Prints nothing if there are none.
+void Source_Code::print_diagnostics() const {
+	const Diagnostics& diagnostics = scannerOutput.diagnostics;
+	if (diagnostics.empty()) {
+		return;
+	}
+	std::cout << "==================== Diagnostics ====================\n";
+	for (const Diagnostic& d : diagnostics.entries()) {
+		Source_Location at = code.location(d.offset);
+		std::cout << d.severity << " on line " << at.line + 1 << ", column " << at.column + 1 << ": " << d.message
+			<< "\n";
+		print_marked_lexeme(code.line(at.line), { at.column, at.column + d.length });
+	}
+	if (diagnostics.dropped()) {
+		std::cout << diagnostics.dropped() << " more not shown.\n";
+	}
+	std::cout << diagnostics.count(Severity::ERROR) << " errors, " << diagnostics.count(Severity::WARNING)
+		<< " warnings\n\n";
+}
+
+
+// Gets the number of errors found by the scanner.
+size_t Source_Code::error_count() const {
+	return scannerOutput.diagnostics.count(Severity::ERROR);
+}
+
+
 /******************************************************************************
 
 This software is provided under two licenses. Choose whichever you prefer.
@@ -12,10 +12,17 @@
 #include <fstream>
 #include <iostream>
 #include <string>
+#include <string_view>
 #include <vector>
 
 // Internal
+#include "Artifact_Cache.h"
+#include "Constant_Pool.h"
 #include "Scanner.h"
+#include "Source_Buffer.h"
+#include "String_Pool.h"
+#include "Symbol_Table.h"
+#include "Token_Cache.h"
 
 
 class Source_Code {
@@ -27,16 +34,60 @@ public:
 	*
 	*************************************************************************/
 
-	// Loads an ascii file for compiling.
-	Source_Code(const std::filesystem::path path);
+	// Loads a UTF-8 file for compiling. The file is memory mapped unless
+	// allowMap is false. Words are interned in symbols, numbers in constants
+	// and string literals in strings. The pools may be shared with other files
+	// and must outlive this one.
+	Source_Code(const std::filesystem::path path, Symbol_Table& symbols, Constant_Pool& constants,
+		String_Pool& strings, bool allowMap = true);
 
 
-	// Loads an ascii file for compiling.
-	void load_code(const std::filesystem::path path);
+	// Copies the string literals that still view the code into the pool.
+	~Source_Code();
 
 
-	// Runs the scanner on the loaded code.
-	void run_scanner();
+	// Loads a UTF-8 file for compiling. The file is memory mapped unless
+	// allowMap is false.
+	void load_code(const std::filesystem::path path, bool allowMap = true);
+
+
+	// Keeps the output of each phase in an artifact store, and uses the
+	// output stored by an earlier run for the same code in place of running
+	// the phase. flags are the options that change the output of any phase.
+	// The store may be shared with other files and must outlive this one.
+	void use_artifacts(Artifact_Cache& artifacts, std::string flags = {});
+
+
+	// Runs the scanner on the loaded code. More than one thread scans the code
+	// in parallel chunks, the results are the same for any thread count. With
+	// an artifact store the stored tokens are used if there are any, else the
+	// tokens are stored once scanned.
+	void run_scanner(uint32_t threads = 1);
+
+
+	// Replaces lines [first, last) with text and rescans the lines affected by
+	// the edit. See Source_Buffer::replace_lines for how the text is placed.
+	void edit(size_t first, size_t last, std::string_view text);
+
+
+	// Runs the scanner as a token stream. Tokens are counted but lexemes and
+	// tokens are not stored, print_tokens streams them again. Problems are
+	// reported as by a full scan, apart from unmatched brackets.
+	void stream_scanner();
+
+
+	// Uses the scanner output of a token cache file in place of running the
+	// scanner, if the file was written for the loaded code. Returns false if
+	// the file can not be used, the code must then be scanned.
+	bool load_tokens(const std::filesystem::path& path);
+
+
+	// Writes the scanner output to a token cache file.
+	//
+	// Error Handling:
+	//	+ Throws std::runtime_error if the tokens were streamed or the file can
+	//	  not be written.
+	void emit_tokens(const std::filesystem::path& path) const;
 
 
 	/**************************************************************************
@@ -64,13 +115,36 @@ public:
 	// Prints the tokens produced by the scanner.
 	void print_tokens() const;
 
+
+	// Prints the problems found by the scanner, each with its line and the text
+	// it refers to marked. Prints nothing if there are none.
+	void print_diagnostics() const;
+
+
+	// Gets the number of errors found by the scanner.
+	size_t error_count() const;
+
 private:
-	std::vector<std::string> code{};
+	Source_Buffer code{};
+	Symbol_Table* symbols = nullptr;
+	Constant_Pool* constants = nullptr;
+	String_Pool* strings = nullptr;
+	Scanner scanner;
 	Scanner_Results scannerOutput{};
+	Token_Cache cache{};
+	Scanner_View output{};
+	Artifact_Cache* artifacts = nullptr;
+	std::string artifactFlags{};
+	bool streamed = false;
+	size_t streamedTokens = 0;
 
 	// Run time
 	double time_loadFile = 0;
 	double time_scanFile = 0;
+	double time_edit = 0;
+
+	// Heap allocations made by the scanner
+	uint64_t scanAllocations = 0;
 };
 
 #endif
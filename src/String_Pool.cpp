@@ -0,0 +1,258 @@
+// File:		String_Pool.cpp
+// Language:	C++17
+// Purpose:		Decodes string literals and stores each distinct literal once.
+// License:		At bottom of document.
+
+// Header
+#include "String_Pool.h"
+
+// STL
+#include <stdexcept>
+
+// Internal
+#include "Hash.h"
+
+
+// Gets the value of a hex digit, or -1 if the character is not one.
+static int hex_value(char c) noexcept {
+	if (c >= '0' && c <= '9') {
+		return c - '0';
+	}
+	if (c >= 'a' && c <= 'f') {
+		return c - 'a' + 10;
+	}
+	if (c >= 'A' && c <= 'F') {
+		return c - 'A' + 10;
+	}
+	return -1;
+}
+
+
+// Appends the text of a literal to out with escape sequences resolved. The
+// escapes are \n, \t, \r, \0, \\, \', \" and \x followed by two hex digits.
+// Any other backslash is kept as written.
+void decode_string(std::string_view text, std::string& out) {
+	size_t i = 0;
+	while (i < text.length()) {
+		// Copy up to the next escape
+		size_t slash = text.find('\\', i);
+		if (slash == std::string_view::npos || slash + 1 == text.length()) {
+			out.append(text.data() + i, text.length() - i);
+			return;
+		}
+		out.append(text.data() + i, slash - i);
+
+		// Resolve the escape
+		char c = text[slash + 1];
+		i = slash + 2;
+		switch (c) {
+		case 'n': out.push_back('\n'); break;
+		case 't': out.push_back('\t'); break;
+		case 'r': out.push_back('\r'); break;
+		case '0': out.push_back('\0'); break;
+		case '\\': case '\'': case '"': out.push_back(c); break;
+		case 'x': {
+			int high = (i < text.length()) ? hex_value(text[i]) : -1;
+			int low = (i + 1 < text.length()) ? hex_value(text[i + 1]) : -1;
+			if (high >= 0 && low >= 0) {
+				out.push_back(static_cast<char>(high * 16 + low));
+				i += 2;
+			}
+			else {
+				out.append(text.data() + slash, 2);
+			}
+		} break;
+		default: out.append(text.data() + slash, 2); break;
+		}
+	}
+}
+
+
+// Gets the index of a literal, copying the text if it is new.
+//
+// Error Handling:
+//	+ Throws std::length_error if the pool runs out of 32 bit indices.
+uint32_t String_Pool::add(std::string_view text, String_Type type) {
+	return add(text, type, true);
+}
+
+
+// Gets the index of a literal, keeping a view of the text if it is new.
+// The text must stay valid until it is passed to detach.
+//
+// Error Handling:
+//	+ Throws std::length_error if the pool runs out of 32 bit indices.
+uint32_t String_Pool::add_view(std::string_view text, String_Type type) {
+	return add(text, type, text.empty());
+}
+
+
+// Copies the text of every literal viewing [begin, end) into the pool, so
+// the memory can change or be released once detach returns. Other threads
+// may use the pool meanwhile, text they get is either the view or the
+// copy.
+void String_Pool::detach(const char* begin, const char* end) {
+	for (Shard& shard : shards) {
+		std::lock_guard<std::mutex> guard{ shard.lock };
+		size_t kept = 0;
+		for (uint32_t literal : shard.views) {
+			Entry& e = entries.at(literal);
+			std::string_view text(e.text.load(std::memory_order_relaxed), e.length);
+			if (text.data() < begin || text.data() >= end) {
+				shard.views[kept++] = literal;
+				continue;
+			}
+
+			// Point the slot and the entry at a copy with the same text, so a
+			// reader sees the same literal through either pointer
+			std::string_view stored = store(shard, text);
+			uint32_t hash = crc32c(static_cast<uint32_t>(e.type), text.data(), text.length());
+			size_t mask = shard.slots.size() - 1;
+			size_t i = hash & mask;
+			while (shard.slots[i].literal != literal) {
+				i = (i + 1) & mask;
+			}
+			shard.slots[i].text = stored.data();
+			e.text.store(stored.data(), std::memory_order_release);
+		}
+		shard.views.resize(kept);
+	}
+}
+
+
+// Gets the decoded text of a literal. The view is valid for the life of
+// the pool, or until its source is detached.
+//
+// Error Handling:
+//	+ Never throws. The index must have been returned by add or add_view.
+std::string_view String_Pool::text(uint32_t literal) const noexcept {
+	const Entry& e = entries[literal];
+	return std::string_view(e.text.load(std::memory_order_acquire), e.length);
+}
+
+
+// Gets the quote type of a literal.
+//
+// Error Handling:
+//	+ Never throws. The index must have been returned by add or add_view.
+String_Type String_Pool::type(uint32_t literal) const noexcept {
+	return entries[literal].type;
+}
+
+
+// Gets the index of a literal, adding it if it is new.
+uint32_t String_Pool::add(std::string_view text, String_Type type, bool copy) {
+	// The quote type seeds the hash so both types of a text may be stored
+	uint32_t hash = crc32c(static_cast<uint32_t>(type), text.data(), text.length());
+	Shard& shard = shards[hash >> (32 - SHARD_BITS)];
+	std::lock_guard<std::mutex> guard{ shard.lock };
+	if (shard.slots.empty()) {
+		shard.slots.resize(256);
+	}
+
+	// Linear probe for the literal
+	size_t mask = shard.slots.size() - 1;
+	size_t i = hash & mask;
+	for (; shard.slots[i].literal != EMPTY; i = (i + 1) & mask) {
+		const Slot& slot = shard.slots[i];
+		if (slot.hash == hash && slot.type == type && std::string_view(slot.text, slot.length) == text) {
+			return slot.literal;
+		}
+	}
+
+	// Add a new literal
+	uint32_t literal = nextLiteral.load(std::memory_order_relaxed);
+	do {
+		if (literal == EMPTY) {
+			throw std::length_error("String pool is full.");
+		}
+	} while (!nextLiteral.compare_exchange_weak(literal, literal + 1, std::memory_order_acq_rel));
+	std::string_view stored = text;
+	if (copy) {
+		stored = store(shard, text);
+	}
+	else {
+		shard.views.push_back(literal);
+	}
+	Entry& e = entries.at(literal);
+	e.length = (uint32_t)stored.length();
+	e.type = type;
+	e.text.store(stored.data(), std::memory_order_release);
+	shard.slots[i] = { hash, literal, stored.data(), (uint32_t)stored.length(), type };
+	shard.count += 1;
+	if (shard.count * 2 > shard.slots.size()) {
+		grow(shard);
+	}
+	return literal;
+}
+
+
+// Copies text into a shard's blocks. The shard must be locked.
+std::string_view String_Pool::store(Shard& shard, std::string_view text) {
+	copied.fetch_add(text.length(), std::memory_order_relaxed);
+	return shard.copies.store(text);
+}
+
+
+// Grows a shard's hash table to twice its size.
+void String_Pool::grow(Shard& shard) {
+	std::vector<Slot> slots(shard.slots.size() * 2);
+	size_t mask = slots.size() - 1;
+	for (const Slot& slot : shard.slots) {
+		if (slot.literal != EMPTY) {
+			size_t i = slot.hash & mask;
+			while (slots[i].literal != EMPTY) {
+				i = (i + 1) & mask;
+			}
+			slots[i] = slot;
+		}
+	}
+	shard.slots = std::move(slots);
+}
+
+
+/******************************************************************************
+
+This software is provided under two licenses. Choose whichever you prefer.
+
+
+============================= Apache License V2.0 =============================
+
+Copyright 2020 Matthew Roever
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+	http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+
+================================= MIT License =================================
+
+Copyright (c) 2020 Matthew Roever
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+******************************************************************************/
\ No newline at end of file
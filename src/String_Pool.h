@@ -0,0 +1,201 @@
+// File:		String_Pool.h
+// Language:	C++17
+// Purpose:		Decodes string literals and stores each distinct literal once.
+// License:		At bottom of document.
+
+#ifndef STRING_POOL_H
+#define STRING_POOL_H
+
+// STL
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Internal
+#include "Intern_Storage.h"
+#include "Vocabulary.h"
+
+
+// String literals, see Vocabulary.h.
+enum class String_Type : uint32_t {
+	STRING_TYPE_LIST(VOCABULARY_ENUMERATOR)
+};
+
+
+// Appends the text of a literal to out with escape sequences resolved. The
+// escapes are \n, \t, \r, \0, \\, \', \" and \x followed by two hex digits.
+// Any other backslash is kept as written.
+void decode_string(std::string_view text, std::string& out);
+
+
+// Maps string literals to dense 32 bit indices numbered from 0 in the order
+// they were first seen. Literals with the same quote type and decoded text
+// share an index. Text is either copied into the pool or, for literals that
+// needed no decoding, kept as a view into the source until the source is
+// detached. The pool may be shared by any number of threads.
+class String_Pool {
+public:
+	String_Pool() = default;
+	String_Pool(const String_Pool&) = delete;
+	String_Pool& operator=(const String_Pool&) = delete;
+
+
+	// Gets the index of a literal, copying the text if it is new.
+	//
+	// Error Handling:
+	//	+ Throws std::length_error if the pool runs out of 32 bit indices.
+	uint32_t add(std::string_view text, String_Type type);
+
+
+	// Gets the index of a literal, keeping a view of the text if it is new.
+	// The text must stay valid until it is passed to detach.
+	//
+	// Error Handling:
+	//	+ Throws std::length_error if the pool runs out of 32 bit indices.
+	uint32_t add_view(std::string_view text, String_Type type);
+
+
+	// Copies the text of every literal viewing [begin, end) into the pool, so
+	// the memory can change or be released once detach returns. Other threads
+	// may use the pool meanwhile, text they get is either the view or the
+	// copy.
+	void detach(const char* begin, const char* end);
+
+
+	// Gets the decoded text of a literal. The view is valid for the life of
+	// the pool, or until its source is detached.
+	//
+	// Error Handling:
+	//	+ Never throws. The index must have been returned by add or add_view.
+	std::string_view text(uint32_t literal) const noexcept;
+
+
+	// Gets the quote type of a literal.
+	//
+	// Error Handling:
+	//	+ Never throws. The index must have been returned by add or add_view.
+	String_Type type(uint32_t literal) const noexcept;
+
+
+	// Gets the number of literals.
+	//
+	// Error Handling:
+	//	+ Never throws.
+	uint32_t size() const noexcept {
+		return nextLiteral.load(std::memory_order_acquire);
+	}
+
+
+	// Gets the number of bytes of literal text copied into the pool.
+	//
+	// Error Handling:
+	//	+ Never throws.
+	size_t copied_bytes() const noexcept {
+		return copied.load(std::memory_order_relaxed);
+	}
+
+private:
+	// Number of shards, selected by the top bits of the hash.
+	static constexpr uint32_t SHARD_BITS = 4;
+	static constexpr uint32_t SHARDS = 1 << SHARD_BITS;
+
+	// Slot of a shard's hash table. Empty slots have no literal. The text is
+	// kept in the slot so probing does not touch the pages.
+	struct Slot {
+		uint32_t hash = 0;
+		uint32_t literal = EMPTY;
+		const char* text = nullptr;
+		uint32_t length = 0;
+		String_Type type = String_Type::DOUBLE;
+	};
+	static constexpr uint32_t EMPTY = UINT32_MAX;
+
+	// Text and quote type of a literal. Detaching only moves the text, so
+	// the pointer is atomic for threads reading the literal meanwhile.
+	struct Entry {
+		std::atomic<const char*> text{ nullptr };
+		uint32_t length = 0;
+		String_Type type = String_Type::DOUBLE;
+	};
+
+	// Part of the pool covering one range of hashes.
+	struct alignas(64) Shard {
+		std::mutex lock{};
+		std::vector<Slot> slots{};
+		uint32_t count = 0;
+
+		// Literals whose text is a view into the source
+		std::vector<uint32_t> views{};
+		Text_Blocks copies{};
+	};
+
+
+	// Gets the index of a literal, adding it if it is new.
+	uint32_t add(std::string_view text, String_Type type, bool copy);
+
+
+	// Copies text into a shard's blocks. The shard must be locked.
+	std::string_view store(Shard& shard, std::string_view text);
+
+
+	// Grows a shard's hash table to twice its size.
+	static void grow(Shard& shard);
+
+
+	Shard shards[SHARDS]{};
+	std::atomic<uint32_t> nextLiteral{ 0 };
+	std::atomic<size_t> copied{ 0 };
+	Paged_Array<Entry> entries{};
+};
+
+#endif
+
+
+/******************************************************************************
+
+This software is provided under two licenses. Choose whichever you prefer.
+
+
+============================= Apache License V2.0 =============================
+
+Copyright 2020 Matthew Roever
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+	http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+
+================================= MIT License =================================
+
+Copyright (c) 2020 Matthew Roever
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+******************************************************************************/
\ No newline at end of file
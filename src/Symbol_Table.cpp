@@ -0,0 +1,135 @@
+// File:		Symbol_Table.cpp
+// Language:	C++17
+// Purpose:		Interns identifier text as dense 32 bit symbol IDs.
+// License:		At bottom of document.
+
+// Header
+#include "Symbol_Table.h"
+
+// STL
+#include <stdexcept>
+
+// Internal
+#include "Hash.h"
+
+
+// Gets the ID of a name, adding the name if it is new. The hash must be
+// crc32c(0, name).
+//
+// Error Handling:
+//	+ Throws std::length_error if the table runs out of 32 bit IDs.
+uint32_t Symbol_Table::intern(std::string_view name, uint32_t hash) {
+	Shard& shard = shards[hash >> (32 - SHARD_BITS)];
+	std::lock_guard<std::mutex> guard{ shard.lock };
+	if (shard.slots.empty()) {
+		shard.slots.resize(256);
+	}
+
+	// Linear probe for the name
+	size_t mask = shard.slots.size() - 1;
+	size_t i = hash & mask;
+	for (; shard.slots[i].symbol != EMPTY; i = (i + 1) & mask) {
+		const Slot& slot = shard.slots[i];
+		if (slot.hash == hash && std::string_view(slot.text, slot.length) == name) {
+			return slot.symbol;
+		}
+	}
+
+	// Add a new symbol
+	uint32_t symbol = nextSymbol.load(std::memory_order_relaxed);
+	do {
+		if (symbol == EMPTY) {
+			throw std::length_error("Symbol table is full.");
+		}
+	} while (!nextSymbol.compare_exchange_weak(symbol, symbol + 1, std::memory_order_acq_rel));
+	std::string_view stored = shard.names.store(name);
+	texts.at(symbol) = stored;
+	shard.slots[i] = { hash, symbol, stored.data(), stored.length() };
+	shard.count += 1;
+	if (shard.count * 2 > shard.slots.size()) {
+		grow(shard);
+	}
+	return symbol;
+}
+
+
+// Gets the ID of a name, adding the name if it is new.
+//
+// Error Handling:
+//	+ Throws std::length_error if the table runs out of 32 bit IDs.
+uint32_t Symbol_Table::intern(std::string_view name) {
+	return intern(name, crc32c(0, name.data(), name.length()));
+}
+
+
+// Gets the text of a symbol. The view is valid for the life of the table.
+//
+// Error Handling:
+//	+ Never throws. The ID must have been returned by intern.
+std::string_view Symbol_Table::text(uint32_t symbol) const noexcept {
+	return texts[symbol];
+}
+
+
+// Grows a shard's hash table to twice its size.
+void Symbol_Table::grow(Shard& shard) {
+	std::vector<Slot> slots(shard.slots.size() * 2);
+	size_t mask = slots.size() - 1;
+	for (const Slot& slot : shard.slots) {
+		if (slot.symbol != EMPTY) {
+			size_t i = slot.hash & mask;
+			while (slots[i].symbol != EMPTY) {
+				i = (i + 1) & mask;
+			}
+			slots[i] = slot;
+		}
+	}
+	shard.slots = std::move(slots);
+}
+
+
+/******************************************************************************
+
+This software is provided under two licenses. Choose whichever you prefer.
+
+
+============================= Apache License V2.0 =============================
+
+Copyright 2020 Matthew Roever
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+	http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+
+================================= MIT License =================================
+
+Copyright (c) 2020 Matthew Roever
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+******************************************************************************/
\ No newline at end of file
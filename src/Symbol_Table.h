@@ -0,0 +1,142 @@
+// File:		Symbol_Table.h
+// Language:	C++17
+// Purpose:		Interns identifier text as dense 32 bit symbol IDs.
+// License:		At bottom of document.
+
+#ifndef SYMBOL_TABLE_H
+#define SYMBOL_TABLE_H
+
+// STL
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string_view>
+#include <vector>
+
+// Internal
+#include "Intern_Storage.h"
+
+
+// Maps identifier text to symbol IDs numbered from 0 in the order they were
+// first seen. Equal text always gets the same ID, so names compare as
+// integers. The table is split into shards, each with its own lock, and may
+// be shared by any number of threads.
+class Symbol_Table {
+public:
+	Symbol_Table() = default;
+	Symbol_Table(const Symbol_Table&) = delete;
+	Symbol_Table& operator=(const Symbol_Table&) = delete;
+
+
+	// Gets the ID of a name, adding the name if it is new. The hash must be
+	// crc32c(0, name).
+	//
+	// Error Handling:
+	//	+ Throws std::length_error if the table runs out of 32 bit IDs.
+	uint32_t intern(std::string_view name, uint32_t hash);
+
+
+	// Gets the ID of a name, adding the name if it is new.
+	//
+	// Error Handling:
+	//	+ Throws std::length_error if the table runs out of 32 bit IDs.
+	uint32_t intern(std::string_view name);
+
+
+	// Gets the text of a symbol. The view is valid for the life of the table.
+	//
+	// Error Handling:
+	//	+ Never throws. The ID must have been returned by intern.
+	std::string_view text(uint32_t symbol) const noexcept;
+
+
+	// Gets the number of symbols.
+	//
+	// Error Handling:
+	//	+ Never throws.
+	uint32_t size() const noexcept {
+		return nextSymbol.load(std::memory_order_acquire);
+	}
+
+private:
+	// Number of shards, selected by the top bits of the hash.
+	static constexpr uint32_t SHARD_BITS = 6;
+	static constexpr uint32_t SHARDS = 1 << SHARD_BITS;
+
+	// Slot of a shard's hash table. Empty slots have no symbol. The text is
+	// kept in the slot so probing does not touch the pages.
+	struct Slot {
+		uint32_t hash = 0;
+		uint32_t symbol = EMPTY;
+		const char* text = nullptr;
+		size_t length = 0;
+	};
+	static constexpr uint32_t EMPTY = UINT32_MAX;
+
+
+	// Part of the table covering one range of hashes.
+	struct alignas(64) Shard {
+		std::mutex lock{};
+		std::vector<Slot> slots{};
+		uint32_t count = 0;
+		Text_Blocks names{};
+	};
+
+
+	// Grows a shard's hash table to twice its size.
+	void grow(Shard& shard);
+
+
+	Shard shards[SHARDS]{};
+	std::atomic<uint32_t> nextSymbol{ 0 };
+	Paged_Array<std::string_view> texts{};
+};
+
+#endif
+
+
+/******************************************************************************
+
+This software is provided under two licenses. Choose whichever you prefer.
+
+
+============================= Apache License V2.0 =============================
+
+Copyright 2020 Matthew Roever
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+	http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+
+================================= MIT License =================================
+
+Copyright (c) 2020 Matthew Roever
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+******************************************************************************/
\ No newline at end of file
@@ -0,0 +1,322 @@
+// File:		Text_Search.cpp
+// Language:	C++17
+// Purpose:		SIMD search for the end of comments and string literals.
+// License:		At bottom of document.
+
+// Header
+#include "Text_Search.h"
+
+// Internal
+#include "CPU_Features.h"
+
+// Platform
+#if SIMD_X86
+#include <immintrin.h>
+#endif
+
+
+// Searches one character at a time.
+static uint32_t find_comment_end_scalar(const char* s, uint32_t index, uint32_t length) noexcept {
+	for (uint32_t i = index; i + 1 < length; ++i) {
+		if (s[i] == '*' && s[i + 1] == '/') {
+			return i;
+		}
+	}
+	return length;
+}
+
+
+// Searches one character at a time.
+static uint32_t find_string_end_scalar(const char* s, uint32_t index, uint32_t length, char q) noexcept {
+	bool escaped = false;
+	for (uint32_t i = index; i < length; ++i) {
+		if (escaped) {
+			escaped = false;
+		}
+		else if (s[i] == '\\') {
+			escaped = true;
+		}
+		else if (s[i] == q) {
+			return i;
+		}
+	}
+	return length;
+}
+
+
+#if SIMD_X86
+// Bits at odd positions of a block mask.
+static constexpr uint32_t ODD_BITS = 0xAAAAAAAA;
+
+
+// Gets the mask of characters escaped by a backslash from the mask of the
+// backslashes of a block. Within a run of backslashes every other one
+// escapes the next character, starting with the first. Subtracting the
+// start of each run from the odd bits flips the bits of the run through
+// the character after it, which marks every escaping backslash of a run
+// starting at an even bit and every escaped character of a run starting at
+// an odd bit. carry is whether the first character of the block is escaped
+// and is set to whether the character after bit top is.
+static uint32_t escaped_characters(uint32_t backSlashes, uint32_t& carry, uint32_t top) noexcept {
+	uint32_t starts = backSlashes & ~carry;
+	uint32_t codes = (((starts << 1) | ODD_BITS) - starts) ^ ODD_BITS;
+	uint32_t escaped = codes ^ (backSlashes | carry);
+	carry = ((codes & backSlashes) >> top) & 1;
+	return escaped;
+}
+
+
+// Searches 16 characters at a time. A slash ends the comment if the bit
+// below it in the star mask is set, the star of the last character of a
+// block is carried into the next. SSE2 is part of x86-64.
+static uint32_t find_comment_end_sse2(const char* s, uint32_t index, uint32_t length) noexcept {
+	if (length < 16) {
+		return find_comment_end_scalar(s, index, length);
+	}
+	const __m128i star = _mm_set1_epi8('*');
+	const __m128i slash = _mm_set1_epi8('/');
+	uint32_t carry = 0;
+	uint32_t i = index;
+	for (; i + 16 <= length; i += 16) {
+		__m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i));
+		uint32_t stars = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(v, star)));
+		uint32_t slashes = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(v, slash)));
+		uint32_t ends = ((stars << 1) | carry) & slashes;
+		if (ends != 0) {
+			return i + count_trailing_zeros(ends) - 1;
+		}
+		carry = stars >> 15;
+	}
+
+	// The last block is loaded ending at length, the slashes it shares with
+	// blocks already searched are masked off
+	uint32_t first = (i > index) ? i : index + 1;
+	if (first >= length) {
+		return length;
+	}
+	uint32_t j = length - 16;
+	__m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + j));
+	uint32_t stars = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(v, star)));
+	uint32_t slashes = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(v, slash)));
+	uint32_t ends = (stars << 1) & slashes & (~0u << (first - j));
+	return (ends != 0) ? j + count_trailing_zeros(ends) - 1 : length;
+}
+
+
+// Searches 16 characters at a time. Quotes are ended by their escape mask,
+// whether the last backslash of a block escapes is carried into the next.
+// SSE2 is part of x86-64.
+static uint32_t find_string_end_sse2(const char* s, uint32_t index, uint32_t length, char q) noexcept {
+	if (length < 16) {
+		return find_string_end_scalar(s, index, length, q);
+	}
+	const __m128i quote = _mm_set1_epi8(q);
+	const __m128i backSlash = _mm_set1_epi8('\\');
+	uint32_t carry = 0;
+	uint32_t i = index;
+	for (; i + 16 <= length; i += 16) {
+		__m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i));
+		uint32_t quotes = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(v, quote)));
+		uint32_t slashes = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(v, backSlash)));
+		uint32_t ends = quotes & ~escaped_characters(slashes, carry, 15);
+		if (ends != 0) {
+			return i + count_trailing_zeros(ends);
+		}
+	}
+	if (i >= length) {
+		return length;
+	}
+
+	// The last block is loaded ending at length and shifted to start at i,
+	// dropping the characters already searched
+	uint32_t j = length - 16;
+	__m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + j));
+	uint32_t quotes = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(v, quote))) >> (i - j);
+	uint32_t slashes = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(v, backSlash))) >> (i - j);
+	uint32_t ends = quotes & ~escaped_characters(slashes, carry, 15);
+	return (ends != 0) ? i + count_trailing_zeros(ends) : length;
+}
+
+
+// Searches 32 characters at a time.
+TARGET_AVX2 static uint32_t find_comment_end_avx2(const char* s, uint32_t index, uint32_t length) noexcept {
+	// Short lines are left to SSE2 before any AVX register is used
+	if (length < 32) {
+		return find_comment_end_sse2(s, index, length);
+	}
+	const __m256i star = _mm256_set1_epi8('*');
+	const __m256i slash = _mm256_set1_epi8('/');
+	uint32_t carry = 0;
+	uint32_t i = index;
+	for (; i + 32 <= length; i += 32) {
+		__m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s + i));
+		uint32_t stars = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, star)));
+		uint32_t slashes = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, slash)));
+		uint32_t ends = ((stars << 1) | carry) & slashes;
+		if (ends != 0) {
+			return i + count_trailing_zeros(ends) - 1;
+		}
+		carry = stars >> 31;
+	}
+
+	// The last block is loaded ending at length, the slashes it shares with
+	// blocks already searched are masked off
+	uint32_t first = (i > index) ? i : index + 1;
+	if (first >= length) {
+		return length;
+	}
+	uint32_t j = length - 32;
+	__m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s + j));
+	uint32_t stars = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, star)));
+	uint32_t slashes = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, slash)));
+	uint32_t ends = (stars << 1) & slashes & (~0u << (first - j));
+	return (ends != 0) ? j + count_trailing_zeros(ends) - 1 : length;
+}
+
+
+// Searches 32 characters at a time.
+TARGET_AVX2 static uint32_t find_string_end_avx2(const char* s, uint32_t index, uint32_t length, char q) noexcept {
+	// Short lines are left to SSE2 before any AVX register is used
+	if (length < 32) {
+		return find_string_end_sse2(s, index, length, q);
+	}
+	const __m256i quote = _mm256_set1_epi8(q);
+	const __m256i backSlash = _mm256_set1_epi8('\\');
+	uint32_t carry = 0;
+	uint32_t i = index;
+	for (; i + 32 <= length; i += 32) {
+		__m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s + i));
+		uint32_t quotes = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, quote)));
+		uint32_t slashes = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, backSlash)));
+		uint32_t ends = quotes & ~escaped_characters(slashes, carry, 31);
+		if (ends != 0) {
+			return i + count_trailing_zeros(ends);
+		}
+	}
+	if (i >= length) {
+		return length;
+	}
+
+	// The last block is loaded ending at length and shifted to start at i,
+	// dropping the characters already searched
+	uint32_t j = length - 32;
+	__m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s + j));
+	uint32_t quotes = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, quote))) >> (i - j);
+	uint32_t slashes = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, backSlash))) >> (i - j);
+	uint32_t ends = quotes & ~escaped_characters(slashes, carry, 31);
+	return (ends != 0) ? i + count_trailing_zeros(ends) : length;
+}
+#endif
+
+
+// Signatures shared by every implementation.
+using Comment_End_Function = uint32_t(*)(const char*, uint32_t, uint32_t) noexcept;
+using String_End_Function = uint32_t(*)(const char*, uint32_t, uint32_t, char) noexcept;
+
+
+// Picks the widest implementation the processor supports.
+static Comment_End_Function select_find_comment_end() {
+#if SIMD_X86
+	if (cpu_features().avx2) {
+		return find_comment_end_avx2;
+	}
+	return find_comment_end_sse2;
+#else
+	return find_comment_end_scalar;
+#endif
+}
+
+
+// Picks the widest implementation the processor supports.
+static String_End_Function select_find_string_end() {
+#if SIMD_X86
+	if (cpu_features().avx2) {
+		return find_string_end_avx2;
+	}
+	return find_string_end_sse2;
+#else
+	return find_string_end_scalar;
+#endif
+}
+
+
+// Selected once at startup.
+static const Comment_End_Function find_comment_end_impl = select_find_comment_end();
+static const String_End_Function find_string_end_impl = select_find_string_end();
+
+
+// Finds the first "*/" starting at or after index in s[0, length). Returns
+// the index of the '*', or length if the comment does not end. The last
+// block may be loaded from before index. Uses AVX2 or SSE2 when available,
+// selected once at startup.
+//
+// Error Handling:
+//	+ Never throws.
+uint32_t find_comment_end(const char* s, uint32_t index, uint32_t length) noexcept {
+	return find_comment_end_impl(s, index, length);
+}
+
+
+// Finds the first quote q at or after index in s[0, length) that is not
+// escaped. A backslash escapes the character after it unless it is escaped
+// itself, so a quote after an odd run of backslashes is escaped and one
+// after an even run is not. The character at index is never escaped.
+// Returns length if there is no such quote. The last block may be loaded
+// from before index. Uses AVX2 or SSE2 when available, selected once at
+// startup.
+//
+// Error Handling:
+//	+ Never throws.
+uint32_t find_string_end(const char* s, uint32_t index, uint32_t length, char q) noexcept {
+	if (index >= length) {
+		return length;
+	}
+	return find_string_end_impl(s, index, length, q);
+}
+
+
+/******************************************************************************
+
+This software is provided under two licenses. Choose whichever you prefer.
+
+
+============================= Apache License V2.0 =============================
+
+Copyright 2020 Matthew Roever
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+	http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+
+================================= MIT License =================================
+
+Copyright (c) 2020 Matthew Roever
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+******************************************************************************/
\ No newline at end of file
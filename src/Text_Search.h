@@ -0,0 +1,82 @@
+// File:		Text_Search.h
+// Language:	C++17
+// Purpose:		SIMD search for the end of comments and string literals.
+// License:		At bottom of document.
+
+#ifndef TEXT_SEARCH_H
+#define TEXT_SEARCH_H
+
+// STL
+#include <cstdint>
+
+
+// Finds the first "*/" starting at or after index in s[0, length). Returns
+// the index of the '*', or length if the comment does not end. The last
+// block may be loaded from before index. Uses AVX2 or SSE2 when available,
+// selected once at startup.
+//
+// Error Handling:
+//	+ Never throws.
+uint32_t find_comment_end(const char* s, uint32_t index, uint32_t length) noexcept;
+
+
+// Finds the first quote q at or after index in s[0, length) that is not
+// escaped. A backslash escapes the character after it unless it is escaped
+// itself, so a quote after an odd run of backslashes is escaped and one
+// after an even run is not. The character at index is never escaped.
+// Returns length if there is no such quote. The last block may be loaded
+// from before index. Uses AVX2 or SSE2 when available, selected once at
+// startup.
+//
+// Error Handling:
+//	+ Never throws.
+uint32_t find_string_end(const char* s, uint32_t index, uint32_t length, char q) noexcept;
+
+#endif
+
+
+/******************************************************************************
+
+This software is provided under two licenses. Choose whichever you prefer.
+
+
+============================= Apache License V2.0 =============================
+
+Copyright 2020 Matthew Roever
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+	http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+
+================================= MIT License =================================
+
+Copyright (c) 2020 Matthew Roever
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+******************************************************************************/
\ No newline at end of file
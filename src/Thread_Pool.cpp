@@ -0,0 +1,143 @@
+// File:		Thread_Pool.cpp
+// Language:	C++17
+// Purpose:		Fixed size pool of worker threads.
+// License:		At bottom of document.
+
+// Header
+#include "Thread_Pool.h"
+
+
+// Starts threads - 1 workers, the thread calling run is the last worker.
+Thread_Pool::Thread_Pool(uint32_t threads) {
+	if (threads > 1) {
+		workers.reserve(threads - 1);
+		for (uint32_t i = 1; i < threads; ++i) {
+			workers.emplace_back(&Thread_Pool::worker, this);
+		}
+	}
+}
+
+
+Thread_Pool::~Thread_Pool() {
+	{
+		std::lock_guard<std::mutex> guard{ lock };
+		stopping = true;
+	}
+	wake.notify_all();
+	for (auto& w : workers) {
+		w.join();
+	}
+}
+
+
+// Runs task(i) for every i in [0, count) and waits for all of them to
+// finish. Tasks are handed out in order, the calling thread takes tasks as
+// well. Only one batch runs at a time, concurrent calls wait their turn.
+//
+// Error Handling:
+//	+ Tasks must not throw, catch and store errors inside the task.
+void Thread_Pool::run(size_t count, const std::function<void(size_t)>& fn) {
+	if (count == 0) {
+		return;
+	}
+	std::lock_guard<std::mutex> serial{ runLock };
+
+	// Publish the batch
+	{
+		std::lock_guard<std::mutex> guard{ lock };
+		task = &fn;
+		taskCount = count;
+		next.store(0, std::memory_order_relaxed);
+		active = workers.size() + 1;
+		batch += 1;
+	}
+	wake.notify_all();
+
+	// Work alongside the pool, then wait for the stragglers
+	work_batch();
+	std::unique_lock<std::mutex> guard{ lock };
+	active -= 1;
+	done.wait(guard, [this] { return active == 0; });
+	task = nullptr;
+}
+
+
+// Takes tasks from the current batch until none are left.
+void Thread_Pool::work_batch() noexcept {
+	for (;;) {
+		size_t i = next.fetch_add(1, std::memory_order_relaxed);
+		if (i >= taskCount) {
+			return;
+		}
+		(*task)(i);
+	}
+}
+
+
+// Worker thread loop.
+void Thread_Pool::worker() noexcept {
+	uint64_t seen = 0;
+	for (;;) {
+		{
+			std::unique_lock<std::mutex> guard{ lock };
+			wake.wait(guard, [&] { return stopping || batch != seen; });
+			if (stopping) {
+				return;
+			}
+			seen = batch;
+		}
+		work_batch();
+		{
+			std::lock_guard<std::mutex> guard{ lock };
+			active -= 1;
+		}
+		done.notify_one();
+	}
+}
+
+
+/******************************************************************************
+
+This software is provided under two licenses. Choose whichever you prefer.
+
+
+============================= Apache License V2.0 =============================
+
+Copyright 2020 Matthew Roever
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+	http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+
+================================= MIT License =================================
+
+Copyright (c) 2020 Matthew Roever
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+******************************************************************************/
\ No newline at end of file
@@ -0,0 +1,120 @@
+// File:		Thread_Pool.h
+// Language:	C++17
+// Purpose:		Fixed size pool of worker threads.
+// License:		At bottom of document.
+
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+// STL
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+// Fixed size pool of worker threads that run batches of indexed tasks.
+class Thread_Pool {
+public:
+	// Starts threads - 1 workers, the thread calling run is the last worker.
+	explicit Thread_Pool(uint32_t threads);
+	Thread_Pool(const Thread_Pool&) = delete;
+	Thread_Pool& operator=(const Thread_Pool&) = delete;
+	~Thread_Pool();
+
+
+	// Runs task(i) for every i in [0, count) and waits for all of them to
+	// finish. Tasks are handed out in order, the calling thread takes tasks as
+	// well. Only one batch runs at a time, concurrent calls wait their turn.
+	//
+	// Error Handling:
+	//	+ Tasks must not throw, catch and store errors inside the task.
+	void run(size_t count, const std::function<void(size_t)>& task);
+
+
+	// Gets the number of threads that work on a batch, including the caller.
+	//
+	// Error Handling:
+	//	+ Never throws.
+	uint32_t size() const noexcept {
+		return static_cast<uint32_t>(workers.size()) + 1;
+	}
+
+private:
+	// Takes tasks from the current batch until none are left.
+	void work_batch() noexcept;
+
+
+	// Worker thread loop.
+	void worker() noexcept;
+
+
+	std::vector<std::thread> workers{};
+	std::mutex runLock{};
+
+	// Current batch, guarded by lock
+	std::mutex lock{};
+	std::condition_variable wake{};
+	std::condition_variable done{};
+	const std::function<void(size_t)>* task = nullptr;
+	size_t taskCount = 0;
+	size_t active = 0;
+	uint64_t batch = 0;
+	bool stopping = false;
+
+	// Next task index of the current batch
+	std::atomic<size_t> next{ 0 };
+};
+
+#endif
+
+
+/******************************************************************************
+
+This software is provided under two licenses. Choose whichever you prefer.
+
+
+============================= Apache License V2.0 =============================
+
+Copyright 2020 Matthew Roever
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+	http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+
+================================= MIT License =================================
+
+Copyright (c) 2020 Matthew Roever
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+******************************************************************************/
\ No newline at end of file
@@ -0,0 +1,600 @@
+// File:		Token_Cache.cpp
+// Language:	C++17
+// Purpose:		Stores scanner output on disk and maps it back for use in place.
+// License:		At bottom of document.
+
+// Header
+#include "Token_Cache.h"
+
+// STL
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Internal
+#include "Hash.h"
+#include "Lexer_Spec.h"
+
+// Platform
+#if defined(_WIN32)
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+
+// First bytes of every token cache file.
+static constexpr char TOKEN_CACHE_MAGIC[8] = { 'T', 'O', 'K', 'C', 'A', 'C', 'H', 'E' };
+
+// Written as a number, read back as the same number only on a host with the
+// same byte order.
+static constexpr uint32_t TOKEN_CACHE_BYTE_ORDER = 0x01020304;
+
+static_assert(sizeof(Token_Cache_Header) % 8 == 0, "Arrays after the header must stay 8 byte aligned.");
+
+
+// Pool entry or message stored as a range of the text at the end of the file.
+struct Cache_Text {
+	uint32_t offset = 0;
+	uint32_t length = 0;
+};
+
+
+// String literal of the file.
+struct Cache_Literal {
+	Cache_Text text{};
+	String_Type type = String_Type::DOUBLE;
+};
+
+
+// Diagnostic of the file.
+struct Cache_Diagnostic {
+	uint32_t offset = 0;
+	uint32_t length = 0;
+	Cache_Text message{};
+	uint32_t severity = 0;
+};
+
+
+// Positions of the arrays of a file, in bytes from its start.
+struct Cache_Layout {
+	size_t lines = 0;
+	size_t lexemes = 0;
+	size_t types = 0;
+	size_t subtypes = 0;
+	size_t offsets = 0;
+	size_t lengths = 0;
+	size_t statementEnds = 0;
+	size_t partners = 0;
+	size_t unmatched = 0;
+	size_t symbols = 0;
+	size_t constants = 0;
+	size_t literals = 0;
+	size_t diagnostics = 0;
+	size_t text = 0;
+	size_t end = 0;
+};
+
+
+// Rounds a size up to a multiple of 8.
+static constexpr size_t align8(size_t bytes) noexcept {
+	return (bytes + 7) & ~static_cast<size_t>(7);
+}
+
+
+// Works out where each array of a file starts from the counts in its header.
+static Cache_Layout cache_layout(const Token_Cache_Header& h) noexcept {
+	Cache_Layout l{};
+	size_t at = sizeof(Token_Cache_Header);
+	auto place = [&](size_t count, size_t itemSize) {
+		size_t begin = at;
+		at = align8(at + count * itemSize);
+		return begin;
+	};
+	l.lines = place(h.lineCount, sizeof(Line));
+	l.lexemes = place(h.lexemeCount, sizeof(Lexeme));
+	l.types = place(h.tokenCount, sizeof(Token_Type));
+	l.subtypes = place(h.tokenCount, sizeof(Token_Subtype));
+	l.offsets = place(h.tokenCount, sizeof(uint32_t));
+	l.lengths = place(h.tokenCount, sizeof(uint32_t));
+	l.statementEnds = place(h.statementCount, sizeof(uint32_t));
+	l.partners = place(h.tokenCount, sizeof(uint32_t));
+	l.unmatched = place(h.unmatchedCount, sizeof(uint32_t));
+	l.symbols = place(h.symbolCount, sizeof(Cache_Text));
+	l.constants = place(h.constantCount, sizeof(Constant));
+	l.literals = place(h.literalCount, sizeof(Cache_Literal));
+	l.diagnostics = place(h.diagnosticCount, sizeof(Cache_Diagnostic));
+	l.text = place(h.textBytes, 1);
+	l.end = at;
+	return l;
+}
+
+
+// Checks that every index and range in the arrays of a file stays inside the
+// array or text it refers to, so the views can be used unchecked. The body
+// check only finds damage, a file written with other ranges passes it.
+//
+// Error Handling:
+//	+ Never throws.
+static bool valid_ranges(const Token_Cache_Header& h, const Cache_Layout& l, const char* base) noexcept {
+	auto within = [](uint64_t begin, uint64_t length, uint64_t end) {
+		return begin <= end && length <= end - begin;
+	};
+	const auto* lines = reinterpret_cast<const Line*>(base + l.lines);
+	for (uint32_t i = 0; i < h.lineCount; ++i) {
+		if (!within(lines[i].firstLexeme, lines[i].lexemeCount, h.lexemeCount)) {
+			return false;
+		}
+	}
+	const auto* lexemes = reinterpret_cast<const Lexeme*>(base + l.lexemes);
+	for (uint32_t i = 0; i < h.lexemeCount; ++i) {
+		if (lexemes[i].begin > lexemes[i].end || lexemes[i].end > h.sourceLength) {
+			return false;
+		}
+	}
+
+	// Tokens, and the pool entries their subtypes name
+	const auto* types = reinterpret_cast<const Token_Type*>(base + l.types);
+	const auto* subtypes = reinterpret_cast<const Token_Subtype*>(base + l.subtypes);
+	const auto* offsets = reinterpret_cast<const uint32_t*>(base + l.offsets);
+	const auto* lengths = reinterpret_cast<const uint32_t*>(base + l.lengths);
+	const auto* partners = reinterpret_cast<const uint32_t*>(base + l.partners);
+	for (uint32_t i = 0; i < h.tokenCount; ++i) {
+		if (!within(offsets[i], lengths[i], h.sourceLength) ||
+			(partners[i] != Bracket_Index::NO_PARTNER && partners[i] >= h.tokenCount)) {
+			return false;
+		}
+		switch (types[i]) {
+		case Token_Type::WORD:
+			if (subtypes[i].symbol >= h.symbolCount) {
+				return false;
+			}
+			break;
+		case Token_Type::NUMBER:
+			if (subtypes[i].constant >= h.constantCount) {
+				return false;
+			}
+			break;
+		case Token_Type::STRING:
+			if (subtypes[i].literal >= h.literalCount) {
+				return false;
+			}
+			break;
+		default:
+			break;
+		}
+	}
+	const auto* statementEnds = reinterpret_cast<const uint32_t*>(base + l.statementEnds);
+	for (uint32_t i = 0; i < h.statementCount; ++i) {
+		if (statementEnds[i] > h.tokenCount) {
+			return false;
+		}
+	}
+	const auto* unmatched = reinterpret_cast<const uint32_t*>(base + l.unmatched);
+	for (uint32_t i = 0; i < h.unmatchedCount; ++i) {
+		if (unmatched[i] >= h.tokenCount) {
+			return false;
+		}
+	}
+
+	// Diagnostics mark the source and hold their message in the text
+	const auto* problems = reinterpret_cast<const Cache_Diagnostic*>(base + l.diagnostics);
+	for (uint32_t i = 0; i < h.diagnosticCount; ++i) {
+		const Cache_Diagnostic& d = problems[i];
+		if (!within(d.offset, d.length, h.sourceLength) ||
+			!within(d.message.offset, d.message.length, h.textBytes)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+
+// Appends text to the text of a file and gets its range.
+static Cache_Text add_text(std::string& text, std::string_view s) {
+	Cache_Text range{ (uint32_t)text.size(), (uint32_t)s.length() };
+	text.append(s);
+	return range;
+}
+
+
+// Writes scanner output to a token cache file, replacing any file at the
+// path. The pools must be the ones the output was scanned with.
+//
+// Error Handling:
+//	+ Throws std::runtime_error if the file can not be written.
+void write_token_cache(const std::filesystem::path& path, const Source_Buffer& source, const Scanner_View& output,
+	const Diagnostics& diagnostics, const Symbol_Table& symbols, const Constant_Pool& constants,
+	const String_Pool& strings) {
+	const std::string name = path.filename().generic_string();
+	Token_Cache_Header h{};
+	std::memcpy(h.magic, TOKEN_CACHE_MAGIC, sizeof(h.magic));
+	h.version = TOKEN_CACHE_VERSION;
+	h.byteOrder = TOKEN_CACHE_BYTE_ORDER;
+	h.sourceHash = xxhash64(source.text().data(), source.text().length());
+	h.languageFingerprint = language_fingerprint;
+	h.sourceLength = (uint32_t)source.text().length();
+	h.lineCount = output.lineCount;
+	h.lexemeCount = output.lexemeCount;
+	h.tokenCount = output.tokenCount;
+	h.statementCount = output.statementCount;
+	h.unmatchedCount = output.unmatchedCount;
+	h.symbolCount = symbols.size();
+	h.constantCount = constants.size();
+	h.literalCount = strings.size();
+	h.diagnosticCount = (uint32_t)diagnostics.entries().size();
+	for (uint32_t s = 0; s < 3; ++s) {
+		h.problems[s] = (uint32_t)diagnostics.count(static_cast<Severity>(s));
+	}
+
+	// Pool entries and messages are ranges of one text
+	std::string text{};
+	std::vector<Cache_Text> symbolTexts(h.symbolCount);
+	std::vector<Constant> constantValues(h.constantCount);
+	std::vector<Cache_Literal> literals(h.literalCount);
+	std::vector<Cache_Diagnostic> problems(h.diagnosticCount);
+	for (uint32_t i = 0; i < h.symbolCount; ++i) {
+		symbolTexts[i] = add_text(text, symbols.text(i));
+	}
+	for (uint32_t i = 0; i < h.constantCount; ++i) {
+		constantValues[i] = constants.get(i);
+	}
+	for (uint32_t i = 0; i < h.literalCount; ++i) {
+		literals[i] = { add_text(text, strings.text(i)), strings.type(i) };
+	}
+	for (uint32_t i = 0; i < h.diagnosticCount; ++i) {
+		const Diagnostic& d = diagnostics.entries()[i];
+		problems[i] = { d.offset, d.length, add_text(text, d.message), static_cast<uint32_t>(d.severity) };
+	}
+	if (text.size() >= UINT32_MAX) {
+		throw std::runtime_error("Token cache text exceeds 4 GB: " + name);
+	}
+	h.textBytes = (uint32_t)text.size();
+
+	// The header is written last, once the check of the body is known
+	std::ofstream out(path, std::ios::binary | std::ios::trunc);
+	if (!out) {
+		throw std::runtime_error("Could not write token cache: " + name);
+	}
+	out.write(reinterpret_cast<const char*>(&h), sizeof(h));
+	uint32_t check = 0;
+	auto put = [&](const void* data, size_t count, size_t itemSize) {
+		static constexpr char zeros[8]{};
+		const size_t bytes = count * itemSize;
+		const size_t pad = align8(bytes) - bytes;
+		if (bytes != 0) {
+			out.write(static_cast<const char*>(data), bytes);
+			check = crc32c(check, static_cast<const char*>(data), bytes);
+		}
+		out.write(zeros, pad);
+		check = crc32c(check, zeros, pad);
+	};
+	put(output.lines, h.lineCount, sizeof(Line));
+	put(output.lexemes, h.lexemeCount, sizeof(Lexeme));
+	put(output.types, h.tokenCount, sizeof(Token_Type));
+	put(output.subtypes, h.tokenCount, sizeof(Token_Subtype));
+	put(output.offsets, h.tokenCount, sizeof(uint32_t));
+	put(output.lengths, h.tokenCount, sizeof(uint32_t));
+	put(output.statementEnds, h.statementCount, sizeof(uint32_t));
+	put(output.partners, h.tokenCount, sizeof(uint32_t));
+	put(output.unmatched, h.unmatchedCount, sizeof(uint32_t));
+	put(symbolTexts.data(), h.symbolCount, sizeof(Cache_Text));
+	put(constantValues.data(), h.constantCount, sizeof(Constant));
+	put(literals.data(), h.literalCount, sizeof(Cache_Literal));
+	put(problems.data(), h.diagnosticCount, sizeof(Cache_Diagnostic));
+	put(text.data(), h.textBytes, 1);
+	h.bodyCheck = check;
+	out.seekp(0);
+	out.write(reinterpret_cast<const char*>(&h), sizeof(h));
+	out.flush();
+	if (!out) {
+		throw std::runtime_error("Could not write token cache: " + name);
+	}
+}
+
+
+Token_Cache::~Token_Cache() {
+	close();
+}
+
+
+// Maps a token cache file written for the source text, then adds its
+// symbols, constants and literals to the pools. The cached subtypes are
+// only valid if the pools give every entry the index it had when the file
+// was written, which holds for empty pools or pools that started the
+// same way. Returns false, leaving the cache closed, if the file is
+// missing, damaged, from another version or lexical rules, for other
+// text or for pools that do not match.
+//
+// Error Handling:
+//	+ Throws std::length_error if a pool is full.
+bool Token_Cache::open(const std::filesystem::path& path, const Source_Buffer& source, Symbol_Table& symbols,
+	Constant_Pool& constants, String_Pool& strings) {
+	close();
+	if (!map_file(path) || !locate(source) || !restore_pools(symbols, constants, strings)) {
+		close();
+		return false;
+	}
+	return true;
+}
+
+
+// Releases the file. Views of it become invalid.
+//
+// Error Handling:
+//	+ Never throws.
+void Token_Cache::close() noexcept {
+	if (mapped) {
+#if defined(_WIN32)
+		UnmapViewOfFile(base);
+#else
+		munmap(const_cast<char*>(base), size);
+#endif
+	}
+	owned.reset();
+	base = nullptr;
+	size = 0;
+	mapped = false;
+	header = Token_Cache_Header{};
+	output = Scanner_View{};
+}
+
+
+// Replaces the problems in diagnostics with those held by the file.
+void Token_Cache::restore(Diagnostics& diagnostics) const {
+	diagnostics.clear();
+	const Cache_Layout l = cache_layout(header);
+	const auto* problems = reinterpret_cast<const Cache_Diagnostic*>(base + l.diagnostics);
+	const char* text = base + l.text;
+	size_t kept[3] = {};
+	for (uint32_t i = 0; i < header.diagnosticCount; ++i) {
+		const Cache_Diagnostic& d = problems[i];
+		if (d.severity > 2) {
+			continue;
+		}
+		const Severity severity = static_cast<Severity>(d.severity);
+		diagnostics.report(severity, d.offset, d.length, std::string(text + d.message.offset, d.message.length));
+		kept[d.severity] += 1;
+	}
+	for (uint32_t s = 0; s < 3; ++s) {
+		if (header.problems[s] > kept[s]) {
+			diagnostics.count_only(static_cast<Severity>(s), header.problems[s] - kept[s]);
+		}
+	}
+}
+
+
+// Maps or reads a whole file. Returns false if it can not be opened.
+bool Token_Cache::map_file(const std::filesystem::path& path) {
+#if defined(_WIN32)
+	HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+		OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE) {
+		return false;
+	}
+	LARGE_INTEGER fileSize{};
+	if (GetFileSizeEx(file, &fileSize) && fileSize.QuadPart > 0) {
+		HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (mapping != nullptr) {
+			const void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+			CloseHandle(mapping);
+			if (view != nullptr) {
+				CloseHandle(file);
+				base = static_cast<const char*>(view);
+				size = static_cast<size_t>(fileSize.QuadPart);
+				mapped = true;
+				return true;
+			}
+		}
+	}
+	CloseHandle(file);
+#else
+	int file = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+	if (file < 0) {
+		return false;
+	}
+	struct stat info {};
+	if (fstat(file, &info) == 0 && S_ISREG(info.st_mode) && info.st_size > 0) {
+		size_t length = static_cast<size_t>(info.st_size);
+		void* view = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, file, 0);
+		if (view != MAP_FAILED) {
+			::close(file);
+			base = static_cast<const char*>(view);
+			size = length;
+			mapped = true;
+			return true;
+		}
+	}
+	::close(file);
+#endif
+
+	// Read files that can not be mapped into memory aligned for the arrays
+	std::ifstream in(path, std::ios::binary | std::ios::ate);
+	if (!in) {
+		return false;
+	}
+	const std::streamoff length = in.tellg();
+	if (length <= 0) {
+		return false;
+	}
+	owned.reset(new uint64_t[(static_cast<size_t>(length) + 7) / 8]);
+	in.seekg(0);
+	in.read(reinterpret_cast<char*>(owned.get()), length);
+	if (!in) {
+		owned.reset();
+		return false;
+	}
+	base = reinterpret_cast<const char*>(owned.get());
+	size = static_cast<size_t>(length);
+	return true;
+}
+
+
+// Points the views at the arrays of the file. Returns false if the
+// header does not fit the file or the source, or an array refers past
+// the end of another array, the source or the text.
+bool Token_Cache::locate(const Source_Buffer& source) noexcept {
+	if (size < sizeof(Token_Cache_Header)) {
+		return false;
+	}
+	std::memcpy(&header, base, sizeof(header));
+	if (std::memcmp(header.magic, TOKEN_CACHE_MAGIC, sizeof(header.magic)) != 0 ||
+		header.version != TOKEN_CACHE_VERSION || header.byteOrder != TOKEN_CACHE_BYTE_ORDER ||
+		header.languageFingerprint != language_fingerprint) {
+		return false;
+	}
+	const Cache_Layout l = cache_layout(header);
+	std::string_view text = source.text();
+	if (l.end != size || header.sourceLength != text.length() || header.lineCount != source.line_count()) {
+		return false;
+	}
+
+	// Hashing the source and checking the body read every byte, so they go
+	// after the cheap checks
+	if (header.sourceHash != xxhash64(text.data(), text.length()) ||
+		header.bodyCheck != crc32c(0, base + sizeof(header), size - sizeof(header)) ||
+		!valid_ranges(header, l, base)) {
+		return false;
+	}
+	output.lines = reinterpret_cast<const Line*>(base + l.lines);
+	output.lexemes = reinterpret_cast<const Lexeme*>(base + l.lexemes);
+	output.types = reinterpret_cast<const Token_Type*>(base + l.types);
+	output.subtypes = reinterpret_cast<const Token_Subtype*>(base + l.subtypes);
+	output.offsets = reinterpret_cast<const uint32_t*>(base + l.offsets);
+	output.lengths = reinterpret_cast<const uint32_t*>(base + l.lengths);
+	output.statementEnds = reinterpret_cast<const uint32_t*>(base + l.statementEnds);
+	output.partners = reinterpret_cast<const uint32_t*>(base + l.partners);
+	output.unmatched = reinterpret_cast<const uint32_t*>(base + l.unmatched);
+	output.lineCount = header.lineCount;
+	output.lexemeCount = header.lexemeCount;
+	output.tokenCount = header.tokenCount;
+	output.statementCount = header.statementCount;
+	output.unmatchedCount = header.unmatchedCount;
+	return true;
+}
+
+
+// Adds the pool entries of the file to the pools. Returns false, leaving the
+// pools unchanged, if an entry would get a different index than it had. The
+// entries are checked before any is added: the entries a pool already has
+// must be the same, and the file must not hold an entry twice, which empty
+// staging pools check by the pools' own rules. The pools must not be added
+// to by other threads meanwhile.
+bool Token_Cache::restore_pools(Symbol_Table& symbols, Constant_Pool& constants, String_Pool& strings) const {
+	const Cache_Layout l = cache_layout(header);
+	const char* text = base + l.text;
+	auto text_of = [&](const Cache_Text& range, std::string_view& s) {
+		if (range.offset > header.textBytes || range.length > header.textBytes - range.offset) {
+			return false;
+		}
+		s = std::string_view(text + range.offset, range.length);
+		return true;
+	};
+	auto same_constant = [](const Constant& a, const Constant& b) {
+		return a.type == b.type && a.overflow == b.overflow && a.integer == b.integer &&
+			std::memcmp(&a.decimal, &b.decimal, sizeof(double)) == 0;
+	};
+
+	// Check every entry against the staging pools and the known entries
+	const auto* symbolTexts = reinterpret_cast<const Cache_Text*>(base + l.symbols);
+	const uint32_t knownSymbols = symbols.size();
+	Symbol_Table stagedSymbols{};
+	for (uint32_t i = 0; i < header.symbolCount; ++i) {
+		std::string_view s{};
+		if (!text_of(symbolTexts[i], s) || stagedSymbols.intern(s) != i ||
+			(i < knownSymbols && symbols.text(i) != s)) {
+			return false;
+		}
+	}
+	const auto* values = reinterpret_cast<const Constant*>(base + l.constants);
+	const uint32_t knownConstants = constants.size();
+	Constant_Pool stagedConstants{};
+	for (uint32_t i = 0; i < header.constantCount; ++i) {
+		if (stagedConstants.add(values[i]) != i ||
+			(i < knownConstants && !same_constant(constants.get(i), values[i]))) {
+			return false;
+		}
+	}
+	const auto* literals = reinterpret_cast<const Cache_Literal*>(base + l.literals);
+	const uint32_t knownLiterals = strings.size();
+	String_Pool stagedStrings{};
+	for (uint32_t i = 0; i < header.literalCount; ++i) {
+		std::string_view s{};
+		if (!text_of(literals[i].text, s) || stagedStrings.add_view(s, literals[i].type) != i ||
+			(i < knownLiterals && (strings.text(i) != s || strings.type(i) != literals[i].type))) {
+			return false;
+		}
+	}
+
+	// Add the entries the pools do not have yet, each is new so it gets the
+	// next index
+	for (uint32_t i = knownSymbols; i < header.symbolCount; ++i) {
+		std::string_view s{};
+		text_of(symbolTexts[i], s);
+		symbols.intern(s);
+	}
+	for (uint32_t i = knownConstants; i < header.constantCount; ++i) {
+		constants.add(values[i]);
+	}
+	for (uint32_t i = knownLiterals; i < header.literalCount; ++i) {
+		std::string_view s{};
+		text_of(literals[i].text, s);
+		strings.add(s, literals[i].type);
+	}
+	return true;
+}
+
+
+/******************************************************************************
+
+This software is provided under two licenses. Choose whichever you prefer.
+
+
+============================= Apache License V2.0 =============================
+
+Copyright 2020 Matthew Roever
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+	http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+
+================================= MIT License =================================
+
+Copyright (c) 2020 Matthew Roever
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+******************************************************************************/
\ No newline at end of file
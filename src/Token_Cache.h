@@ -0,0 +1,215 @@
+// File:		Token_Cache.h
+// Language:	C++17
+// Purpose:		Stores scanner output on disk and maps it back for use in place.
+// License:		At bottom of document.
+
+#ifndef TOKEN_CACHE_H
+#define TOKEN_CACHE_H
+
+// STL
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+
+// Internal
+#include "Constant_Pool.h"
+#include "Diagnostics.h"
+#include "Scanner.h"
+#include "Source_Buffer.h"
+#include "String_Pool.h"
+#include "Symbol_Table.h"
+
+
+// Version of the token cache format. Must be raised whenever the layout or the
+// output of the scanner changes in a way language_fingerprint does not cover,
+// so older files are ignored instead of being read wrongly.
+constexpr uint32_t TOKEN_CACHE_VERSION = 4;
+
+
+// Start of a token cache file. The arrays follow the header in a fixed order,
+// each starting on an 8 byte boundary, so their positions are worked out from
+// the counts:
+//	lines, lexemes, token types, subtypes, offsets and lengths, statement
+//	ends, bracket partners, unmatched brackets, symbols, constants, string
+//	literals, diagnostics and finally the text of symbols, literals and
+//	messages.
+// Arrays are stored in the byte order and layout of the machine that wrote
+// them, a file from a different machine is rejected by byteOrder or version.
+//
+// Fields:
+//	+ magic: "TOKCACHE".
+//	+ version: TOKEN_CACHE_VERSION.
+//	+ byteOrder: 0x01020304 as written by the host.
+//	+ sourceHash: xxhash64 of the source text.
+//	+ languageFingerprint: language_fingerprint of the compiler that wrote
+//		the file, the lexical rules the subtypes were given by.
+//	+ sourceLength: Length of the source text.
+//	+ *Count: Number of items in each array. The token arrays and partners
+//		all have tokenCount items. The symbols, constants and literals are the
+//		whole pools at the time of writing, in index order.
+//	+ problems: Number of problems reported of each Severity, including
+//		those not kept as diagnostics.
+//	+ textBytes: Length of the text at the end of the file.
+//	+ bodyCheck: crc32c of everything after the header.
+struct Token_Cache_Header {
+	char magic[8]{};
+	uint32_t version = 0;
+	uint32_t byteOrder = 0;
+	uint64_t sourceHash = 0;
+	uint64_t languageFingerprint = 0;
+	uint32_t sourceLength = 0;
+	uint32_t lineCount = 0;
+	uint32_t lexemeCount = 0;
+	uint32_t tokenCount = 0;
+	uint32_t statementCount = 0;
+	uint32_t unmatchedCount = 0;
+	uint32_t symbolCount = 0;
+	uint32_t constantCount = 0;
+	uint32_t literalCount = 0;
+	uint32_t diagnosticCount = 0;
+	uint32_t problems[3]{};
+	uint32_t textBytes = 0;
+	uint32_t bodyCheck = 0;
+	uint32_t reserved = 0;
+};
+
+
+// Writes scanner output to a token cache file, replacing any file at the
+// path. The pools must be the ones the output was scanned with.
+//
+// Error Handling:
+//	+ Throws std::runtime_error if the file can not be written.
+void write_token_cache(const std::filesystem::path& path, const Source_Buffer& source, const Scanner_View& output,
+	const Diagnostics& diagnostics, const Symbol_Table& symbols, const Constant_Pool& constants,
+	const String_Pool& strings);
+
+
+// Token cache file mapped into memory. The scanner output it holds is used in
+// place through view(), only the pool entries are copied out.
+class Token_Cache {
+public:
+	Token_Cache() = default;
+	Token_Cache(const Token_Cache&) = delete;
+	Token_Cache& operator=(const Token_Cache&) = delete;
+	~Token_Cache();
+
+
+	// Maps a token cache file written for the source text, then adds its
+	// symbols, constants and literals to the pools. The cached subtypes are
+	// only valid if the pools give every entry the index it had when the file
+	// was written, which holds for empty pools or pools that started the
+	// same way. Returns false, leaving the cache closed, if the file is
+	// missing, damaged, from another version or lexical rules, for other
+	// text or for pools that do not match.
+	//
+	// Error Handling:
+	//	+ Throws std::length_error if a pool is full.
+	bool open(const std::filesystem::path& path, const Source_Buffer& source, Symbol_Table& symbols,
+		Constant_Pool& constants, String_Pool& strings);
+
+
+	// Releases the file. Views of it become invalid.
+	//
+	// Error Handling:
+	//	+ Never throws.
+	void close() noexcept;
+
+
+	// Checks if a file is open.
+	//
+	// Error Handling:
+	//	+ Never throws.
+	bool is_open() const noexcept {
+		return base != nullptr;
+	}
+
+
+	// Gets the scanner output held by the file. Valid until the cache is
+	// closed.
+	//
+	// Error Handling:
+	//	+ Never throws.
+	const Scanner_View& view() const noexcept {
+		return output;
+	}
+
+
+	// Replaces the problems in diagnostics with those held by the file.
+	void restore(Diagnostics& diagnostics) const;
+
+private:
+	// Maps or reads a whole file. Returns false if it can not be opened.
+	bool map_file(const std::filesystem::path& path);
+
+
+	// Points the views at the arrays of the file. Returns false if the
+	// header does not fit the file or the source, or an array refers past
+	// the end of another array, the source or the text.
+	bool locate(const Source_Buffer& source) noexcept;
+
+
+	// Adds the pool entries of the file to the pools. Returns false, leaving the
+	// pools unchanged, if an entry would get a different index than it had. The
+	// entries are checked before any is added: the entries a pool already has
+	// must be the same, and the file must not hold an entry twice, which empty
+	// staging pools check by the pools' own rules. The pools must not be added
+	// to by other threads meanwhile.
+	bool restore_pools(Symbol_Table& symbols, Constant_Pool& constants, String_Pool& strings) const;
+
+
+	const char* base = nullptr;
+	size_t size = 0;
+	bool mapped = false;
+	std::unique_ptr<uint64_t[]> owned{};
+	Token_Cache_Header header{};
+	Scanner_View output{};
+};
+
+#endif
+
+
+/******************************************************************************
+
+This software is provided under two licenses. Choose whichever you prefer.
+
+
+============================= Apache License V2.0 =============================
+
+Copyright 2020 Matthew Roever
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+	http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+
+================================= MIT License =================================
+
+Copyright (c) 2020 Matthew Roever
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+******************************************************************************/
\ No newline at end of file
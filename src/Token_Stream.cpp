@@ -0,0 +1,215 @@
+// File:		Token_Stream.cpp
+// Language:	C++17
+// Purpose:		Produces tokens on demand from a source buffer.
+// License:		At bottom of document.
+
+// Header
+#include "Token_Stream.h"
+
+// Internal
+#include "Scanner_Support.h"
+
+
+Token_Stream::Token_Stream(const Source_Buffer& source, Symbol_Table& symbols, Constant_Pool& constants,
+	String_Pool& strings) noexcept :
+	source(&source), symbols(&symbols), constants(&constants), strings(&strings) {}
+
+
+// Gets the next token. Returns false once the input is used up.
+//
+// Error Handling:
+//	+ Unrecognized characters are returned as ERROR tokens.
+//	+ Throws std::length_error if a pool is full.
+bool Token_Stream::next(Token& tok) {
+	if (queueBegin == queue.size()) {
+		fill();
+		if (queueBegin == queue.size()) {
+			return false;
+		}
+	}
+	tok = queue[queueBegin];
+	queueBegin += 1;
+	return true;
+}
+
+
+// Gets the next token without consuming it. Returns false once the input
+// is used up.
+//
+// Error Handling:
+//	+ Unrecognized characters are returned as ERROR tokens.
+//	+ Throws std::length_error if a pool is full.
+bool Token_Stream::peek(Token& tok) {
+	if (queueBegin == queue.size()) {
+		fill();
+		if (queueBegin == queue.size()) {
+			return false;
+		}
+	}
+	tok = queue[queueBegin];
+	return true;
+}
+
+
+// Gets the offset of the /* of a block comment left open at the end of
+// the input. Returns false if every block comment is closed or the input
+// is not used up.
+//
+// Error Handling:
+//	+ Never throws.
+bool Token_Stream::open_comment(uint32_t& offset) const noexcept {
+	if (!finished || state != Line_State::MULTILINE_COMMENT) {
+		return false;
+	}
+	offset = commentBegin;
+	return true;
+}
+
+
+// Scans until at least one token is ready or the input is used up.
+void Token_Stream::fill() {
+	queue.clear();
+	queueBegin = 0;
+	Lexeme lex{};
+	Token tok{};
+	while ((queue.empty() || literal.pieces) && !finished) {
+		// End of input, close the last literal and statement
+		if (lineNumber == source->line_count()) {
+			if (literal.pieces) {
+				end_literal();
+			}
+			release_held();
+			if (openStatement) {
+				queue.push_back({ (uint32_t)source->text().length(), 0, Token_Type::EOL, 0 });
+				openStatement = false;
+			}
+			finished = true;
+			break;
+		}
+
+		// Start of a line, a blank line ends a string continuation
+		if (!lineStarted) {
+			line = source->line(lineNumber);
+			lineBegin = source->line_begin(lineNumber);
+			index = 0;
+			lineStarted = true;
+			if (line.empty() &&
+				(state == Line_State::DOUBLE_CONTINUATION || state == Line_State::SINGLE_CONTINUATION)) {
+				state = Line_State::NORMAL;
+				if (literal.pieces) {
+					end_literal();
+				}
+			}
+		}
+
+		// Next lexeme of the line
+		if (index < line.length()) {
+			const Line_State before = state;
+			if (!scan_lexeme(line, index, state, literal, lex, tok, *symbols, *constants, *strings)) {
+				if (state == Line_State::MULTILINE_COMMENT && before != Line_State::MULTILINE_COMMENT) {
+					commentBegin = lineBegin + lex.begin;
+				}
+				continue;
+			}
+			tok.offset = lineBegin + lex.begin;
+			tok.length = lex.end - lex.begin;
+			if (tok.type == Token_Type::OPERATOR && tok.subtype.op == Operator_Type::BACK_SLASH) {
+				held.push_back(tok);
+			}
+			else {
+				release_held();
+				queue.push_back(tok);
+				openStatement = true;
+				if (literal.pieces && state == Line_State::NORMAL) {
+					end_literal();
+				}
+			}
+			continue;
+		}
+
+		// End of line, unless a comment or string continues on the next line
+		if (state == Line_State::NORMAL && (openStatement || held.size())) {
+			// A backslash that is the last lexeme is a line continuation mark
+			const uint32_t lineEnd = lineBegin + (uint32_t)line.length();
+			if (held.size() && held.back().offset + held.back().length == lineEnd) {
+				held.pop_back();
+			}
+			// Mark the end of the line (equivalent to a ; in C++)
+			else {
+				release_held();
+				queue.push_back({ lineEnd, 0, Token_Type::EOL, 0 });
+				openStatement = false;
+			}
+		}
+		lineNumber += 1;
+		lineStarted = false;
+	}
+}
+
+
+// Moves the held backslashes to the ready queue.
+void Token_Stream::release_held() {
+	if (held.size()) {
+		queue.insert(queue.end(), held.begin(), held.end());
+		held.clear();
+		openStatement = true;
+	}
+}
+
+
+// Adds the open literal to the pool and gives its index to the tokens of
+// its pieces, which are the last tokens of the queue.
+void Token_Stream::end_literal() {
+	uint32_t index = strings->add(literal.text, literal.type);
+	for (size_t i = queue.size() - literal.pieces; i < queue.size(); ++i) {
+		queue[i].subtype.literal = index;
+	}
+	literal.pieces = 0;
+}
+
+
+/******************************************************************************
+
+This software is provided under two licenses. Choose whichever you prefer.
+
+
+============================= Apache License V2.0 =============================
+
+Copyright 2020 Matthew Roever
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+	http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+
+================================= MIT License =================================
+
+Copyright (c) 2020 Matthew Roever
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+******************************************************************************/
\ No newline at end of file
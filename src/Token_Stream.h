@@ -0,0 +1,152 @@
+// File:		Token_Stream.h
+// Language:	C++17
+// Purpose:		Produces tokens on demand from a source buffer.
+// License:		At bottom of document.
+
+#ifndef TOKEN_STREAM_H
+#define TOKEN_STREAM_H
+
+// STL
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+// Internal
+#include "Constant_Pool.h"
+#include "Scanner.h"
+#include "Source_Buffer.h"
+#include "String_Pool.h"
+#include "Symbol_Table.h"
+
+
+// Scans a source buffer one token at a time. Produces the same tokens, in the
+// same order, as the statements of scan(), without storing lexemes or tokens.
+// Memory use does not grow with the input, apart from runs of backslashes at
+// the end of a statement and string literals continued across lines. Words
+// are interned in the symbol table, numbers in the constant pool and string
+// literals in the string pool. The buffer, table and pools must outlive the
+// stream.
+class Token_Stream {
+public:
+	Token_Stream(const Source_Buffer& source, Symbol_Table& symbols, Constant_Pool& constants,
+		String_Pool& strings) noexcept;
+
+
+	// Gets the next token. Returns false once the input is used up.
+	//
+	// Error Handling:
+	//	+ Unrecognized characters are returned as ERROR tokens.
+	//	+ Throws std::length_error if a pool is full.
+	bool next(Token& tok);
+
+
+	// Gets the next token without consuming it. Returns false once the input
+	// is used up.
+	//
+	// Error Handling:
+	//	+ Unrecognized characters are returned as ERROR tokens.
+	//	+ Throws std::length_error if a pool is full.
+	bool peek(Token& tok);
+
+
+	// Gets the offset of the /* of a block comment left open at the end of
+	// the input. Returns false if every block comment is closed or the input
+	// is not used up.
+	//
+	// Error Handling:
+	//	+ Never throws.
+	bool open_comment(uint32_t& offset) const noexcept;
+
+private:
+	// Scans until at least one token is ready or the input is used up.
+	void fill();
+
+
+	// Moves the held backslashes to the ready queue.
+	void release_held();
+
+
+	// Adds the open literal to the pool and gives its index to the tokens of
+	// its pieces, which are the last tokens of the queue.
+	void end_literal();
+
+
+	const Source_Buffer* source = nullptr;
+	Symbol_Table* symbols = nullptr;
+	Constant_Pool* constants = nullptr;
+	String_Pool* strings = nullptr;
+
+	// Position in the source
+	size_t lineNumber = 0;
+	std::string_view line{};
+	uint32_t lineBegin = 0;
+	uint32_t index = 0;
+	Line_State state = Line_State::NORMAL;
+	Open_Literal literal{};
+	bool lineStarted = false;
+	bool finished = false;
+
+	// Offset of the /* of the last block comment opened
+	uint32_t commentBegin = 0;
+
+	// Tokens other than held backslashes were returned since the last EOL
+	bool openStatement = false;
+
+	// Backslashes at the end of the statement are held until it is known
+	// whether they end a line. Each line end removes at most one.
+	std::vector<Token> held{};
+
+	// Tokens scanned but not yet returned. Pieces of an open literal are not
+	// returned until the literal ends.
+	std::vector<Token> queue{};
+	size_t queueBegin = 0;
+};
+
+#endif
+
+
+/******************************************************************************
+
+This software is provided under two licenses. Choose whichever you prefer.
+
+
+============================= Apache License V2.0 =============================
+
+Copyright 2020 Matthew Roever
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+	http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+
+================================= MIT License =================================
+
+Copyright (c) 2020 Matthew Roever
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+******************************************************************************/
\ No newline at end of file
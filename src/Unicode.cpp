@@ -0,0 +1,514 @@
+// File:		Unicode.cpp
+// Language:	C++17
+// Purpose:		UTF-8 validation and decoding, Unicode identifier classes.
+// License:		At bottom of document.
+
+// Header
+#include "Unicode.h"
+
+// STL
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+
+// Internal
+#include "CPU_Features.h"
+
+// Platform
+#if SIMD_X86
+#include <immintrin.h>
+#endif
+
+
+// Identifier classes of every code point from U+0080 up, as the sorted
+// points where the classes change. Each entry is (code point << 2) | classes,
+// bit 0 is XID_Start and bit 1 is XID_Continue, and holds until the next
+// entry. Generated from Unicode 14.0.
+static const uint32_t XID_CHANGES[] = {
+	0x00000200, 0x000002AB, 0x000002AC, 0x000002D7, 0x000002D8, 0x000002DE, 0x000002E0, 0x000002EB,
+	0x000002EC, 0x00000303, 0x0000035C, 0x00000363, 0x000003DC, 0x000003E3, 0x00000B08, 0x00000B1B,
+	0x00000B48, 0x00000B83, 0x00000B94, 0x00000BB3, 0x00000BB4, 0x00000BBB, 0x00000BBC, 0x00000C02,
+	0x00000DC3, 0x00000DD4, 0x00000DDB, 0x00000DE0, 0x00000DEF, 0x00000DF8, 0x00000DFF, 0x00000E00,
+	0x00000E1B, 0x00000E1E, 0x00000E23, 0x00000E2C, 0x00000E33, 0x00000E34, 0x00000E3B, 0x00000E88,
+	0x00000E8F, 0x00000FD8, 0x00000FDF, 0x00001208, 0x0000120E, 0x00001220, 0x0000122B, 0x000014C0,
+	0x000014C7, 0x0000155C, 0x00001567, 0x00001568, 0x00001583, 0x00001624, 0x00001646, 0x000016F8,
+	0x000016FE, 0x00001700, 0x00001706, 0x0000170C, 0x00001712, 0x00001718, 0x0000171E, 0x00001720,
+	0x00001743, 0x000017AC, 0x000017BF, 0x000017CC, 0x00001842, 0x0000186C, 0x00001883, 0x0000192E,
+	0x000019A8, 0x000019BB, 0x000019C2, 0x000019C7, 0x00001B50, 0x00001B57, 0x00001B5A, 0x00001B74,
+	0x00001B7E, 0x00001B97, 0x00001B9E, 0x00001BA4, 0x00001BAA, 0x00001BBB, 0x00001BC2, 0x00001BEB,
+	0x00001BF4, 0x00001BFF, 0x00001C00, 0x00001C43, 0x00001C46, 0x00001C4B, 0x00001CC2, 0x00001D2C,
+	0x00001D37, 0x00001E9A, 0x00001EC7, 0x00001EC8, 0x00001F02, 0x00001F2B, 0x00001FAE, 0x00001FD3,
+	0x00001FD8, 0x00001FEB, 0x00001FEC, 0x00001FF6, 0x00001FF8, 0x00002003, 0x0000205A, 0x0000206B,
+	0x0000206E, 0x00002093, 0x00002096, 0x000020A3, 0x000020A6, 0x000020B8, 0x00002103, 0x00002166,
+	0x00002170, 0x00002183, 0x000021AC, 0x000021C3, 0x00002220, 0x00002227, 0x0000223C, 0x00002262,
+	0x00002283, 0x0000232A, 0x00002388, 0x0000238E, 0x00002413, 0x000024EA, 0x000024F7, 0x000024FA,
+	0x00002543, 0x00002546, 0x00002563, 0x0000258A, 0x00002590, 0x0000259A, 0x000025C0, 0x000025C7,
+	0x00002606, 0x00002610, 0x00002617, 0x00002634, 0x0000263F, 0x00002644, 0x0000264F, 0x000026A4,
+	0x000026AB, 0x000026C4, 0x000026CB, 0x000026CC, 0x000026DB, 0x000026E8, 0x000026F2, 0x000026F7,
+	0x000026FA, 0x00002714, 0x0000271E, 0x00002724, 0x0000272E, 0x0000273B, 0x0000273C, 0x0000275E,
+	0x00002760, 0x00002773, 0x00002778, 0x0000277F, 0x0000278A, 0x00002790, 0x0000279A, 0x000027C3,
+	0x000027C8, 0x000027F3, 0x000027F4, 0x000027FA, 0x000027FC, 0x00002806, 0x00002810, 0x00002817,
+	0x0000282C, 0x0000283F, 0x00002844, 0x0000284F, 0x000028A4, 0x000028AB, 0x000028C4, 0x000028CB,
+	0x000028D0, 0x000028D7, 0x000028DC, 0x000028E3, 0x000028E8, 0x000028F2, 0x000028F4, 0x000028FA,
+	0x0000290C, 0x0000291E, 0x00002924, 0x0000292E, 0x00002938, 0x00002946, 0x00002948, 0x00002967,
+	0x00002974, 0x0000297B, 0x0000297C, 0x0000299A, 0x000029CB, 0x000029D6, 0x000029D8, 0x00002A06,
+	0x00002A10, 0x00002A17, 0x00002A38, 0x00002A3F, 0x00002A48, 0x00002A4F, 0x00002AA4, 0x00002AAB,
+	0x00002AC4, 0x00002ACB, 0x00002AD0, 0x00002AD7, 0x00002AE8, 0x00002AF2, 0x00002AF7, 0x00002AFA,
+	0x00002B18, 0x00002B1E, 0x00002B28, 0x00002B2E, 0x00002B38, 0x00002B43, 0x00002B44, 0x00002B83,
+	0x00002B8A, 0x00002B90, 0x00002B9A, 0x00002BC0, 0x00002BE7, 0x00002BEA, 0x00002C00, 0x00002C06,
+	0x00002C10, 0x00002C17, 0x00002C34, 0x00002C3F, 0x00002C44, 0x00002C4F, 0x00002CA4, 0x00002CAB,
+	0x00002CC4, 0x00002CCB, 0x00002CD0, 0x00002CD7, 0x00002CE8, 0x00002CF2, 0x00002CF7, 0x00002CFA,
+	0x00002D14, 0x00002D1E, 0x00002D24, 0x00002D2E, 0x00002D38, 0x00002D56, 0x00002D60, 0x00002D73,
+	0x00002D78, 0x00002D7F, 0x00002D8A, 0x00002D90, 0x00002D9A, 0x00002DC0, 0x00002DC7, 0x00002DC8,
+	0x00002E0A, 0x00002E0F, 0x00002E10, 0x00002E17, 0x00002E2C, 0x00002E3B, 0x00002E44, 0x00002E4B,
+	0x00002E58, 0x00002E67, 0x00002E6C, 0x00002E73, 0x00002E74, 0x00002E7B, 0x00002E80, 0x00002E8F,
+	0x00002E94, 0x00002EA3, 0x00002EAC, 0x00002EBB, 0x00002EE8, 0x00002EFA, 0x00002F0C, 0x00002F1A,
+	0x00002F24, 0x00002F2A, 0x00002F38, 0x00002F43, 0x00002F44, 0x00002F5E, 0x00002F60, 0x00002F9A,
+	0x00002FC0, 0x00003002, 0x00003017, 0x00003034, 0x0000303B, 0x00003044, 0x0000304B, 0x000030A4,
+	0x000030AB, 0x000030E8, 0x000030F2, 0x000030F7, 0x000030FA, 0x00003114, 0x0000311A, 0x00003124,
+	0x0000312A, 0x00003138, 0x00003156, 0x0000315C, 0x00003163, 0x0000316C, 0x00003177, 0x00003178,
+	0x00003183, 0x0000318A, 0x00003190, 0x0000319A, 0x000031C0, 0x00003203, 0x00003206, 0x00003210,
+	0x00003217, 0x00003234, 0x0000323B, 0x00003244, 0x0000324B, 0x000032A4, 0x000032AB, 0x000032D0,
+	0x000032D7, 0x000032E8, 0x000032F2, 0x000032F7, 0x000032FA, 0x00003314, 0x0000331A, 0x00003324,
+	0x0000332A, 0x00003338, 0x00003356, 0x0000335C, 0x00003377, 0x0000337C, 0x00003383, 0x0000338A,
+	0x00003390, 0x0000339A, 0x000033C0, 0x000033C7, 0x000033CC, 0x00003402, 0x00003413, 0x00003434,
+	0x0000343B, 0x00003444, 0x0000344B, 0x000034EE, 0x000034F7, 0x000034FA, 0x00003514, 0x0000351A,
+	0x00003524, 0x0000352A, 0x0000353B, 0x0000353C, 0x00003553, 0x0000355E, 0x00003560, 0x0000357F,
+	0x0000358A, 0x00003590, 0x0000359A, 0x000035C0, 0x000035EB, 0x00003600, 0x00003606, 0x00003610,
+	0x00003617, 0x0000365C, 0x0000366B, 0x000036C8, 0x000036CF, 0x000036F0, 0x000036F7, 0x000036F8,
+	0x00003703, 0x0000371C, 0x0000372A, 0x0000372C, 0x0000373E, 0x00003754, 0x0000375A, 0x0000375C,
+	0x00003762, 0x00003780, 0x0000379A, 0x000037C0, 0x000037CA, 0x000037D0, 0x00003807, 0x000038C6,
+	0x000038CB, 0x000038CE, 0x000038EC, 0x00003903, 0x0000391E, 0x0000393C, 0x00003942, 0x00003968,
+	0x00003A07, 0x00003A0C, 0x00003A13, 0x00003A14, 0x00003A1B, 0x00003A2C, 0x00003A33, 0x00003A90,
+	0x00003A97, 0x00003A98, 0x00003A9F, 0x00003AC6, 0x00003ACB, 0x00003ACE, 0x00003AF7, 0x00003AF8,
+	0x00003B03, 0x00003B14, 0x00003B1B, 0x00003B1C, 0x00003B22, 0x00003B38, 0x00003B42, 0x00003B68,
+	0x00003B73, 0x00003B80, 0x00003C03, 0x00003C04, 0x00003C62, 0x00003C68, 0x00003C82, 0x00003CA8,
+	0x00003CD6, 0x00003CD8, 0x00003CDE, 0x00003CE0, 0x00003CE6, 0x00003CE8, 0x00003CFA, 0x00003D03,
+	0x00003D20, 0x00003D27, 0x00003DB4, 0x00003DC6, 0x00003E14, 0x00003E1A, 0x00003E23, 0x00003E36,
+	0x00003E60, 0x00003E66, 0x00003EF4, 0x00003F1A, 0x00003F1C, 0x00004003, 0x000040AE, 0x000040FF,
+	0x00004102, 0x00004128, 0x00004143, 0x0000415A, 0x0000416B, 0x0000417A, 0x00004187, 0x0000418A,
+	0x00004197, 0x0000419E, 0x000041BB, 0x000041C6, 0x000041D7, 0x0000420A, 0x0000423B, 0x0000423E,
+	0x00004278, 0x00004283, 0x00004318, 0x0000431F, 0x00004320, 0x00004337, 0x00004338, 0x00004343,
+	0x000043EC, 0x000043F3, 0x00004924, 0x0000492B, 0x00004938, 0x00004943, 0x0000495C, 0x00004963,
+	0x00004964, 0x0000496B, 0x00004978, 0x00004983, 0x00004A24, 0x00004A2B, 0x00004A38, 0x00004A43,
+	0x00004AC4, 0x00004ACB, 0x00004AD8, 0x00004AE3, 0x00004AFC, 0x00004B03, 0x00004B04, 0x00004B0B,
+	0x00004B18, 0x00004B23, 0x00004B5C, 0x00004B63, 0x00004C44, 0x00004C4B, 0x00004C58, 0x00004C63,
+	0x00004D6C, 0x00004D76, 0x00004D80, 0x00004DA6, 0x00004DC8, 0x00004E03, 0x00004E40, 0x00004E83,
+	0x00004FD8, 0x00004FE3, 0x00004FF8, 0x00005007, 0x000059B4, 0x000059BF, 0x00005A00, 0x00005A07,
+	0x00005A6C, 0x00005A83, 0x00005BAC, 0x00005BBB, 0x00005BE4, 0x00005C03, 0x00005C4A, 0x00005C58,
+	0x00005C7F, 0x00005CCA, 0x00005CD4, 0x00005D03, 0x00005D4A, 0x00005D50, 0x00005D83, 0x00005DB4,
+	0x00005DBB, 0x00005DC4, 0x00005DCA, 0x00005DD0, 0x00005E03, 0x00005ED2, 0x00005F50, 0x00005F5F,
+	0x00005F60, 0x00005F73, 0x00005F76, 0x00005F78, 0x00005F82, 0x00005FA8, 0x0000602E, 0x00006038,
+	0x0000603E, 0x00006068, 0x00006083, 0x000061E4, 0x00006203, 0x000062A6, 0x000062AB, 0x000062AC,
+	0x000062C3, 0x000063D8, 0x00006403, 0x0000647C, 0x00006482, 0x000064B0, 0x000064C2, 0x000064F0,
+	0x0000651A, 0x00006543, 0x000065B8, 0x000065C3, 0x000065D4, 0x00006603, 0x000066B0, 0x000066C3,
+	0x00006728, 0x00006742, 0x0000676C, 0x00006803, 0x0000685E, 0x00006870, 0x00006883, 0x00006956,
+	0x0000697C, 0x00006982, 0x000069F4, 0x000069FE, 0x00006A28, 0x00006A42, 0x00006A68, 0x00006A9F,
+	0x00006AA0, 0x00006AC2, 0x00006AF8, 0x00006AFE, 0x00006B3C, 0x00006C02, 0x00006C17, 0x00006CD2,
+	0x00006D17, 0x00006D34, 0x00006D42, 0x00006D68, 0x00006DAE, 0x00006DD0, 0x00006E02, 0x00006E0F,
+	0x00006E86, 0x00006EBB, 0x00006EC2, 0x00006EEB, 0x00006F9A, 0x00006FD0, 0x00007003, 0x00007092,
+	0x000070E0, 0x00007102, 0x00007128, 0x00007137, 0x00007142, 0x0000716B, 0x000071F8, 0x00007203,
+	0x00007224, 0x00007243, 0x000072EC, 0x000072F7, 0x00007300, 0x00007342, 0x0000734C, 0x00007352,
+	0x000073A7, 0x000073B6, 0x000073BB, 0x000073D2, 0x000073D7, 0x000073DE, 0x000073EB, 0x000073EC,
+	0x00007403, 0x00007702, 0x00007803, 0x00007C58, 0x00007C63, 0x00007C78, 0x00007C83, 0x00007D18,
+	0x00007D23, 0x00007D38, 0x00007D43, 0x00007D60, 0x00007D67, 0x00007D68, 0x00007D6F, 0x00007D70,
+	0x00007D77, 0x00007D78, 0x00007D7F, 0x00007DF8, 0x00007E03, 0x00007ED4, 0x00007EDB, 0x00007EF4,
+	0x00007EFB, 0x00007EFC, 0x00007F0B, 0x00007F14, 0x00007F1B, 0x00007F34, 0x00007F43, 0x00007F50,
+	0x00007F5B, 0x00007F70, 0x00007F83, 0x00007FB4, 0x00007FCB, 0x00007FD4, 0x00007FDB, 0x00007FF4,
+	0x000080FE, 0x00008104, 0x00008152, 0x00008154, 0x000081C7, 0x000081C8, 0x000081FF, 0x00008200,
+	0x00008243, 0x00008274, 0x00008342, 0x00008374, 0x00008386, 0x00008388, 0x00008396, 0x000083C4,
+	0x0000840B, 0x0000840C, 0x0000841F, 0x00008420, 0x0000842B, 0x00008450, 0x00008457, 0x00008458,
+	0x00008463, 0x00008478, 0x00008493, 0x00008494, 0x0000849B, 0x0000849C, 0x000084A3, 0x000084A4,
+	0x000084AB, 0x000084E8, 0x000084F3, 0x00008500, 0x00008517, 0x00008528, 0x0000853B, 0x0000853C,
+	0x00008583, 0x00008624, 0x0000B003, 0x0000B394, 0x0000B3AF, 0x0000B3BE, 0x0000B3CB, 0x0000B3D0,
+	0x0000B403, 0x0000B498, 0x0000B49F, 0x0000B4A0, 0x0000B4B7, 0x0000B4B8, 0x0000B4C3, 0x0000B5A0,
+	0x0000B5BF, 0x0000B5C0, 0x0000B5FE, 0x0000B603, 0x0000B65C, 0x0000B683, 0x0000B69C, 0x0000B6A3,
+	0x0000B6BC, 0x0000B6C3, 0x0000B6DC, 0x0000B6E3, 0x0000B6FC, 0x0000B703, 0x0000B71C, 0x0000B723,
+	0x0000B73C, 0x0000B743, 0x0000B75C, 0x0000B763, 0x0000B77C, 0x0000B782, 0x0000B800, 0x0000C017,
+	0x0000C020, 0x0000C087, 0x0000C0AA, 0x0000C0C0, 0x0000C0C7, 0x0000C0D8, 0x0000C0E3, 0x0000C0F4,
+	0x0000C107, 0x0000C25C, 0x0000C266, 0x0000C26C, 0x0000C277, 0x0000C280, 0x0000C287, 0x0000C3EC,
+	0x0000C3F3, 0x0000C400, 0x0000C417, 0x0000C4C0, 0x0000C4C7, 0x0000C63C, 0x0000C683, 0x0000C700,
+	0x0000C7C3, 0x0000C800, 0x0000D003, 0x00013700, 0x00013803, 0x00029234, 0x00029343, 0x000293F8,
+	0x00029403, 0x00029834, 0x00029843, 0x00029882, 0x000298AB, 0x000298B0, 0x00029903, 0x000299BE,
+	0x000299C0, 0x000299D2, 0x000299F8, 0x000299FF, 0x00029A7A, 0x00029A83, 0x00029BC2, 0x00029BC8,
+	0x00029C5F, 0x00029C80, 0x00029C8B, 0x00029E24, 0x00029E2F, 0x00029F2C, 0x00029F43, 0x00029F48,
+	0x00029F4F, 0x00029F50, 0x00029F57, 0x00029F68, 0x00029FCB, 0x0002A00A, 0x0002A00F, 0x0002A01A,
+	0x0002A01F, 0x0002A02E, 0x0002A033, 0x0002A08E, 0x0002A0A0, 0x0002A0B2, 0x0002A0B4, 0x0002A103,
+	0x0002A1D0, 0x0002A202, 0x0002A20B, 0x0002A2D2, 0x0002A318, 0x0002A342, 0x0002A368, 0x0002A382,
+	0x0002A3CB, 0x0002A3E0, 0x0002A3EF, 0x0002A3F0, 0x0002A3F7, 0x0002A3FE, 0x0002A42B, 0x0002A49A,
+	0x0002A4B8, 0x0002A4C3, 0x0002A51E, 0x0002A550, 0x0002A583, 0x0002A5F4, 0x0002A602, 0x0002A613,
+	0x0002A6CE, 0x0002A704, 0x0002A73F, 0x0002A742, 0x0002A768, 0x0002A783, 0x0002A796, 0x0002A79B,
+	0x0002A7C2, 0x0002A7EB, 0x0002A7FC, 0x0002A803, 0x0002A8A6, 0x0002A8DC, 0x0002A903, 0x0002A90E,
+	0x0002A913, 0x0002A932, 0x0002A938, 0x0002A942, 0x0002A968, 0x0002A983, 0x0002A9DC, 0x0002A9EB,
+	0x0002A9EE, 0x0002A9FB, 0x0002AAC2, 0x0002AAC7, 0x0002AACA, 0x0002AAD7, 0x0002AADE, 0x0002AAE7,
+	0x0002AAFA, 0x0002AB03, 0x0002AB06, 0x0002AB0B, 0x0002AB0C, 0x0002AB6F, 0x0002AB78, 0x0002AB83,
+	0x0002ABAE, 0x0002ABC0, 0x0002ABCB, 0x0002ABD6, 0x0002ABDC, 0x0002AC07, 0x0002AC1C, 0x0002AC27,
+	0x0002AC3C, 0x0002AC47, 0x0002AC5C, 0x0002AC83, 0x0002AC9C, 0x0002ACA3, 0x0002ACBC, 0x0002ACC3,
+	0x0002AD6C, 0x0002AD73, 0x0002ADA8, 0x0002ADC3, 0x0002AF8E, 0x0002AFAC, 0x0002AFB2, 0x0002AFB8,
+	0x0002AFC2, 0x0002AFE8, 0x0002B003, 0x00035E90, 0x00035EC3, 0x00035F1C, 0x00035F2F, 0x00035FF0,
+	0x0003E403, 0x0003E9B8, 0x0003E9C3, 0x0003EB68, 0x0003EC03, 0x0003EC1C, 0x0003EC4F, 0x0003EC60,
+	0x0003EC77, 0x0003EC7A, 0x0003EC7F, 0x0003ECA4, 0x0003ECAB, 0x0003ECDC, 0x0003ECE3, 0x0003ECF4,
+	0x0003ECFB, 0x0003ECFC, 0x0003ED03, 0x0003ED08, 0x0003ED0F, 0x0003ED14, 0x0003ED1B, 0x0003EEC8,
+	0x0003EF4F, 0x0003F178, 0x0003F193, 0x0003F4F8, 0x0003F543, 0x0003F640, 0x0003F64B, 0x0003F720,
+	0x0003F7C3, 0x0003F7E8, 0x0003F802, 0x0003F840, 0x0003F882, 0x0003F8C0, 0x0003F8CE, 0x0003F8D4,
+	0x0003F936, 0x0003F940, 0x0003F9C7, 0x0003F9C8, 0x0003F9CF, 0x0003F9D0, 0x0003F9DF, 0x0003F9E0,
+	0x0003F9E7, 0x0003F9E8, 0x0003F9EF, 0x0003F9F0, 0x0003F9F7, 0x0003F9F8, 0x0003F9FF, 0x0003FBF4,
+	0x0003FC42, 0x0003FC68, 0x0003FC87, 0x0003FCEC, 0x0003FCFE, 0x0003FD00, 0x0003FD07, 0x0003FD6C,
+	0x0003FD9B, 0x0003FE7A, 0x0003FE83, 0x0003FEFC, 0x0003FF0B, 0x0003FF20, 0x0003FF2B, 0x0003FF40,
+	0x0003FF4B, 0x0003FF60, 0x0003FF6B, 0x0003FF74, 0x00040003, 0x00040030, 0x00040037, 0x0004009C,
+	0x000400A3, 0x000400EC, 0x000400F3, 0x000400F8, 0x000400FF, 0x00040138, 0x00040143, 0x00040178,
+	0x00040203, 0x000403EC, 0x00040503, 0x000405D4, 0x000407F6, 0x000407F8, 0x00040A03, 0x00040A74,
+	0x00040A83, 0x00040B44, 0x00040B82, 0x00040B84, 0x00040C03, 0x00040C80, 0x00040CB7, 0x00040D2C,
+	0x00040D43, 0x00040DDA, 0x00040DEC, 0x00040E03, 0x00040E78, 0x00040E83, 0x00040F10, 0x00040F23,
+	0x00040F40, 0x00040F47, 0x00040F58, 0x00041003, 0x00041278, 0x00041282, 0x000412A8, 0x000412C3,
+	0x00041350, 0x00041363, 0x000413F0, 0x00041403, 0x000414A0, 0x000414C3, 0x00041590, 0x000415C3,
+	0x000415EC, 0x000415F3, 0x0004162C, 0x00041633, 0x0004164C, 0x00041653, 0x00041658, 0x0004165F,
+	0x00041688, 0x0004168F, 0x000416C8, 0x000416CF, 0x000416E8, 0x000416EF, 0x000416F4, 0x00041803,
+	0x00041CDC, 0x00041D03, 0x00041D58, 0x00041D83, 0x00041DA0, 0x00041E03, 0x00041E18, 0x00041E1F,
+	0x00041EC4, 0x00041ECB, 0x00041EEC, 0x00042003, 0x00042018, 0x00042023, 0x00042024, 0x0004202B,
+	0x000420D8, 0x000420DF, 0x000420E4, 0x000420F3, 0x000420F4, 0x000420FF, 0x00042158, 0x00042183,
+	0x000421DC, 0x00042203, 0x0004227C, 0x00042383, 0x000423CC, 0x000423D3, 0x000423D8, 0x00042403,
+	0x00042458, 0x00042483, 0x000424E8, 0x00042603, 0x000426E0, 0x000426FB, 0x00042700, 0x00042803,
+	0x00042806, 0x00042810, 0x00042816, 0x0004281C, 0x00042832, 0x00042843, 0x00042850, 0x00042857,
+	0x00042860, 0x00042867, 0x000428D8, 0x000428E2, 0x000428EC, 0x000428FE, 0x00042900, 0x00042983,
+	0x000429F4, 0x00042A03, 0x00042A74, 0x00042B03, 0x00042B20, 0x00042B27, 0x00042B96, 0x00042B9C,
+	0x00042C03, 0x00042CD8, 0x00042D03, 0x00042D58, 0x00042D83, 0x00042DCC, 0x00042E03, 0x00042E48,
+	0x00043003, 0x00043124, 0x00043203, 0x000432CC, 0x00043303, 0x000433CC, 0x00043403, 0x00043492,
+	0x000434A0, 0x000434C2, 0x000434E8, 0x00043A03, 0x00043AA8, 0x00043AAE, 0x00043AB4, 0x00043AC3,
+	0x00043AC8, 0x00043C03, 0x00043C74, 0x00043C9F, 0x00043CA0, 0x00043CC3, 0x00043D1A, 0x00043D44,
+	0x00043DC3, 0x00043E0A, 0x00043E18, 0x00043EC3, 0x00043F14, 0x00043F83, 0x00043FDC, 0x00044002,
+	0x0004400F, 0x000440E2, 0x0004411C, 0x0004419A, 0x000441C7, 0x000441CE, 0x000441D7, 0x000441D8,
+	0x000441FE, 0x0004420F, 0x000442C2, 0x000442EC, 0x0004430A, 0x0004430C, 0x00044343, 0x000443A4,
+	0x000443C2, 0x000443E8, 0x00044402, 0x0004440F, 0x0004449E, 0x000444D4, 0x000444DA, 0x00044500,
+	0x00044513, 0x00044516, 0x0004451F, 0x00044520, 0x00044543, 0x000445CE, 0x000445D0, 0x000445DB,
+	0x000445DC, 0x00044602, 0x0004460F, 0x000446CE, 0x00044707, 0x00044714, 0x00044726, 0x00044734,
+	0x0004473A, 0x0004476B, 0x0004476C, 0x00044773, 0x00044774, 0x00044803, 0x00044848, 0x0004484F,
+	0x000448B2, 0x000448E0, 0x000448FA, 0x000448FC, 0x00044A03, 0x00044A1C, 0x00044A23, 0x00044A24,
+	0x00044A2B, 0x00044A38, 0x00044A3F, 0x00044A78, 0x00044A7F, 0x00044AA4, 0x00044AC3, 0x00044B7E,
+	0x00044BAC, 0x00044BC2, 0x00044BE8, 0x00044C02, 0x00044C10, 0x00044C17, 0x00044C34, 0x00044C3F,
+	0x00044C44, 0x00044C4F, 0x00044CA4, 0x00044CAB, 0x00044CC4, 0x00044CCB, 0x00044CD0, 0x00044CD7,
+	0x00044CE8, 0x00044CEE, 0x00044CF7, 0x00044CFA, 0x00044D14, 0x00044D1E, 0x00044D24, 0x00044D2E,
+	0x00044D38, 0x00044D43, 0x00044D44, 0x00044D5E, 0x00044D60, 0x00044D77, 0x00044D8A, 0x00044D90,
+	0x00044D9A, 0x00044DB4, 0x00044DC2, 0x00044DD4, 0x00045003, 0x000450D6, 0x0004511F, 0x0004512C,
+	0x00045142, 0x00045168, 0x0004517A, 0x0004517F, 0x00045188, 0x00045203, 0x000452C2, 0x00045313,
+	0x00045318, 0x0004531F, 0x00045320, 0x00045342, 0x00045368, 0x00045603, 0x000456BE, 0x000456D8,
+	0x000456E2, 0x00045704, 0x00045763, 0x00045772, 0x00045778, 0x00045803, 0x000458C2, 0x00045904,
+	0x00045913, 0x00045914, 0x00045942, 0x00045968, 0x00045A03, 0x00045AAE, 0x00045AE3, 0x00045AE4,
+	0x00045B02, 0x00045B28, 0x00045C03, 0x00045C6C, 0x00045C76, 0x00045CB0, 0x00045CC2, 0x00045CE8,
+	0x00045D03, 0x00045D1C, 0x00046003, 0x000460B2, 0x000460EC, 0x00046283, 0x00046382, 0x000463A8,
+	0x000463FF, 0x0004641C, 0x00046427, 0x00046428, 0x00046433, 0x00046450, 0x00046457, 0x0004645C,
+	0x00046463, 0x000464C2, 0x000464D8, 0x000464DE, 0x000464E4, 0x000464EE, 0x000464FF, 0x00046502,
+	0x00046507, 0x0004650A, 0x00046510, 0x00046542, 0x00046568, 0x00046683, 0x000466A0, 0x000466AB,
+	0x00046746, 0x00046760, 0x0004676A, 0x00046787, 0x00046788, 0x0004678F, 0x00046792, 0x00046794,
+	0x00046803, 0x00046806, 0x0004682F, 0x000468CE, 0x000468EB, 0x000468EE, 0x000468FC, 0x0004691E,
+	0x00046920, 0x00046943, 0x00046946, 0x00046973, 0x00046A2A, 0x00046A68, 0x00046A77, 0x00046A78,
+	0x00046AC3, 0x00046BE4, 0x00047003, 0x00047024, 0x0004702B, 0x000470BE, 0x000470DC, 0x000470E2,
+	0x00047103, 0x00047104, 0x00047142, 0x00047168, 0x000471CB, 0x00047240, 0x0004724A, 0x000472A0,
+	0x000472A6, 0x000472DC, 0x00047403, 0x0004741C, 0x00047423, 0x00047428, 0x0004742F, 0x000474C6,
+	0x000474DC, 0x000474EA, 0x000474EC, 0x000474F2, 0x000474F8, 0x000474FE, 0x0004751B, 0x0004751E,
+	0x00047520, 0x00047542, 0x00047568, 0x00047583, 0x00047598, 0x0004759F, 0x000475A4, 0x000475AB,
+	0x0004762A, 0x0004763C, 0x00047642, 0x00047648, 0x0004764E, 0x00047663, 0x00047664, 0x00047682,
+	0x000476A8, 0x00047B83, 0x00047BCE, 0x00047BDC, 0x00047EC3, 0x00047EC4, 0x00048003, 0x00048E68,
+	0x00049003, 0x000491BC, 0x00049203, 0x00049510, 0x0004BE43, 0x0004BFC4, 0x0004C003, 0x0004D0BC,
+	0x00051003, 0x0005191C, 0x0005A003, 0x0005A8E4, 0x0005A903, 0x0005A97C, 0x0005A982, 0x0005A9A8,
+	0x0005A9C3, 0x0005AAFC, 0x0005AB02, 0x0005AB28, 0x0005AB43, 0x0005ABB8, 0x0005ABC2, 0x0005ABD4,
+	0x0005AC03, 0x0005ACC2, 0x0005ACDC, 0x0005AD03, 0x0005AD10, 0x0005AD42, 0x0005AD68, 0x0005AD8F,
+	0x0005ADE0, 0x0005ADF7, 0x0005AE40, 0x0005B903, 0x0005BA00, 0x0005BC03, 0x0005BD2C, 0x0005BD3E,
+	0x0005BD43, 0x0005BD46, 0x0005BE20, 0x0005BE3E, 0x0005BE4F, 0x0005BE80, 0x0005BF83, 0x0005BF88,
+	0x0005BF8F, 0x0005BF92, 0x0005BF94, 0x0005BFC2, 0x0005BFC8, 0x0005C003, 0x00061FE0, 0x00062003,
+	0x00063358, 0x00063403, 0x00063424, 0x0006BFC3, 0x0006BFD0, 0x0006BFD7, 0x0006BFF0, 0x0006BFF7,
+	0x0006BFFC, 0x0006C003, 0x0006C48C, 0x0006C543, 0x0006C54C, 0x0006C593, 0x0006C5A0, 0x0006C5C3,
+	0x0006CBF0, 0x0006F003, 0x0006F1AC, 0x0006F1C3, 0x0006F1F4, 0x0006F203, 0x0006F224, 0x0006F243,
+	0x0006F268, 0x0006F276, 0x0006F27C, 0x00073C02, 0x00073CB8, 0x00073CC2, 0x00073D1C, 0x00074596,
+	0x000745A8, 0x000745B6, 0x000745CC, 0x000745EE, 0x0007460C, 0x00074616, 0x00074630, 0x000746AA,
+	0x000746B8, 0x0007490A, 0x00074914, 0x00075003, 0x00075154, 0x0007515B, 0x00075274, 0x0007527B,
+	0x00075280, 0x0007528B, 0x0007528C, 0x00075297, 0x0007529C, 0x000752A7, 0x000752B4, 0x000752BB,
+	0x000752E8, 0x000752EF, 0x000752F0, 0x000752F7, 0x00075310, 0x00075317, 0x00075418, 0x0007541F,
+	0x0007542C, 0x00075437, 0x00075454, 0x0007545B, 0x00075474, 0x0007547B, 0x000754E8, 0x000754EF,
+	0x000754FC, 0x00075503, 0x00075514, 0x0007551B, 0x0007551C, 0x0007552B, 0x00075544, 0x0007554B,
+	0x00075A98, 0x00075AA3, 0x00075B04, 0x00075B0B, 0x00075B6C, 0x00075B73, 0x00075BEC, 0x00075BF3,
+	0x00075C54, 0x00075C5B, 0x00075CD4, 0x00075CDB, 0x00075D3C, 0x00075D43, 0x00075DBC, 0x00075DC3,
+	0x00075E24, 0x00075E2B, 0x00075EA4, 0x00075EAB, 0x00075F0C, 0x00075F13, 0x00075F30, 0x00075F3A,
+	0x00076000, 0x00076802, 0x000768DC, 0x000768EE, 0x000769B4, 0x000769D6, 0x000769D8, 0x00076A12,
+	0x00076A14, 0x00076A6E, 0x00076A80, 0x00076A86, 0x00076AC0, 0x00077C03, 0x00077C7C, 0x00078002,
+	0x0007801C, 0x00078022, 0x00078064, 0x0007806E, 0x00078088, 0x0007808E, 0x00078094, 0x0007809A,
+	0x000780AC, 0x00078403, 0x000784B4, 0x000784C2, 0x000784DF, 0x000784F8, 0x00078502, 0x00078528,
+	0x0007853B, 0x0007853C, 0x00078A43, 0x00078ABA, 0x00078ABC, 0x00078B03, 0x00078BB2, 0x00078BE8,
+	0x00079F83, 0x00079F9C, 0x00079FA3, 0x00079FB0, 0x00079FB7, 0x00079FBC, 0x00079FC3, 0x00079FFC,
+	0x0007A003, 0x0007A314, 0x0007A342, 0x0007A35C, 0x0007A403, 0x0007A512, 0x0007A52F, 0x0007A530,
+	0x0007A542, 0x0007A568, 0x0007B803, 0x0007B810, 0x0007B817, 0x0007B880, 0x0007B887, 0x0007B88C,
+	0x0007B893, 0x0007B894, 0x0007B89F, 0x0007B8A0, 0x0007B8A7, 0x0007B8CC, 0x0007B8D3, 0x0007B8E0,
+	0x0007B8E7, 0x0007B8E8, 0x0007B8EF, 0x0007B8F0, 0x0007B90B, 0x0007B90C, 0x0007B91F, 0x0007B920,
+	0x0007B927, 0x0007B928, 0x0007B92F, 0x0007B930, 0x0007B937, 0x0007B940, 0x0007B947, 0x0007B94C,
+	0x0007B953, 0x0007B954, 0x0007B95F, 0x0007B960, 0x0007B967, 0x0007B968, 0x0007B96F, 0x0007B970,
+	0x0007B977, 0x0007B978, 0x0007B97F, 0x0007B980, 0x0007B987, 0x0007B98C, 0x0007B993, 0x0007B994,
+	0x0007B99F, 0x0007B9AC, 0x0007B9B3, 0x0007B9CC, 0x0007B9D3, 0x0007B9E0, 0x0007B9E7, 0x0007B9F4,
+	0x0007B9FB, 0x0007B9FC, 0x0007BA03, 0x0007BA28, 0x0007BA2F, 0x0007BA70, 0x0007BA87, 0x0007BA90,
+	0x0007BA97, 0x0007BAA8, 0x0007BAAF, 0x0007BAF0, 0x0007EFC2, 0x0007EFE8, 0x00080003, 0x000A9B80,
+	0x000A9C03, 0x000ADCE4, 0x000ADD03, 0x000AE078, 0x000AE083, 0x000B3A88, 0x000B3AC3, 0x000BAF84,
+	0x000BE003, 0x000BE878, 0x000C0003, 0x000C4D2C, 0x00380402, 0x003807C0,
+};
+
+
+// Gets the identifier classes of a code point above ASCII.
+static uint32_t xid_classes(uint32_t cp) noexcept {
+	const uint32_t* it = std::upper_bound(std::begin(XID_CHANGES), std::end(XID_CHANGES), (cp << 2) | 3);
+	return (it == std::begin(XID_CHANGES)) ? 0 : it[-1] & 3;
+}
+
+
+// Checks the non-ASCII characters starting at data[i] one at a time. Returns
+// the index of the next ASCII byte, or the index of an invalid byte in bad.
+static uint32_t validate_sequences(const char* data, uint32_t i, uint32_t length, bool& bad) noexcept {
+	while (i < length && static_cast<uint8_t>(data[i]) >= 0x80) {
+		uint32_t cp = 0;
+		uint32_t count = decode_utf8(data + i, length - i, cp);
+		if (count == 0) {
+			bad = true;
+			return i;
+		}
+		i += count;
+	}
+	return i;
+}
+
+
+// Skips ASCII 8 bytes at a time.
+static uint32_t validate_utf8_scalar(const char* data, uint32_t i, uint32_t length) noexcept {
+	bool bad = false;
+	while (i < length) {
+		for (; i + 8 <= length; i += 8) {
+			uint64_t v = 0;
+			std::memcpy(&v, data + i, 8);
+			v &= 0x8080808080808080;
+			if (v != 0) {
+				i += count_trailing_zeros(v) / 8;
+				break;
+			}
+		}
+		for (; i < length && static_cast<uint8_t>(data[i]) < 0x80; ++i) {
+		}
+		i = validate_sequences(data, i, length, bad);
+		if (bad) {
+			return i;
+		}
+	}
+	return length;
+}
+
+
+#if SIMD_X86
+// Skips ASCII 16 bytes at a time. SSE2 is part of x86-64.
+static uint32_t validate_utf8_sse2(const char* data, uint32_t i, uint32_t length) noexcept {
+	bool bad = false;
+	while (i + 16 <= length) {
+		__m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+		uint32_t high = static_cast<uint32_t>(_mm_movemask_epi8(v));
+		if (high == 0) {
+			i += 16;
+			continue;
+		}
+		i = validate_sequences(data, i + count_trailing_zeros(high), length, bad);
+		if (bad) {
+			return i;
+		}
+	}
+	return validate_utf8_scalar(data, i, length);
+}
+
+
+// Skips ASCII 32 bytes at a time.
+TARGET_AVX2 static uint32_t validate_utf8_avx2(const char* data, uint32_t i, uint32_t length) noexcept {
+	bool bad = false;
+	while (i + 32 <= length) {
+		__m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+		uint32_t high = static_cast<uint32_t>(_mm256_movemask_epi8(v));
+		if (high == 0) {
+			i += 32;
+			continue;
+		}
+		i = validate_sequences(data, i + count_trailing_zeros(high), length, bad);
+		if (bad) {
+			return i;
+		}
+	}
+	return validate_utf8_scalar(data, i, length);
+}
+#endif
+
+
+// Signature shared by every implementation.
+using Validate_Function = uint32_t(*)(const char*, uint32_t, uint32_t) noexcept;
+
+
+// Picks the widest implementation the processor supports.
+static Validate_Function select_validate_utf8() {
+#if SIMD_X86
+	if (cpu_features().avx2) {
+		return validate_utf8_avx2;
+	}
+	return validate_utf8_sse2;
+#else
+	return validate_utf8_scalar;
+#endif
+}
+
+
+// Selected once at startup.
+static const Validate_Function validate_utf8_impl = select_validate_utf8();
+
+
+// Finds the first byte of data[0, length) that does not belong to a well
+// formed UTF-8 sequence: overlong forms, surrogates, code points above
+// U+10FFFF and truncated sequences are all rejected. Returns length if the
+// text is valid. ASCII is skipped 32 (AVX2) or 16 (SSE2) bytes at a time,
+// selected once at startup, multibyte sequences are checked one at a time.
+//
+// Error Handling:
+//	+ Never throws.
+uint32_t validate_utf8(const char* data, uint32_t length) noexcept {
+	return validate_utf8_impl(data, 0, length);
+}
+
+
+// Decodes the character starting at s[0] into cp. Returns the number of bytes
+// in the character, or 0 if s[0, length) does not start with a well formed
+// UTF-8 sequence.
+//
+// Error Handling:
+//	+ Never throws.
+uint32_t decode_utf8(const char* s, uint32_t length, uint32_t& cp) noexcept {
+	const uint8_t* u = reinterpret_cast<const uint8_t*>(s);
+	if (length == 0) {
+		return 0;
+	}
+	if (u[0] < 0x80) {
+		cp = u[0];
+		return 1;
+	}
+
+	// The lead byte gives the length and the range of the second byte, which
+	// rules out overlong forms, surrogates and code points above U+10FFFF
+	uint32_t count = 0;
+	uint8_t low = 0x80;
+	uint8_t high = 0xBF;
+	uint32_t value = 0;
+	if (u[0] < 0xC2) {
+		return 0;
+	}
+	else if (u[0] < 0xE0) {
+		count = 2;
+		value = u[0] & 0x1F;
+	}
+	else if (u[0] < 0xF0) {
+		count = 3;
+		value = u[0] & 0x0F;
+		low = (u[0] == 0xE0) ? 0xA0 : low;
+		high = (u[0] == 0xED) ? 0x9F : high;
+	}
+	else if (u[0] < 0xF5) {
+		count = 4;
+		value = u[0] & 0x07;
+		low = (u[0] == 0xF0) ? 0x90 : low;
+		high = (u[0] == 0xF4) ? 0x8F : high;
+	}
+	else {
+		return 0;
+	}
+	if (length < count || u[1] < low || u[1] > high) {
+		return 0;
+	}
+	value = (value << 6) | (u[1] & 0x3F);
+	for (uint32_t i = 2; i < count; ++i) {
+		if ((u[i] & 0xC0) != 0x80) {
+			return 0;
+		}
+		value = (value << 6) | (u[i] & 0x3F);
+	}
+	cp = value;
+	return count;
+}
+
+
+// Checks if a code point may start an identifier (XID_Start, plus _).
+//
+// Error Handling:
+//	+ Never throws.
+bool is_xid_start(uint32_t cp) noexcept {
+	if (cp < 0x80) {
+		return (cp >= 'A' && cp <= 'Z') || (cp >= 'a' && cp <= 'z') || cp == '_';
+	}
+	return xid_classes(cp) & 1;
+}
+
+
+// Checks if a code point may follow the start of an identifier
+// (XID_Continue).
+//
+// Error Handling:
+//	+ Never throws.
+bool is_xid_continue(uint32_t cp) noexcept {
+	if (cp < 0x80) {
+		return (cp >= '0' && cp <= '9') || (cp >= 'A' && cp <= 'Z') || (cp >= 'a' && cp <= 'z') || cp == '_';
+	}
+	return xid_classes(cp) & 2;
+}
+
+
+// Checks if a code point is Pattern_White_Space: tab, line feed, vertical
+// tab, form feed, carriage return, space, U+0085, U+200E, U+200F, U+2028 and
+// U+2029.
+//
+// Error Handling:
+//	+ Never throws.
+bool is_pattern_whitespace(uint32_t cp) noexcept {
+	return (cp >= 0x09 && cp <= 0x0D) || cp == 0x20 || cp == 0x85 || cp == 0x200E || cp == 0x200F
+		|| cp == 0x2028 || cp == 0x2029;
+}
+
+
+/******************************************************************************
+
+This software is provided under two licenses. Choose whichever you prefer.
+
+
+============================= Apache License V2.0 =============================
+
+Copyright 2020 Matthew Roever
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+	http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+
+================================= MIT License =================================
+
+Copyright (c) 2020 Matthew Roever
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+******************************************************************************/
\ No newline at end of file
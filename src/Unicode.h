@@ -0,0 +1,103 @@
+// File:		Unicode.h
+// Language:	C++17
+// Purpose:		UTF-8 validation and decoding, Unicode identifier classes.
+// License:		At bottom of document.
+
+#ifndef UNICODE_H
+#define UNICODE_H
+
+// STL
+#include <cstdint>
+
+
+// Finds the first byte of data[0, length) that does not belong to a well
+// formed UTF-8 sequence: overlong forms, surrogates, code points above
+// U+10FFFF and truncated sequences are all rejected. Returns length if the
+// text is valid. ASCII is skipped 32 (AVX2) or 16 (SSE2) bytes at a time,
+// selected once at startup, multibyte sequences are checked one at a time.
+//
+// Error Handling:
+//	+ Never throws.
+uint32_t validate_utf8(const char* data, uint32_t length) noexcept;
+
+
+// Decodes the character starting at s[0] into cp. Returns the number of bytes
+// in the character, or 0 if s[0, length) does not start with a well formed
+// UTF-8 sequence.
+//
+// Error Handling:
+//	+ Never throws.
+uint32_t decode_utf8(const char* s, uint32_t length, uint32_t& cp) noexcept;
+
+
+// Checks if a code point may start an identifier (XID_Start, plus _).
+//
+// Error Handling:
+//	+ Never throws.
+bool is_xid_start(uint32_t cp) noexcept;
+
+
+// Checks if a code point may follow the start of an identifier
+// (XID_Continue).
+//
+// Error Handling:
+//	+ Never throws.
+bool is_xid_continue(uint32_t cp) noexcept;
+
+
+// Checks if a code point is Pattern_White_Space: tab, line feed, vertical
+// tab, form feed, carriage return, space, U+0085, U+200E, U+200F, U+2028 and
+// U+2029.
+//
+// Error Handling:
+//	+ Never throws.
+bool is_pattern_whitespace(uint32_t cp) noexcept;
+
+#endif
+
+
+/******************************************************************************
+
+This software is provided under two licenses. Choose whichever you prefer.
+
+
+============================= Apache License V2.0 =============================
+
+Copyright 2020 Matthew Roever
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+	http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+
+================================= MIT License =================================
+
+Copyright (c) 2020 Matthew Roever
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+******************************************************************************/
\ No newline at end of file
@@ -0,0 +1,200 @@
+// File:		Vocabulary.h
+// Language:	C++17
+// Purpose:		Single definition of the token vocabularies. The enums, the
+//				scanner's spelling tables and the names printed for each
+//				value are all generated from the lists below.
+// License:		At bottom of document.
+
+#ifndef VOCABULARY_H
+#define VOCABULARY_H
+
+// STL
+#include <cstdint>
+
+
+// Each list calls X(NAME, text) once per value, in enum order. NAME is the
+// enumerator, text is what the scanner matches or what is printed. Comments
+// inside the lists must be /* */ since the lines are joined.
+
+
+// Token types, text is printed by the token listing.
+#define TOKEN_TYPE_LIST(X) \
+	X(EOL, "EOL")				/* End of Line - no text */ \
+	X(ERROR, "ERROR     ")		/* Unrecognized characters */ \
+	X(KEYWORD, "KEYWORD   ") \
+	X(NUMBER, "NUMBER    ") \
+	X(OPERATOR, "OPERATOR  ") \
+	X(STRING, "STRING    ") \
+	X(WORD, "WORD      ")
+
+
+// Keywords, text is the spelling. New keywords only need to be added here.
+#define KEYWORD_LIST(X) \
+	/* Types */ \
+	X(I8, "i8") \
+	X(I16, "i16") \
+	X(I32, "i32") \
+	X(I64, "i64") \
+	X(U8, "u8") \
+	X(U16, "u16") \
+	X(U32, "u32") \
+	X(U64, "u64") \
+	X(F16, "f16") \
+	X(F32, "f32") \
+	X(F64, "f64") \
+	\
+	/* Data */ \
+	X(CLASS, "class") \
+	X(LET, "let") \
+	X(SELF, "self") \
+	X(STRUCT, "struct") \
+	X(VAR, "var") \
+	\
+	/* Functional */ \
+	X(CREF, "cref") \
+	X(FN, "fn") \
+	X(MOVE, "move") \
+	X(REF, "ref") \
+	X(RETURN, "return") \
+	\
+	/* Other */ \
+	X(NAMESPACE, "namespace")
+
+
+// Operators, text is the spelling. New operators only need to be added here.
+#define OPERATOR_LIST(X) \
+	X(ACCESSOR, ".") \
+	X(ARROW, "->") \
+	X(ASTERISK, "*") \
+	X(BACK_SLASH, "\\") \
+	X(BITWISE_AND, "&") \
+	X(BITWISE_AND_EQUAL, "&=") \
+	X(BITWISE_NOT, "~") \
+	X(BITWISE_OR, "|") \
+	X(BITWISE_OR_EQUAL, "|=") \
+	X(BITWISE_XOR, "^") \
+	X(BITWISE_XOR_EQUAL, "^=") \
+	X(CLOSED_ATTRIBUTE, "]]") \
+	X(CLOSED_CURLY, "}") \
+	X(CLOSED_PAREN, ")") \
+	X(CLOSED_SQUARE, "]") \
+	X(COLON, ":") \
+	X(COMMA, ",") \
+	X(DECREMENT, "--") \
+	X(DIVIDE, "/") \
+	X(DIVIDE_EQUALS, "/=") \
+	X(EQUALS, "=") \
+	X(EQUALS_TO, "==") \
+	X(GREATER, ">") \
+	X(GREATER_EQUAL, ">=") \
+	X(INCREMENT, "++") \
+	X(LEFT_SHIFT, "<<") \
+	X(LEFT_SHIFT_EQUAL, "<<=") \
+	X(LESS, "<") \
+	X(LESS_EQUAL, "<=") \
+	X(LOGICAL_AND, "&&") \
+	X(LOGICAL_NOT, "!") \
+	X(LOGICAL_OR, "||") \
+	X(LOGICAL_XOR, "^^") \
+	X(MACRO, "#") \
+	X(MATCH_CASE, "=>") \
+	X(MINUS, "-") \
+	X(MINUS_EQUAL, "-=") \
+	X(MODULO, "%") \
+	X(MODULO_EQUAL, "%=") \
+	X(MULTIPLY_EQUAL, "*=") \
+	X(NOT_EQUAL, "!=") \
+	X(OPEN_ATTRIBUTE, "[[") \
+	X(OPEN_CURLY, "{") \
+	X(OPEN_PAREN, "(") \
+	X(OPEN_SQUARE, "[") \
+	X(PLUS, "+") \
+	X(PLUS_EQUAL, "+=") \
+	X(RIGHT_SHIFT, ">>") \
+	X(RIGHT_SHIFT_EQUAL, ">>=") \
+	X(SCOPE, "::") \
+	X(SEMICOLON, ";") \
+	X(TERNARY, "?") \
+	X(THREE_WAY_COMP, "<=>")
+
+
+// Spellings of operators that are not yet supported. The enum adds
+// UNSUPPORTED_OPERATOR after OPERATOR_LIST for all of them.
+#define UNSUPPORTED_OPERATOR_LIST(X) \
+	X(UNSUPPORTED_OPERATOR, "`") \
+	X(UNSUPPORTED_OPERATOR, "@")
+
+
+// Numeric constants, text is printed.
+#define NUMBER_TYPE_LIST(X) \
+	X(BINARY, "BINARY") \
+	X(DECIMAL, "DECIMAL") \
+	X(HEX, "HEX") \
+	X(INTEGER, "INTEGER")
+
+
+// String literals, text is printed.
+#define STRING_TYPE_LIST(X) \
+	X(DOUBLE, "DOUBLE")			/* " */ \
+	X(SINGLE, "SINGLE")			/* ' */
+
+
+// Expands a list entry to its enumerator.
+#define VOCABULARY_ENUMERATOR(name, text) name,
+
+
+// Expands a list entry to its text.
+#define VOCABULARY_TEXT(name, text) text,
+
+
+// Expands a list entry to its enumerator's name.
+#define VOCABULARY_NAME(name, text) #name,
+
+#endif
+
+
+/******************************************************************************
+
+This software is provided under two licenses. Choose whichever you prefer.
+
+
+============================= Apache License V2.0 =============================
+
+Copyright 2020 Matthew Roever
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+	http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+
+================================= MIT License =================================
+
+Copyright (c) 2020 Matthew Roever
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+******************************************************************************/
\ No newline at end of file
@@ -0,0 +1,241 @@
+// File:		Number_Scan_Test.cpp
+// Language:	C++17
+// Purpose:		Checks number scanning against the byte at a time scanner it replaced.
+// License:		At bottom of document.
+
+// STL
+#include <cstdlib>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <string_view>
+
+// Internal
+#include "Scanner_Support.h"
+#include "Test.h"
+
+
+/**************************************************************************
+*
+*	Byte at a time number scanner, kept as the reference
+*
+*************************************************************************/
+
+// Checks if the character is a binary number (0, 1).
+static bool is_binary_number(char c) {
+	return c == '0' || c == '1';
+}
+
+
+// Checks if the character is a decimal number (0-9).
+static bool is_decimal_number(char c) {
+	return c >= '0' && c <= '9';
+}
+
+
+// Checks if the character is a hexadecimal number (0-9), (a-f), (A-F).
+static bool is_hex_number(char c) {
+	return is_decimal_number(c) || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F');
+}
+
+
+// Scans a run of digits of a class and _ separators. A separator must be
+// followed by a digit or end the line.
+static uint32_t scan_run(std::string_view s, uint32_t index, bool (*is_digit)(char)) {
+	for (uint32_t i = index; i < s.length(); ++i) {
+		if (is_digit(s[i])) {
+			continue;
+		}
+		else if (s[i] == '_') {
+			if (++i < s.length()) {
+				if (!is_digit(s[i])) {
+					return i - 1;
+				}
+			}
+		}
+		else {
+			return i;
+		}
+	}
+	return (uint32_t)s.length();
+}
+
+
+// Scans for binary constants 0b(0-1)*.
+static uint32_t scan_binary(std::string_view s, uint32_t index) {
+	return is_binary_number(s[index]) ? scan_run(s, index + 1, is_binary_number) : index;
+}
+
+
+// Scans for hex constants 0x(0-9, a-f, A-F)*.
+static uint32_t scan_hex(std::string_view s, uint32_t index) {
+	return is_hex_number(s[index]) ? scan_run(s, index + 1, is_hex_number) : index;
+}
+
+
+// Scans for integer constants (0-9)*.
+static uint32_t scan_integer(std::string_view s, uint32_t index) {
+	return scan_run(s, index, is_decimal_number);
+}
+
+
+// Scans for decimal constants (0-9)*.(0-9)*(e, E)(+, -)(0-9)*.
+static uint32_t scan_decimal(std::string_view s, uint32_t index) {
+	uint32_t newIndex = scan_integer(s, index);
+	if ((newIndex + 1) < s.length() && (s[newIndex] == 'e' || s[newIndex] == 'E')) {
+		uint32_t digits = newIndex + ((s[newIndex + 1] == '+' || s[newIndex + 1] == '-') ? 2 : 1);
+		uint32_t nextIndex = scan_integer(s, digits);
+		return (nextIndex != digits) ? nextIndex : newIndex;
+	}
+	return newIndex;
+}
+
+
+// Scans for numeric constants.
+static uint32_t scan_number(std::string_view s, uint32_t index, Number_Type& type) {
+	if (!is_decimal_number(s[index])) {
+		return index;
+	}
+
+	// Binary or hexadecimal numbers
+	if (s[index] == '0' && index + 2 < s.length()) {
+		if (s[index + 1] == 'b') {
+			uint32_t newIndex = scan_binary(s, index + 2);
+			if (newIndex != index + 2) {
+				type = Number_Type::BINARY;
+				return newIndex;
+			}
+		}
+		else if (s[index + 1] == 'x') {
+			uint32_t newIndex = scan_hex(s, index + 2);
+			if (newIndex != index + 2) {
+				type = Number_Type::HEX;
+				return newIndex;
+			}
+		}
+	}
+
+	// Decimal number
+	uint32_t newIndex = scan_integer(s, index + 1);
+	if (newIndex < s.length() && s[newIndex] == '.') {
+		type = Number_Type::DECIMAL;
+		return scan_decimal(s, newIndex + 1);
+	}
+	type = Number_Type::INTEGER;
+	return newIndex;
+}
+
+
+/**************************************************************************
+*
+*	Test
+*
+*************************************************************************/
+
+// Builds a line of 1 to 40 characters that numbers are made of, with letters
+// and bytes that end them. Short lines cover the partial word loads.
+static std::string number_line(std::mt19937& random) {
+	static constexpr char characters[] = "0000111123456789__abcdefABCDEFxbeE+-. \xC3\xA9g";
+	std::string line(1 + random() % 40, ' ');
+	for (char& c : line) {
+		c = characters[random() % (sizeof(characters) - 1)];
+	}
+	return line;
+}
+
+
+// Scans the digit runs of every class from every index of random lines, and
+// a number from every digit, with both scanners. The runs must end at the
+// same index, and the numbers must have the same lexeme end and type.
+int main() {
+	static constexpr Digit_Span spans[] = { Digit_Span::BINARY, Digit_Span::DECIMAL, Digit_Span::HEX };
+	static constexpr bool (*digit_classes[])(char) = { is_binary_number, is_decimal_number, is_hex_number };
+	std::mt19937 random{ 15 };
+	Test_Pools pools{};
+	size_t runs = 0;
+	size_t numbers = 0;
+	for (uint32_t n = 0; n < 100'000 && failures < 10; ++n) {
+		const std::string line = number_line(random);
+		for (uint32_t i = 0; i < line.length(); ++i) {
+			// Digit runs, as the automaton skips them
+			for (size_t c = 0; c < std::size(spans); ++c) {
+				uint32_t expected = scan_run(line, i, digit_classes[c]);
+				uint32_t end = scan_digit_span(line, i, spans[c]);
+				check(end == expected, "\"" + line + "\" run " + std::to_string(c) + " at " + std::to_string(i)
+					+ ": ends at " + std::to_string(end) + ", expected " + std::to_string(expected));
+				++runs;
+			}
+			if (!is_decimal_number(line[i])) {
+				continue;
+			}
+
+			// Whole numbers through the scanner
+			Number_Type expectedType = Number_Type::INTEGER;
+			uint32_t expectedEnd = scan_number(line, i, expectedType);
+			Line_State state = Line_State::NORMAL;
+			Open_Literal literal{};
+			Lexeme lex{};
+			Token tok{};
+			uint32_t index = i;
+			bool token = scan_lexeme(line, index, state, literal, lex, tok, pools.symbols, pools.constants,
+				pools.strings);
+			Constant value = token ? pools.constants.get(tok.subtype.constant) : Constant{};
+			check(token && tok.type == Token_Type::NUMBER && lex.end == expectedEnd && value.type == expectedType,
+				"\"" + line + "\" at " + std::to_string(i) + ": ends at " + std::to_string(lex.end) + ", expected "
+				+ std::to_string(expectedEnd));
+			++numbers;
+		}
+	}
+
+	std::cout << "Number scan: " << runs << " digit runs and " << numbers << " numbers compared, " << failures
+		<< " failed\n";
+	return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+
+/******************************************************************************
+
+This software is provided under two licenses. Choose whichever you prefer.
+
+
+============================= Apache License V2.0 =============================
+
+Copyright 2020 Matthew Roever
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+	http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+
+================================= MIT License =================================
+
+Copyright (c) 2020 Matthew Roever
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+******************************************************************************/
\ No newline at end of file
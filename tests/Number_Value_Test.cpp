@@ -0,0 +1,210 @@
+// File:		Number_Value_Test.cpp
+// Language:	C++17
+// Purpose:		Checks the values numeric literals decode to against the C library.
+// License:		At bottom of document.
+
+// STL
+#include <cerrno>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <string>
+#include <string_view>
+#include <utility>
+
+// Internal
+#include "Test.h"
+
+
+// Builds a run of 1 to maxDigits digits taken from digits, with _ separators
+// between some of them and rarely one at the end, as the number rules allow.
+static std::string digit_run(std::mt19937& random, const char* digits, uint32_t maxDigits) {
+	const size_t count = std::strlen(digits);
+	std::string run{};
+	for (uint32_t n = 1 + random() % maxDigits; n > 0; --n) {
+		run += digits[random() % count];
+		if (n > 1 && random() % 6 == 0) {
+			run += '_';
+		}
+	}
+	if (random() % 20 == 0) {
+		run += '_';
+	}
+	return run;
+}
+
+
+// Builds a random literal of a type. Runs are long enough to overflow often,
+// and exponents reach past the range of a double both ways.
+static std::string random_literal(std::mt19937& random, Number_Type type) {
+	switch (type) {
+	case Number_Type::BINARY:
+		return "0b" + digit_run(random, (random() % 4 == 0) ? "0" : "01", 72);
+	case Number_Type::HEX:
+		return "0x" + digit_run(random, (random() % 4 == 0) ? "0" : "0123456789abcdefABCDEF", 20);
+	case Number_Type::INTEGER:
+		return digit_run(random, "0123456789", (random() % 2) ? 21 : 8);
+	case Number_Type::DECIMAL:
+	default: {
+		std::string text = digit_run(random, "0123456789", 20) + ".";
+		if (random() % 4 != 0) {
+			text += digit_run(random, "0123456789", 24);
+		}
+		if (random() % 2) {
+			text += (random() % 2) ? 'e' : 'E';
+			switch (random() % 3) {
+			case 0: text += '+'; break;
+			case 1: text += '-'; break;
+			default: break;
+			}
+			text += digit_run(random, "0123456789", 3);
+		}
+		return text;
+	}
+	}
+}
+
+
+// Decodes a literal with strtoull or strtod, the reference for decode_number.
+// Integers that do not fit are UINT64_MAX and decimals infinity, both marked
+// as overflow.
+static Constant reference_value(std::string_view text, Number_Type type) {
+	Constant c{};
+	c.type = type;
+	if (type == Number_Type::BINARY || type == Number_Type::HEX) {
+		text.remove_prefix(2);
+	}
+	std::string digits{};
+	for (char ch : text) {
+		if (ch != '_') {
+			digits += ch;
+		}
+	}
+	errno = 0;
+	switch (type) {
+	case Number_Type::BINARY:
+	case Number_Type::HEX:
+	case Number_Type::INTEGER: {
+		const int base = (type == Number_Type::BINARY) ? 2 : (type == Number_Type::HEX) ? 16 : 10;
+		c.integer = std::strtoull(digits.c_str(), nullptr, base);
+		c.overflow = (errno == ERANGE);
+		break;
+	}
+	case Number_Type::DECIMAL:
+		c.decimal = std::strtod(digits.c_str(), nullptr);
+		c.overflow = std::isinf(c.decimal);
+		break;
+	}
+	return c;
+}
+
+
+// Decodes a literal with decode_number and the reference. The values must be
+// the same to the bit, and both must agree on overflow.
+static void check_literal(const std::string& text, Number_Type type) {
+	const Constant value = decode_number(text, type);
+	const Constant expected = reference_value(text, type);
+	const bool same = value.type == expected.type && value.overflow == expected.overflow
+		&& value.integer == expected.integer && std::memcmp(&value.decimal, &expected.decimal, sizeof(double)) == 0;
+	check(same, "\"" + text + "\": " + std::to_string(value.integer) + " / " + std::to_string(value.decimal)
+		+ (value.overflow ? " overflow" : "") + ", expected " + std::to_string(expected.integer) + " / "
+		+ std::to_string(expected.decimal) + (expected.overflow ? " overflow" : ""));
+}
+
+
+// Checks the limits of each type, then random literals of every type with
+// separators, leading zeros and values past the limits.
+int main() {
+	static constexpr Number_Type types[] = { Number_Type::BINARY, Number_Type::DECIMAL, Number_Type::HEX,
+		Number_Type::INTEGER };
+	const std::string ones(64, '1');
+	const std::string zeros(70, '0');
+	const std::pair<std::string, Number_Type> limits[] = {
+		{ "0", Number_Type::INTEGER },
+		{ "18446744073709551615", Number_Type::INTEGER },
+		{ "18446744073709551616", Number_Type::INTEGER },
+		{ "18_446_744_073_709_551_615", Number_Type::INTEGER },
+		{ "1844_67440737_09551615", Number_Type::INTEGER },
+		{ "1844_67440737_09551616", Number_Type::INTEGER },
+		{ "000000000000000000000018446744073709551615", Number_Type::INTEGER },
+		{ "99999999999999999999", Number_Type::INTEGER },
+		{ "0xFFFF_FFFF_FFFF_FFFF", Number_Type::HEX },
+		{ "0x1_0000_0000_0000_0000", Number_Type::HEX },
+		{ "0x0000000000000000000001", Number_Type::HEX },
+		{ "0b" + ones, Number_Type::BINARY },
+		{ "0b1" + ones, Number_Type::BINARY },
+		{ "0b" + zeros + "1", Number_Type::BINARY },
+		{ "0b1_" + ones.substr(1), Number_Type::BINARY },
+		{ "1.7976931348623157e308", Number_Type::DECIMAL },
+		{ "1.8e308", Number_Type::DECIMAL },
+		{ "4.9e-324", Number_Type::DECIMAL },
+		{ "1.0e-400", Number_Type::DECIMAL },
+		{ "0.", Number_Type::DECIMAL },
+		{ "1_000.000_1e1_0", Number_Type::DECIMAL }
+	};
+	size_t literals = 0;
+	for (const auto& limit : limits) {
+		check_literal(limit.first, limit.second);
+		++literals;
+	}
+
+	std::mt19937 random{ 13 };
+	for (uint32_t n = 0; n < 500'000 && failures < 10; ++n) {
+		for (Number_Type type : types) {
+			check_literal(random_literal(random, type), type);
+			++literals;
+		}
+	}
+
+	std::cout << "Number values: " << literals << " literals compared, " << failures << " failed\n";
+	return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+
+/******************************************************************************
+
+This software is provided under two licenses. Choose whichever you prefer.
+
+
+============================= Apache License V2.0 =============================
+
+Copyright 2020 Matthew Roever
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+	http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+
+================================= MIT License =================================
+
+Copyright (c) 2020 Matthew Roever
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+******************************************************************************/
\ No newline at end of file
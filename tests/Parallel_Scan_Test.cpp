@@ -0,0 +1,104 @@
+// File:		Parallel_Scan_Test.cpp
+// Language:	C++17
+// Purpose:		Checks that a parallel scan gives the same results as a serial scan.
+// License:		At bottom of document.
+
+// STL
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+// Internal
+#include "Test.h"
+
+
+// Scans random sources serially, then in parallel with the smallest chunk
+// lowered so even short sources are split into one chunk per thread. Chunks
+// then start inside comments, strings and open statements, and every
+// parallel scan must match the serial scan.
+int main() {
+	static constexpr uint32_t threadCounts[] = { 2, 3, 4, 8 };
+	static constexpr uint32_t chunkBytes[] = { 1, 7, 64, 512, Scanner::DEFAULT_MIN_CHUNK_BYTES };
+	std::vector<std::unique_ptr<Thread_Pool>> threadPools{};
+	for (uint32_t threads : threadCounts) {
+		threadPools.push_back(std::make_unique<Thread_Pool>(threads));
+	}
+
+	std::mt19937 random{ 7 };
+	size_t scans = 0;
+	for (uint32_t seed = 0; seed < 40 && failures == 0; ++seed) {
+		Source_Buffer source{};
+		source.assign(random_source(random, 1 + random() % ((seed % 2) ? 20 : 400)));
+
+		Test_Pools serialPools{};
+		Scanner_Results serial{};
+		Scanner(serialPools.symbols, serialPools.constants, serialPools.strings).scan(source, serial);
+
+		for (const auto& threadPool : threadPools) {
+			for (uint32_t bytes : chunkBytes) {
+				Test_Pools parallelPools{};
+				Scanner scanner(parallelPools.symbols, parallelPools.constants, parallelPools.strings);
+				scanner.set_min_chunk_bytes(bytes);
+				Scanner_Results parallel{};
+				scanner.scan(source, parallel, threadPool.get());
+				same_results("source " + std::to_string(seed) + ", " + std::to_string(threadPool->size())
+					+ " threads, " + std::to_string(bytes) + " byte chunks", serial, serialPools, parallel,
+					parallelPools);
+				++scans;
+			}
+		}
+	}
+
+	std::cout << "Parallel scan: " << scans << " scans compared, " << failures << " failed\n";
+	return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+
+/******************************************************************************
+
+This software is provided under two licenses. Choose whichever you prefer.
+
+
+============================= Apache License V2.0 =============================
+
+Copyright 2020 Matthew Roever
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+	http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+
+================================= MIT License =================================
+
+Copyright (c) 2020 Matthew Roever
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+******************************************************************************/
\ No newline at end of file
@@ -0,0 +1,118 @@
+// File:		Rescan_Test.cpp
+// Language:	C++17
+// Purpose:		Checks that rescanning after an edit gives the same results as a fresh scan.
+// License:		At bottom of document.
+
+// STL
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+
+// Internal
+#include "Test.h"
+
+
+// Builds the text of an edit, 1 to 4 random lines. The line terminator of
+// the last replaced line is kept, so the text does not end with one.
+static std::string random_edit(std::mt19937& random) {
+	std::string text = random_line(random);
+	for (uint32_t n = random() % 4; n > 0; --n) {
+		text += '\n';
+		text += random_line(random);
+	}
+	return text;
+}
+
+
+// Makes random edits to random sources. After every edit the rescanned
+// results must match a fresh scan of the edited source.
+int main() {
+	std::mt19937 random{ 9 };
+	size_t edits = 0;
+	for (uint32_t seed = 0; seed < 40 && failures == 0; ++seed) {
+		Source_Buffer source{};
+		source.assign(random_source(random, 1 + random() % 200));
+		Test_Pools pools{};
+		Scanner scanner(pools.symbols, pools.constants, pools.strings);
+		// Random sources often have more problems than are kept, half of them
+		// keep every problem so the problems are updated instead of reported
+		// again in full
+		const size_t limit = (seed % 2) ? SIZE_MAX : Diagnostics::DEFAULT_LIMIT;
+		Scanner_Results results{};
+		results.diagnostics = Diagnostics(limit);
+		scanner.scan(source, results);
+
+		for (uint32_t e = 0; e < 50 && failures == 0; ++e) {
+			// Literals may view the old text
+			std::string_view old = source.text();
+			pools.strings.detach(old.data(), old.data() + old.length());
+
+			const size_t lines = source.line_count();
+			const size_t first = random() % lines;
+			const size_t last = first + 1 + random() % std::min<size_t>(lines - first, 5);
+			const size_t inserted = source.replace_lines(first, last, random_edit(random));
+			scanner.rescan(source, first, last - first, inserted, results);
+
+			Test_Pools freshPools{};
+			Scanner_Results fresh{};
+			fresh.diagnostics = Diagnostics(limit);
+			Scanner(freshPools.symbols, freshPools.constants, freshPools.strings).scan(source, fresh);
+			same_results("source " + std::to_string(seed) + ", edit " + std::to_string(e) + " of lines ["
+				+ std::to_string(first) + ", " + std::to_string(last) + ")", results, pools, fresh, freshPools);
+			++edits;
+		}
+	}
+
+	std::cout << "Rescan: " << edits << " edits compared, " << failures << " failed\n";
+	return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+
+/******************************************************************************
+
+This software is provided under two licenses. Choose whichever you prefer.
+
+
+============================= Apache License V2.0 =============================
+
+Copyright 2020 Matthew Roever
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+	http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+
+================================= MIT License =================================
+
+Copyright (c) 2020 Matthew Roever
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+******************************************************************************/
\ No newline at end of file
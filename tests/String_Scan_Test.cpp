@@ -0,0 +1,155 @@
+// File:		String_Scan_Test.cpp
+// Language:	C++17
+// Purpose:		Checks where string literals end and what they decode to.
+// License:		At bottom of document.
+
+// STL
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Internal
+#include "Test.h"
+#include "Token_Stream.h"
+
+
+// Token a case must produce. Strings are checked against their decoded text.
+struct Expected_Token {
+	Token_Type type;
+	std::string text{};
+	std::string decoded{};
+};
+
+
+// Source and the tokens it must produce, EOL tokens included.
+struct String_Case {
+	std::string name{};
+	std::string source{};
+	std::vector<Expected_Token> tokens{};
+};
+
+
+// Builds the cases. A quote after an even run of backslashes ends the
+// string, after an odd run it is escaped. Long literals run the search over
+// whole SIMD blocks.
+static std::vector<String_Case> string_cases() {
+	const std::string pad(40, 'p');
+	const Token_Type S = Token_Type::STRING;
+	const Token_Type W = Token_Type::WORD;
+	const Token_Type O = Token_Type::OPERATOR;
+	const Token_Type E = Token_Type::EOL;
+	return {
+		{ "escaped backslash before the quote", R"(s = "a\\" + b)",
+			{ { W, "s" }, { O, "=" }, { S, R"("a\\")", R"(a\)" }, { O, "+" }, { W, "b" }, { E, "" } } },
+		{ "escaped backslash and escaped quote", R"("a\\\"" x)",
+			{ { S, R"("a\\\"")", R"(a\")" }, { W, "x" }, { E, "" } } },
+		{ "four backslashes in a long literal", "\"" + pad + R"(\\\\" y)",
+			{ { S, "\"" + pad + R"(\\\\")", pad + R"(\\)" }, { W, "y" }, { E, "" } } },
+		{ "escaped quote in a long literal", "\"" + pad + R"(\"" y)",
+			{ { S, "\"" + pad + R"(\"")", pad + "\"" }, { W, "y" }, { E, "" } } },
+		{ "single quotes", R"('\\' c)",
+			{ { S, R"('\\')", R"(\)" }, { W, "c" }, { E, "" } } },
+		{ "continued literal", "x = \"abc\\\ndef\" + y",
+			{ { W, "x" }, { O, "=" }, { S, "\"abc\\", "abcdef" }, { S, "def\"", "abcdef" }, { O, "+" }, { W, "y" },
+				{ E, "" } } },
+		{ "continued literal closed at the start of the line", "\"abc\\\n\" z",
+			{ { S, "\"abc\\", "abc" }, { S, "\"", "abc" }, { W, "z" }, { E, "" } } },
+		{ "escaped backslash at the end of the line", "\"abc\\\\\nz",
+			{ { S, "\"abc\\\\", R"(abc\)" }, { E, "" }, { W, "z" }, { E, "" } } }
+	};
+}
+
+
+// Scans every case with the scanner and the token stream. The scanner must
+// produce the expected tokens and the stream the same tokens as the scanner.
+int main() {
+	size_t tokens = 0;
+	for (const String_Case& c : string_cases()) {
+		Source_Buffer source{};
+		source.assign(c.source);
+		Test_Pools pools{};
+		Scanner_Results results{};
+		Scanner(pools.symbols, pools.constants, pools.strings).scan(source, results);
+
+		if (!check(results.tokens.size() == c.tokens.size(), c.name + ": token count")) {
+			continue;
+		}
+		for (size_t i = 0; i < c.tokens.size(); ++i) {
+			const Expected_Token& expected = c.tokens[i];
+			Token tok = results.tokens.get(i);
+			bool same = tok.type == expected.type && token_text(source, tok) == expected.text;
+			if (same && tok.type == Token_Type::STRING) {
+				same = pools.strings.text(tok.subtype.literal) == expected.decoded;
+			}
+			check(same, c.name + ": token " + std::to_string(i));
+			++tokens;
+		}
+
+		Test_Pools streamPools{};
+		Token_Stream stream(source, streamPools.symbols, streamPools.constants, streamPools.strings);
+		Token tok{};
+		size_t i = 0;
+		for (; stream.next(tok); ++i) {
+			if (!check(i < results.tokens.size(), c.name + ": stream token count")) {
+				break;
+			}
+			Token expected = results.tokens.get(i);
+			check(tok.offset == expected.offset && tok.length == expected.length && tok.type == expected.type
+				&& same_subtype(tok.type, tok.subtype, streamPools, expected.subtype, pools),
+				c.name + ": stream token " + std::to_string(i));
+		}
+		check(i == results.tokens.size(), c.name + ": stream token count");
+	}
+
+	std::cout << "String scan: " << tokens << " tokens compared, " << failures << " failed\n";
+	return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+
+/******************************************************************************
+
+This software is provided under two licenses. Choose whichever you prefer.
+
+
+============================= Apache License V2.0 =============================
+
+Copyright 2020 Matthew Roever
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+	http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+
+================================= MIT License =================================
+
+Copyright (c) 2020 Matthew Roever
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+******************************************************************************/
\ No newline at end of file
@@ -0,0 +1,251 @@
+// File:		Test.h
+// Language:	C++17
+// Purpose:		Checks, random source text and result comparison shared by the tests.
+// License:		At bottom of document.
+
+#ifndef TEST_H
+#define TEST_H
+
+// STL
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <string_view>
+
+// Internal
+#include "Scanner.h"
+
+
+// Number of failed checks, the exit status of a test depends on it.
+inline int failures = 0;
+
+
+// Counts and prints a failed check. Returns ok so a test can stop at the
+// first failure of a loop.
+inline bool check(bool ok, const std::string& what) {
+	if (!ok) {
+		++failures;
+		std::cout << "FAILED: " << what << "\n";
+	}
+	return ok;
+}
+
+
+// Pools a scanner adds to, one set per scan that is compared.
+struct Test_Pools {
+	Symbol_Table symbols{};
+	Constant_Pool constants{};
+	String_Pool strings{};
+};
+
+
+/**************************************************************************
+*
+*	Random source text
+*
+*************************************************************************/
+
+// Builds a line of random code out of pieces the scanner treats differently:
+// words, keywords, numbers of every base, operators, brackets, strings with
+// escapes, comments, stray characters, bytes that are not UTF-8 and line
+// continuations. Lines may open a block comment or end inside a string or
+// comment, so the scanner state is carried from line to line.
+inline std::string random_line(std::mt19937& random) {
+	static constexpr const char* pieces[] = {
+		"x", "value", "_tmp1", "na\xC3\xAFve", "if", "else", "while", "return", "int32",
+		"0", "42", "1_000", "0x1F", "0b1011", "3.25", "6.02e23", "1e-3", "99999999999999999999999",
+		"+", "-", "*", "/", "=", "==", "<=>", "<<=", "->", "::", ",", ";", ".", "&&", "|", "?",
+		"(", ")", "[", "]", "{", "}", "[[", "]]",
+		"\"text\"", "\"\"", "\"tab\\t\\x41\"", "\"quote \\\" in\"", "'c'", "'\\n'", "\"a\\\\\"",
+		"$", "@", "`", "\xFF", "\xE2\x82", "\"bad \xC0\xAF\""
+	};
+	std::string line{};
+	for (uint32_t n = random() % 10; n > 0; --n) {
+		line += pieces[random() % std::size(pieces)];
+		line += (random() % 3 == 0) ? "" : " ";
+	}
+	switch (random() % 12) {
+	case 0:
+		line += "// comment";
+		break;
+	case 1:
+		line += "// comment continued \\";
+		break;
+	case 2:
+		line += "/* open";
+		break;
+	case 3:
+		line += "close */";
+		break;
+	case 4:
+		line += "\"string continued \\";
+		break;
+	case 5:
+		line += "'string continued \\";
+		break;
+	case 6:
+		line += "\\";
+		break;
+	case 7:
+		line.clear();
+		break;
+	default:
+		break;
+	}
+	return line;
+}
+
+
+// Builds a source of random lines joined by newlines.
+inline std::string random_source(std::mt19937& random, size_t lines) {
+	std::string text{};
+	for (size_t i = 0; i < lines; ++i) {
+		text += random_line(random);
+		text += (random() % 8 == 0) ? "\r\n" : "\n";
+	}
+	return text;
+}
+
+
+/**************************************************************************
+*
+*	Result comparison
+*
+*************************************************************************/
+
+// Compares the subtypes of two tokens of a type. Words, numbers and strings
+// are compared by the pool entry they name, the pools may number them in a
+// different order.
+inline bool same_subtype(Token_Type type, Token_Subtype a, const Test_Pools& pa, Token_Subtype b,
+	const Test_Pools& pb) {
+	switch (type) {
+	case Token_Type::WORD:
+		return pa.symbols.text(a.symbol) == pb.symbols.text(b.symbol);
+	case Token_Type::NUMBER: {
+		Constant ca = pa.constants.get(a.constant);
+		Constant cb = pb.constants.get(b.constant);
+		return ca.type == cb.type && ca.overflow == cb.overflow && ca.integer == cb.integer
+			&& std::memcmp(&ca.decimal, &cb.decimal, sizeof(double)) == 0;
+	}
+	case Token_Type::STRING:
+		return pa.strings.text(a.literal) == pb.strings.text(b.literal)
+			&& pa.strings.type(a.literal) == pb.strings.type(b.literal);
+	default:
+		return a.symbol == b.symbol;
+	}
+}
+
+
+// Compares two sets of scanner results in full. Prints the first difference
+// found under name and returns false if there is one.
+inline bool same_results(const std::string& name, const Scanner_Results& a, const Test_Pools& pa,
+	const Scanner_Results& b, const Test_Pools& pb) {
+	// Lines and lexemes
+	if (!check(a.lines.size() == b.lines.size(), name + ": line count")) {
+		return false;
+	}
+	for (size_t i = 0; i < a.lines.size(); ++i) {
+		const Line& la = a.lines[i];
+		const Line& lb = b.lines[i];
+		if (!check(la.firstLexeme == lb.firstLexeme && la.lexemeCount == lb.lexemeCount && la.state == lb.state
+			&& la.openStatement == lb.openStatement, name + ": line " + std::to_string(i))) {
+			return false;
+		}
+	}
+	if (!check(a.lexemes.size() == b.lexemes.size(), name + ": lexeme count")) {
+		return false;
+	}
+	for (size_t i = 0; i < a.lexemes.size(); ++i) {
+		if (!check(a.lexemes[i].begin == b.lexemes[i].begin && a.lexemes[i].end == b.lexemes[i].end,
+			name + ": lexeme " + std::to_string(i))) {
+			return false;
+		}
+	}
+
+	// Tokens and statements
+	if (!check(a.tokens.size() == b.tokens.size(), name + ": token count")) {
+		return false;
+	}
+	for (size_t i = 0; i < a.tokens.size(); ++i) {
+		Token ta = a.tokens.get(i);
+		Token tb = b.tokens.get(i);
+		if (!check(ta.offset == tb.offset && ta.length == tb.length && ta.type == tb.type
+			&& same_subtype(ta.type, ta.subtype, pa, tb.subtype, pb), name + ": token " + std::to_string(i))) {
+			return false;
+		}
+	}
+	if (!check(a.tokens.statementEnds == b.tokens.statementEnds, name + ": statements")) {
+		return false;
+	}
+
+	// Brackets and problems
+	if (!check(a.brackets.partners == b.brackets.partners && a.brackets.unmatched == b.brackets.unmatched,
+		name + ": brackets")) {
+		return false;
+	}
+	const auto& da = a.diagnostics.entries();
+	const auto& db = b.diagnostics.entries();
+	if (!check(da.size() == db.size() && a.diagnostics.dropped() == b.diagnostics.dropped(),
+		name + ": diagnostic count")) {
+		return false;
+	}
+	for (size_t i = 0; i < da.size(); ++i) {
+		if (!check(da[i].severity == db[i].severity && da[i].offset == db[i].offset && da[i].length == db[i].length
+			&& da[i].message == db[i].message, name + ": diagnostic " + std::to_string(i))) {
+			return false;
+		}
+	}
+	return check(a.sourceLength == b.sourceLength, name + ": source length");
+}
+
+#endif
+
+
+/******************************************************************************
+
+This software is provided under two licenses. Choose whichever you prefer.
+
+
+============================= Apache License V2.0 =============================
+
+Copyright 2020 Matthew Roever
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+	http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+
+================================= MIT License =================================
+
+Copyright (c) 2020 Matthew Roever
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+******************************************************************************/
\ No newline at end of file